@@ -31,11 +31,19 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include <vector>
 
 #include "common/model/hardware_type_enum.hpp"
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/model/joint_trajectory_cmd.hpp"
 #include "common/util/i_driver_core.hpp"
 #include "common/util/i_interface_core.hpp"
+#include "common/util/loop_metrics.hpp"
+#include "common/util/loop_timer.hpp"
+#include "common/util/rt_thread_config.hpp"
+#include "common/util/triple_buffer.hpp"
 #include "can_driver/can_manager.hpp"
 #include "can_driver/StepperArrayMotorHardwareStatus.h"
+#include "niryo_robot_msgs/BusMetrics.h"
 #include "niryo_robot_msgs/BusState.h"
+#include "niryo_robot_msgs/LoopMetrics.h"
 #include "niryo_robot_msgs/CommandStatus.h"
 #include "common/model/abstract_single_motor_cmd.hpp"
 #include "common/model/stepper_motor_state.hpp"
@@ -74,7 +82,9 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
         void clearSingleCommandQueue();
         void clearConveyorCommandQueue();
 
-        void setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, int32_t> >&& cmd);
+        void setTrajectoryControllerCommands(const common::model::CanJointTrajectoryCmd &cmd);
+        uint32_t getOverwrittenTrajectoryCmdCount() const;
+        const common::model::JointStatesSnapshot& getJointStatesSnapshot();
 
         void addSyncCommandToQueue(std::unique_ptr<common::model::ISynchronizeMotorCmd>&& cmd) override;
 
@@ -119,21 +129,34 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
 
         int motorCmdReport(const common::model::JointState &jState, common::model::EHardwareType motor_type);
 
+        void _publishBusMetrics(const ros::TimerEvent &);
+        void _publishLoopMetrics(const ros::TimerEvent &);
+
     private:
+        ros::Publisher _bus_metrics_publisher;
+        ros::Timer _bus_metrics_publisher_timer;
+        ros::Duration _bus_metrics_publisher_duration{1.0};
+
+        ros::Publisher _loop_metrics_publisher;
+        ros::Timer _loop_metrics_publisher_timer;
+        ros::Duration _loop_metrics_publisher_duration{1.0};
+
+        // stages of the control loop: UPDATE is the wait for the loop mutex, WRITE the trajectory and the queued commands
+        common::util::LoopMetrics _loop_metrics{"can_control_loop"};
+
         bool _control_loop_flag{false};
         bool _debug_flag{false};
 
         std::mutex  _control_loop_mutex;
-        std::mutex  _joint_trajectory_mutex;
 
         std::thread _control_loop_thread;
 
         double _control_loop_frequency{0.0};
+        common::util::RtThreadConfig _control_loop_rt_config;
 
-        double _delta_time_write{0.0};
+        common::util::SubRate _write_rate;
 
         double _time_hw_data_last_read{0.0};
-        double _time_hw_data_last_write{0.0};
 
         double _time_check_connection_last_read{0.0};
 
@@ -141,7 +164,11 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
 
         std::unique_ptr<CanManager> _can_manager;
 
-        std::vector<std::pair<uint8_t, int32_t> > _joint_trajectory_cmd;
+        // latest setpoints written by ros_control, taken by the control loop
+        common::util::TripleBuffer<common::model::CanJointTrajectoryCmd> _joint_trajectory_cmd;
+
+        // joints states published by the control loop at the end of each read, taken by ros_control
+        common::util::TripleBuffer<common::model::JointStatesSnapshot> _joint_states_snapshot;
 
         // can cmds
         std::queue<std::unique_ptr<common::model::AbstractCanSingleMotorCmd>> _stepper_single_cmds;
@@ -171,6 +198,29 @@ CanInterfaceCore::getBusProtocol() const
     return common::model::EBusProtocol::CAN;
 }
 
+/**
+ * @brief CanInterfaceCore::getOverwrittenTrajectoryCmdCount
+ * @return number of setpoints replaced by a newer one before being sent to the motors
+ */
+inline
+uint32_t CanInterfaceCore::getOverwrittenTrajectoryCmdCount() const
+{
+    return _joint_trajectory_cmd.getOverwrittenCount();
+}
+
+/**
+ * @brief CanInterfaceCore::getJointStatesSnapshot : newest joints states published by the control loop
+ * Never blocks the control loop. Only one reader thread is allowed (ros_control),
+ * the reference stays valid until its next call
+ * @return states of all joints at the end of the same read cycle, never mixed between cycles
+ */
+inline
+const common::model::JointStatesSnapshot& CanInterfaceCore::getJointStatesSnapshot()
+{
+    _joint_states_snapshot.consume();
+    return _joint_states_snapshot.getReadBuffer();
+}
+
 /**
  * @brief CanInterfaceCore::getCalibrationResult
  * @param id
@@ -36,10 +36,14 @@
 
 // niryo
 #include "common/util/i_bus_manager.hpp"
+#include "common/util/bus_metrics.hpp"
+#include "common/util/goal_delta_filter.hpp"
 #include "common/model/stepper_motor_state.hpp"
 #include "common/model/conveyor_state.hpp"
 #include "common/model/stepper_calibration_status_enum.hpp"
 #include "common/model/abstract_single_motor_cmd.hpp"
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/model/joint_trajectory_cmd.hpp"
 
 #include "can_driver/StepperMotorCommand.h"
 #include "can_driver/StepperCmd.h"
@@ -82,12 +86,13 @@ public:
     size_t getNbMotors() const override;
     void getBusState(bool& connection_status, std::vector<uint8_t>& motor_list, std::string& error) const override;
     std::string getErrorMessage() const override;
+    niryo_robot_msgs::BusMetrics getBusMetrics();
 
     // commands
     int changeId(common::model::EHardwareType motor_type, uint8_t old_id, uint8_t new_id);
 
     int writeSingleCommand(std::unique_ptr<common::model::AbstractCanSingleMotorCmd>&& cmd);
-    void executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, int32_t> > cmd_vec);
+    void executeJointTrajectoryCmd(const common::model::CanJointTrajectoryCmd &cmd_vec);
 
     // read status
     void readStatus();
@@ -104,6 +109,7 @@ public:
 
     std::vector<std::shared_ptr<common::model::JointState> > getMotorsStates() const;
     std::shared_ptr<common::model::AbstractHardwareState> getHardwareState(uint8_t motor_id) const;
+    const common::model::JointStatesSnapshot& getJointStatesSnapshot() const;
 
     std::vector<uint8_t> getRemovedMotorList() const override;
 private:
@@ -115,6 +121,8 @@ private:
     void _verifyMotorTimeoutLoop();
     double getCurrentTimeout() const;
 
+    static common::util::EBusResult toBusResult(int can_result);
+
     // config params using in fake driver
     void readFakeConfig(bool use_simu_conveyor);
     template<typename Reg>
@@ -135,6 +143,15 @@ private:
 
     std::string _debug_error_message;
 
+    // durations and results of the transactions, read by the publisher of CanInterfaceCore
+    common::util::BusMetrics _bus_metrics{"can"};
+
+    // goals of the trajectory already written to the steppers are not written again (opt-in)
+    common::util::GoalDeltaFilter<int32_t> _goal_delta_filter;
+
+    // joints states of the last read cycle, only accessed under the control loop mutex of CanInterfaceCore
+    common::model::JointStatesSnapshot _joint_states;
+
     // for hardware control
     std::mutex  _stepper_timeout_mutex;
     std::thread _stepper_timeout_thread;
@@ -213,6 +230,17 @@ void CanManager::setCalibrationStatus(const common::model::EStepperCalibrationSt
     _calibration_status = status;
 }
 
+/**
+ * @brief CanManager::getJointStatesSnapshot : joints states of the last read cycle
+ * Not thread safe, use CanInterfaceCore::getJointStatesSnapshot from other threads
+ * @return
+ */
+inline
+const common::model::JointStatesSnapshot& CanManager::getJointStatesSnapshot() const
+{
+    return _joint_states;
+}
+
 /**
  * @brief CanManager::retrieveFakeMotorData get config for motors
  * @param current_ns
@@ -52,6 +52,9 @@ using ::common::model::HardwareTypeEnum;
 using ::common::model::JointState;
 using ::common::model::StepperSingleCmd;
 
+using ::common::util::ELoopStage;
+using ::common::util::LoopTimer;
+
 namespace can_driver
 {
 /**
@@ -109,11 +112,13 @@ void CanInterfaceCore::initParameters(ros::NodeHandle &nh)
 
     nh.getParam("can_hw_write_frequency", write_frequency);
 
+    _control_loop_rt_config.readParameters(nh, "can_control_loop_rt");
+
     ROS_DEBUG("CanInterfaceCore::initParameters - can_hardware_control_loop_frequency : %f", _control_loop_frequency);
 
     ROS_DEBUG("CanInterfaceCore::initParameters - can_hw_write_frequency : %f", write_frequency);
 
-    _delta_time_write = 1.0 / write_frequency;
+    _write_rate.setPeriod(1.0 / write_frequency);
 }
 
 /**
@@ -125,7 +130,14 @@ void CanInterfaceCore::startServices(ros::NodeHandle & /*nh*/) { ROS_DEBUG("CanI
  * @brief CanInterfaceCore::startPublishers
  * @param nh
  */
-void CanInterfaceCore::startPublishers(ros::NodeHandle & /*nh*/) { ROS_DEBUG("CanInterfaceCore::startServices - no publishers to start"); }
+void CanInterfaceCore::startPublishers(ros::NodeHandle &nh)
+{
+    _bus_metrics_publisher = nh.advertise<niryo_robot_msgs::BusMetrics>("bus_metrics", 1);
+    _bus_metrics_publisher_timer = nh.createTimer(_bus_metrics_publisher_duration, &CanInterfaceCore::_publishBusMetrics, this);
+
+    _loop_metrics_publisher = nh.advertise<niryo_robot_msgs::LoopMetrics>("loop_metrics", 1);
+    _loop_metrics_publisher_timer = nh.createTimer(_loop_metrics_publisher_duration, &CanInterfaceCore::_publishLoopMetrics, this);
+}
 
 /**
  * @brief CanInterfaceCore::startSubscribers
@@ -357,7 +369,7 @@ void CanInterfaceCore::resetHardwareControlLoopRates()
 {
     ROS_DEBUG("CanInterfaceCore::resetHardwareControlLoopRates - Reset control loop rates");
     double now = ros::Time::now().toSec();
-    _time_hw_data_last_write = now;
+    _write_rate.reset(LoopTimer::now());
     _time_hw_data_last_read = now;
 
     _time_check_connection_last_read = now;
@@ -389,38 +401,53 @@ void CanInterfaceCore::activeDebugMode(bool mode)
  */
 void CanInterfaceCore::controlLoop()
 {
-    ros::Rate control_loop_rate = ros::Rate(_control_loop_frequency);
+    std::string thread_settings = _control_loop_rt_config.apply();
+    ROS_INFO("CanInterfaceCore::controlLoop - thread settings : %s", thread_settings.c_str());
+    _loop_metrics.setThreadSettings(thread_settings);
+
+    LoopTimer control_loop_timer(1.0 / _control_loop_frequency);
     resetHardwareControlLoopRates();
+    _loop_metrics.setExpectedPeriod(control_loop_timer.getPeriod());
     while (ros::ok())
     {
         // Do not readStatus if connection is down or not be established yet
         if (!_can_manager->isConnectionOk())
         {
+            _loop_metrics.pause();
             _can_manager->scanAndCheck();
-            control_loop_rate.sleep();
+            control_loop_timer.sleep();
         }
         else if (_control_loop_flag)
         {
+            _loop_metrics.startCycle();
             {
                 lock_guard<mutex> lck(_control_loop_mutex);
+                _loop_metrics.endStage(ELoopStage::UPDATE);
+
                 _can_manager->readStatus();
+                _joint_states_snapshot.getWriteBuffer() = _can_manager->getJointStatesSnapshot();
+                _joint_states_snapshot.publish();
+                _loop_metrics.endStage(ELoopStage::READ);
 
-                if (ros::Time::now().toSec() - _time_hw_data_last_write >= _delta_time_write)
-                {
-                    _time_hw_data_last_write = ros::Time::now().toSec();
+                // the write rate is phase-locked on the deadlines of the loop
+                if (_write_rate.isDue(control_loop_timer.getCycleTime()))
                     _executeCommand();
-                }
+                _loop_metrics.endStage(ELoopStage::WRITE);
             }
+            _loop_metrics.endCycle();
 
-            bool isFreqMet = control_loop_rate.sleep();
+            bool isFreqMet = control_loop_timer.sleep();
             if (!isFreqMet)
-                ROS_DEBUG_THROTTLE(2, "CanInterfaceCore::rosControlLoop : freq not met : expected (%f s) vs actual (%f s)", control_loop_rate.expectedCycleTime().toSec(),
-                                   control_loop_rate.cycleTime().toSec());
+                ROS_DEBUG_THROTTLE(2, "CanInterfaceCore::rosControlLoop : freq not met : expected (%f s), woke up %f s late, %lu deadlines skipped",
+                                   control_loop_timer.getPeriod(), control_loop_timer.getWakeUpTime() - control_loop_timer.getCycleTime(),
+                                   static_cast<unsigned long>(control_loop_timer.getMissedCount()));
         }
         else
         {
+            _loop_metrics.pause();
             ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
             resetHardwareControlLoopRates();
+            control_loop_timer.reset();
         }
     }
 }
@@ -430,11 +457,8 @@ void CanInterfaceCore::controlLoop()
  */
 void CanInterfaceCore::_executeCommand()
 {
-    if (!_joint_trajectory_cmd.empty())
-    {
-        _can_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd);
-        _joint_trajectory_cmd.clear();
-    }
+    if (_joint_trajectory_cmd.consume() && !_joint_trajectory_cmd.getReadBuffer().empty())
+        _can_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd.getReadBuffer());
 
     if (!_stepper_single_cmds.empty())
     {
@@ -557,7 +581,11 @@ void CanInterfaceCore::clearConveyorCommandQueue()
  * @brief CanInterfaceCore::setTrajectoryControllerCommands
  * @param cmd
  */
-void CanInterfaceCore::setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, int32_t>> &&cmd) { _joint_trajectory_cmd = cmd; }  // NOLINT
+void CanInterfaceCore::setTrajectoryControllerCommands(const common::model::CanJointTrajectoryCmd &cmd)
+{
+    _joint_trajectory_cmd.getWriteBuffer() = cmd;
+    _joint_trajectory_cmd.publish();
+}
 
 /**
  * @brief CanInterfaceCore::addSingleCommandToQueue
@@ -667,4 +695,27 @@ std::shared_ptr<common::model::JointState> CanInterfaceCore::getJointState(uint8
  */
 std::vector<uint8_t> CanInterfaceCore::getRemovedMotorList() const { return _can_manager->getRemovedMotorList(); }
 
+/**
+ * @brief CanInterfaceCore::_publishBusMetrics : latencies and results of the bus transactions, busy fraction of the bus,
+ * setpoints overwritten before being written
+ */
+void CanInterfaceCore::_publishBusMetrics(const ros::TimerEvent &)
+{
+    // BusMetrics has its own lock, the control loop is not blocked
+    niryo_robot_msgs::BusMetrics msg = _can_manager->getBusMetrics();
+    msg.overwritten_trajectory_cmd_count = getOverwrittenTrajectoryCmdCount();
+    msg.header.stamp = ros::Time::now();
+    _bus_metrics_publisher.publish(msg);
+}
+
+/**
+ * @brief CanInterfaceCore::_publishLoopMetrics : period, execution time and wake-up latency of the control loop
+ */
+void CanInterfaceCore::_publishLoopMetrics(const ros::TimerEvent &)
+{
+    niryo_robot_msgs::LoopMetrics msg = _loop_metrics.getMsg();
+    msg.header.stamp = ros::Time::now();
+    _loop_metrics_publisher.publish(msg);
+}
+
 }  // namespace can_driver
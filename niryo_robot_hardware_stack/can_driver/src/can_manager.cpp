@@ -24,6 +24,7 @@
 #include "common/model/conveyor_state.hpp"
 #include "common/model/hardware_type_enum.hpp"
 #include "common/model/stepper_command_type_enum.hpp"
+#include "common/util/loop_timer.hpp"
 #include "niryo_robot_msgs/CommandStatus.h"
 
 // c++
@@ -43,6 +44,11 @@ using ::common::model::EStepperCalibrationStatus;
 using ::common::model::JointState;
 using ::common::model::StepperMotorState;
 
+using ::common::util::BusMetrics;
+using ::common::util::EBusResult;
+using ::common::util::EBusTransaction;
+using ::common::util::LoopTimer;
+
 namespace can_driver
 {
 
@@ -97,10 +103,22 @@ bool CanManager::init(ros::NodeHandle &nh)
     nh.getParam("bus_params/gpio_can_interrupt", gpio_can_interrupt);
     nh.getParam("/niryo_robot_hardware_interface/joints_interface/calibration_timeout", _calibration_timeout);
 
+    bool use_goal_delta_suppression{false};
+    int goal_delta_deadband{0};
+    double goal_delta_refresh_period{0.5};
+    nh.getParam("bus_params/goal_delta_suppression/enabled", use_goal_delta_suppression);
+    nh.getParam("bus_params/goal_delta_suppression/deadband", goal_delta_deadband);
+    nh.getParam("bus_params/goal_delta_suppression/refresh_period", goal_delta_refresh_period);
+    _goal_delta_filter.setDeadband(static_cast<uint32_t>(std::max(goal_delta_deadband, 0)));
+    _goal_delta_filter.setRefreshPeriod(goal_delta_refresh_period);
+    _goal_delta_filter.setEnabled(use_goal_delta_suppression);
+
     ROS_DEBUG("CanManager::init - Can bus parameters: spi_channel : %d", spi_channel);
     ROS_DEBUG("CanManager::init - Can bus parameters: spi_baudrate : %d", spi_baudrate);
     ROS_DEBUG("CanManager::CanManager - Can bus parameters: gpio_can_interrupt : %d", gpio_can_interrupt);
     ROS_DEBUG("CanManager::init - Calibration timeout %f", _calibration_timeout);
+    ROS_DEBUG("CanManager::init - goal delta suppression: %s, deadband %d steps, refresh period %f s", use_goal_delta_suppression ? "True" : "False",
+              goal_delta_deadband, goal_delta_refresh_period);
 
     if (!_simulation_mode)
         _mcp_can = std::make_shared<mcp_can_rpi::MCP_CAN>(spi_channel, spi_baudrate, static_cast<uint8_t>(gpio_can_interrupt));
@@ -199,6 +217,7 @@ int CanManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
     {
         _state_map.insert(std::make_pair(id, state));
     }
+    _goal_delta_filter.invalidate(id);
 
     addHardwareDriver(hardware_type);
 
@@ -219,6 +238,8 @@ void CanManager::removeHardwareComponent(uint8_t id)
     {
         _state_map.erase(id);
     }
+    // samples are added back by the next read
+    _joint_states.clear();
 
     _removed_motor_id_list.erase(std::remove(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id), _removed_motor_id_list.end());
 }
@@ -282,7 +303,17 @@ void CanManager::readStatus()
             std::array<uint8_t, AbstractCanDriver::MAX_MESSAGE_LENGTH> rxBuf{};
             std::string error_message;
 
-            if (CAN_OK == driver->readData(motor_id, control_byte, rxBuf, error_message))
+            auto start = BusMetrics::Clock::now();
+            int read_res = driver->readData(motor_id, control_byte, rxBuf, error_message);
+
+            // no message received is not a transaction
+            if (CAN_NOMSG != read_res)
+            {
+                auto transaction = AbstractStepperDriver::CAN_DATA_POSITION == control_byte ? EBusTransaction::JOINTS_READ : EBusTransaction::HW_STATUS_READ;
+                _bus_metrics.record(transaction, it.first, toBusResult(read_res), start);
+            }
+
+            if (CAN_OK == read_res)
             {
                 if (_state_map.count(motor_id) && _state_map.at(motor_id))
                 {
@@ -294,6 +325,12 @@ void CanManager::readStatus()
                     {
                     case AbstractStepperDriver::CAN_DATA_POSITION:
                         stepperState->setPosition(driver->interpretPositionStatus(rxBuf));
+                        if (common::model::EComponentType::JOINT == stepperState->getComponentType() &&
+                            !_joint_states.update(motor_id, stepperState->getPosition(), stepperState->getVelocity(), stepperState->getTorque(),
+                                                  stepperState->getLastTimeRead()))
+                        {
+                            ROS_WARN_THROTTLE(1.0, "CanManager::readStatus - joint states snapshot full, joint %d ignored", motor_id);
+                        }
                         break;
                     case AbstractStepperDriver::CAN_DATA_DIAGNOSTICS:
                         stepperState->setTemperature(driver->interpretTemperatureStatus(rxBuf));
@@ -335,6 +372,10 @@ void CanManager::readStatus()
             }
         }
     }
+
+    // joints without new position frame keep the stamp of their last one
+    _joint_states.cycle++;
+    _joint_states.stamp = ros::Time::now().toSec();
 }
 
 /**
@@ -350,6 +391,8 @@ int CanManager::scanAndCheck()
 
     _all_motor_connected.clear();
     _is_connection_ok = false;
+    // the motors may have been restarted, their goals are unknown
+    _goal_delta_filter.reset();
 
     EHardwareType type;
     if (_driver_map.count(EHardwareType::STEPPER))
@@ -558,6 +601,7 @@ int CanManager::writeSingleCommand(std::unique_ptr<common::model::AbstractCanSin
     ROS_DEBUG("CanManager::readCommand - Received stepper cmd %s", cmd->str().c_str());
 
     uint8_t id = cmd->getId();
+    _goal_delta_filter.invalidate(id);
 
     if (cmd->isValid())
     {
@@ -569,7 +613,9 @@ int CanManager::writeSingleCommand(std::unique_ptr<common::model::AbstractCanSin
             result = CAN_FAIL;
             if (_driver_map.count(hardware_type) && _driver_map.at(hardware_type))
             {
+                auto start = BusMetrics::Clock::now();
                 result = _driver_map.at(hardware_type)->writeSingleCmd(cmd);
+                _bus_metrics.record(EBusTransaction::SINGLE_WRITE, hardware_type, toBusResult(result), start);
             }
 
             ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
@@ -587,19 +633,30 @@ int CanManager::writeSingleCommand(std::unique_ptr<common::model::AbstractCanSin
 
 /**
  * @brief CanManager::executeJointTrajectoryCmd
- * @param cmd_vec : need to be passed by copy, so that we ensure the data will not change in this method
+ * @param cmd_vec : read buffer of the trajectory command, only modified by the control loop thread
  */
-void CanManager::executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, int32_t>> cmd_vec)
+void CanManager::executeJointTrajectoryCmd(const common::model::CanJointTrajectoryCmd &cmd_vec)
 {
+    // only the goals not yet written to the steppers, all of them if the suppression is disabled
+    const common::model::CanJointTrajectoryCmd &goals = _goal_delta_filter.filter(cmd_vec, LoopTimer::now());
+
     for (auto const &it : _driver_map)
     {
         auto driver = std::dynamic_pointer_cast<AbstractStepperDriver>(it.second);
 
-        for (auto const &cmd : cmd_vec)
+        for (auto const &cmd : goals)
         {
             if (_state_map.count(cmd.first) && it.first == _state_map.at(cmd.first)->getHardwareType())
             {
+                auto start = BusMetrics::Clock::now();
                 int err = driver->sendPositionCommand(cmd.first, cmd.second);
+                _bus_metrics.record(EBusTransaction::GOAL_WRITE, it.first, toBusResult(err), start);
+
+                if (CAN_OK == err)
+                    _goal_delta_filter.setTransmitted(cmd.first, cmd.second);
+                else
+                    _goal_delta_filter.invalidate(cmd.first);
+
                 if (err != CAN_OK)
                 {
                     ROS_WARN("CanManager::executeJointTrajectoryCmd - Failed to write position");
@@ -703,6 +760,40 @@ void CanManager::getBusState(bool &connection_status, std::vector<uint8_t> &moto
     connection_status = isConnectionOk();
 }
 
+/**
+ * @brief CanManager::getBusMetrics
+ * @return durations and results of the transactions, busy fraction of the bus since the previous call,
+ * goals not written because unchanged
+ */
+niryo_robot_msgs::BusMetrics CanManager::getBusMetrics()
+{
+    niryo_robot_msgs::BusMetrics msg = _bus_metrics.getMsg();
+    msg.suppressed_goal_count = _goal_delta_filter.getSuppressedCount();
+    return msg;
+}
+
+/**
+ * @brief CanManager::toBusResult
+ * @param can_result : CAN_* result of the mcp_can driver
+ * @return
+ */
+common::util::EBusResult CanManager::toBusResult(int can_result)
+{
+    switch (can_result)
+    {
+        case CAN_OK:
+            return EBusResult::SUCCESS;
+        case CAN_GETTXBFTIMEOUT:
+        case CAN_SENDMSGTIMEOUT:
+            return EBusResult::TIMEOUT;
+        // error frames, CRC errors included, seen by the controller
+        case CAN_CTRLERROR:
+            return EBusResult::CORRUPT;
+        default:
+            return EBusResult::FAILURE;
+    }
+}
+
 /**
  * @brief CanManager::getMotorsStates
  * @return only the joints states
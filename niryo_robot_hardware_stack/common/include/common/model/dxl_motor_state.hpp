@@ -56,6 +56,8 @@ class DxlMotorState : public JointState
         int to_motor_vel(double rad_vel) override;
         double to_rad_vel(int motor_vel) override;
 
+        double to_effort(int motor_load) override;
+
         uint32_t getPositionPGain() const;
         uint32_t getPositionIGain() const;
         uint32_t getPositionDGain() const;
@@ -102,6 +104,8 @@ protected:
         int _total_range_position{0};
         double _total_angle{0.0};
         double _steps_for_one_speed{0.0};
+        // torque (N.m) for one unit of the present load (or present current) register
+        double _effort_for_one_load{0.0};
 
 private:
         void updateMultiplierRatio();
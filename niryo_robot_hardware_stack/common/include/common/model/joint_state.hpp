@@ -69,6 +69,8 @@ public:
     virtual int to_motor_vel(double rad_vel) = 0;
     virtual double to_rad_vel(int motor_vel) = 0;
 
+    virtual double to_effort(int motor_load) = 0;
+
     // AbstractMotorState interface
     void reset() override;
     bool isValid() const override;
@@ -0,0 +1,129 @@
+/*
+    joint_states_snapshot.hpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef JOINT_STATES_SNAPSHOT_H
+#define JOINT_STATES_SNAPSHOT_H
+
+#include <cstdint>
+
+#include "common/util/fixed_vector.hpp"
+
+namespace common
+{
+namespace model
+{
+
+// max number of joints of a bus in a snapshot
+constexpr size_t MAX_JOINT_STATES_SNAPSHOT_SIZE = 16;
+
+/**
+ * @brief JointStateSample : raw state of one joint, as read on the bus (motor units)
+ */
+struct JointStateSample
+{
+    uint8_t id{0};
+    int position{0};
+    int velocity{0};
+    int load{0};
+    // time of the last successful read of this joint (s), -1 if never read
+    double stamp{-1.0};
+};
+
+/**
+ * @brief JointStatesSnapshot : state of all the joints of a bus at the end of a read cycle
+ * Fixed size to be handed over from the bus threads to ros_control without allocation
+ */
+struct JointStatesSnapshot
+{
+    // number of read cycles completed by the bus thread
+    uint64_t cycle{0};
+    // end of the read cycle (s)
+    double stamp{-1.0};
+
+    common::util::FixedVector<JointStateSample, MAX_JOINT_STATES_SNAPSHOT_SIZE> samples;
+
+    const JointStateSample* find(uint8_t id) const;
+    bool update(uint8_t id, int position, int velocity, int load, double sample_stamp);
+    void clear();
+};
+
+/**
+ * @brief JointStatesSnapshot::find
+ * @param id
+ * @return nullptr if the joint is not in the snapshot
+ */
+inline
+const JointStateSample* JointStatesSnapshot::find(uint8_t id) const
+{
+    for (auto const &sample : samples)
+    {
+        if (sample.id == id)
+            return &sample;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief JointStatesSnapshot::update : update the sample of a joint, adding it if needed
+ * @param id
+ * @param position
+ * @param velocity
+ * @param load
+ * @param sample_stamp
+ * @return false if the joint is new and the snapshot is full
+ */
+inline
+bool JointStatesSnapshot::update(uint8_t id, int position, int velocity, int load, double sample_stamp)
+{
+    for (auto &sample : samples)
+    {
+        if (sample.id == id)
+        {
+            sample.position = position;
+            sample.velocity = velocity;
+            sample.load = load;
+            sample.stamp = sample_stamp;
+            return true;
+        }
+    }
+
+    JointStateSample sample;
+    sample.id = id;
+    sample.position = position;
+    sample.velocity = velocity;
+    sample.load = load;
+    sample.stamp = sample_stamp;
+
+    return samples.push_back(sample);
+}
+
+/**
+ * @brief JointStatesSnapshot::clear : forget all the joints, the cycle counter keeps going
+ */
+inline
+void JointStatesSnapshot::clear()
+{
+    samples.clear();
+}
+
+} // namespace model
+} // namespace common
+
+#endif // JOINT_STATES_SNAPSHOT_H
@@ -0,0 +1,49 @@
+/*
+    joint_trajectory_cmd.hpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef JOINT_TRAJECTORY_CMD_H
+#define JOINT_TRAJECTORY_CMD_H
+
+#include <cstdint>
+#include <utility>
+
+#include "common/util/fixed_vector.hpp"
+
+namespace common
+{
+namespace model
+{
+
+// max number of joints of a bus in a trajectory command
+constexpr size_t MAX_JOINT_TRAJECTORY_CMD_SIZE = 16;
+
+/**
+ * @brief JointTrajectoryCmd : position goal of each joint of a bus, as (motor id, motor position) pairs
+ * Fixed size to be handed over from ros_control to the bus threads without allocation
+ */
+template<typename ParamType>
+using JointTrajectoryCmd = common::util::FixedVector<std::pair<uint8_t, ParamType>, MAX_JOINT_TRAJECTORY_CMD_SIZE>;
+
+using TtlJointTrajectoryCmd = JointTrajectoryCmd<uint32_t>;
+using CanJointTrajectoryCmd = JointTrajectoryCmd<int32_t>;
+
+} // namespace model
+} // namespace common
+
+#endif // JOINT_TRAJECTORY_CMD_H
@@ -111,6 +111,8 @@ namespace common
             int to_motor_vel(double rad_vel) override;
             double to_rad_vel(int motor_vel) override;
 
+            double to_effort(int motor_load) override;
+
             void updateMultiplierRatio();
 
         protected:
@@ -0,0 +1,227 @@
+/*
+bus_metrics.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef BUS_METRICS_HPP
+#define BUS_METRICS_HPP
+
+// std
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "niryo_robot_msgs/BusMetrics.h"
+
+#include "common/model/hardware_type_enum.hpp"
+#include "common/util/latency_histogram.hpp"
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The EBusTransaction enum : kinds of transactions done by the bus managers
+ */
+enum class EBusTransaction
+{
+    JOINTS_READ,
+    HW_STATUS_READ,
+    END_EFFECTOR_READ,
+    GOAL_WRITE,
+    SINGLE_READ,
+    SINGLE_WRITE
+};
+
+/**
+ * @brief The EBusResult enum
+ */
+enum class EBusResult
+{
+    SUCCESS,
+    TIMEOUT,
+    CORRUPT,
+    FAILURE,
+    NB_RESULTS
+};
+
+/**
+ * @brief The BusMetrics class counts the transactions of a bus and their durations,
+ * per kind of transaction and per type of hardware.
+ * Transactions addressing several types of hardware at once are counted with EHardwareType::UNKNOWN.
+ * Counts and durations are cumulated since the start, the busy fraction is computed between two calls to getMsg.
+ * Thread safe : filled by the control loop, read by the publisher.
+ */
+class BusMetrics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit BusMetrics(std::string bus_name);
+
+    void record(EBusTransaction transaction, common::model::EHardwareType hardware_type,
+                EBusResult result, Clock::time_point start);
+
+    niryo_robot_msgs::BusMetrics getMsg();
+    void reset();
+
+    static std::string transactionName(EBusTransaction transaction);
+
+private:
+    struct TransactionMetrics
+    {
+        LatencyHistogram durations;
+        std::array<uint32_t, static_cast<size_t>(EBusResult::NB_RESULTS)> results{};
+    };
+
+    using Key = std::pair<EBusTransaction, common::model::EHardwareType>;
+
+    std::mutex _mutex;
+    std::string _bus_name;
+    std::map<Key, TransactionMetrics> _metrics;
+
+    Clock::duration _busy_time{Clock::duration::zero()};
+    Clock::time_point _window_start{Clock::now()};
+};
+
+/**
+ * @brief BusMetrics::BusMetrics
+ * @param bus_name
+ */
+inline
+BusMetrics::BusMetrics(std::string bus_name) :
+    _bus_name(std::move(bus_name))
+{
+}
+
+/**
+ * @brief BusMetrics::record
+ * @param transaction
+ * @param hardware_type
+ * @param result
+ * @param start : time point taken just before the transaction, the transaction ends now
+ */
+inline
+void BusMetrics::record(EBusTransaction transaction, common::model::EHardwareType hardware_type,
+                        EBusResult result, Clock::time_point start)
+{
+    Clock::duration duration = Clock::now() - start;
+
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    TransactionMetrics &metrics = _metrics[Key(transaction, hardware_type)];
+    metrics.durations.add(std::chrono::duration<double>(duration).count());
+    metrics.results.at(static_cast<size_t>(result))++;
+
+    _busy_time += duration;
+}
+
+/**
+ * @brief BusMetrics::getMsg
+ * @return metrics of all the transactions recorded, the busy fraction since the previous call
+ */
+inline
+niryo_robot_msgs::BusMetrics BusMetrics::getMsg()
+{
+    niryo_robot_msgs::BusMetrics msg;
+    msg.bus = _bus_name;
+
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    Clock::time_point now = Clock::now();
+    double window = std::chrono::duration<double>(now - _window_start).count();
+    if (window > 0.0)
+        msg.busy_fraction = std::chrono::duration<double>(_busy_time).count() / window;
+
+    _busy_time = Clock::duration::zero();
+    _window_start = now;
+
+    for (auto const& it : _metrics)
+    {
+        const TransactionMetrics &metrics = it.second;
+
+        niryo_robot_msgs::TransactionMetrics transaction_msg;
+        transaction_msg.transaction = transactionName(it.first.first);
+        transaction_msg.hardware_type = common::model::HardwareTypeEnum(it.first.second).toString();
+
+        auto count = [&metrics](EBusResult result) { return metrics.results.at(static_cast<size_t>(result)); };
+        transaction_msg.success_count = count(EBusResult::SUCCESS);
+        transaction_msg.timeout_count = count(EBusResult::TIMEOUT);
+        transaction_msg.corrupt_count = count(EBusResult::CORRUPT);
+        transaction_msg.error_count = count(EBusResult::FAILURE);
+
+        transaction_msg.mean_duration = metrics.durations.getMean();
+        transaction_msg.p50_duration = metrics.durations.getPercentile(0.5);
+        transaction_msg.p99_duration = metrics.durations.getPercentile(0.99);
+        transaction_msg.max_duration = metrics.durations.getMax();
+        transaction_msg.duration_histogram.assign(metrics.durations.getBuckets().begin(),
+                                                  metrics.durations.getBuckets().end());
+
+        msg.transactions.emplace_back(transaction_msg);
+    }
+
+    return msg;
+}
+
+/**
+ * @brief BusMetrics::reset
+ */
+inline
+void BusMetrics::reset()
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    _metrics.clear();
+    _busy_time = Clock::duration::zero();
+    _window_start = Clock::now();
+}
+
+/**
+ * @brief BusMetrics::transactionName
+ * @param transaction
+ * @return
+ */
+inline
+std::string BusMetrics::transactionName(EBusTransaction transaction)
+{
+    switch (transaction)
+    {
+        case EBusTransaction::JOINTS_READ:
+            return "joints_read";
+        case EBusTransaction::HW_STATUS_READ:
+            return "hw_status_read";
+        case EBusTransaction::END_EFFECTOR_READ:
+            return "end_effector_read";
+        case EBusTransaction::GOAL_WRITE:
+            return "goal_write";
+        case EBusTransaction::SINGLE_READ:
+            return "single_read";
+        case EBusTransaction::SINGLE_WRITE:
+            return "single_write";
+    }
+
+    return "unknown";
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // BUS_METRICS_HPP
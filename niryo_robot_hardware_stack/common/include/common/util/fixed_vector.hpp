@@ -0,0 +1,173 @@
+/*
+fixed_vector.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef FIXED_VECTOR_HPP
+#define FIXED_VECTOR_HPP
+
+// std
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The FixedVector class is a vector with a fixed capacity, its elements are stored inline (never allocates)
+ */
+template<typename T, size_t Capacity>
+class FixedVector
+{
+public:
+    using iterator = typename std::array<T, Capacity>::iterator;
+    using const_iterator = typename std::array<T, Capacity>::const_iterator;
+
+    bool push_back(const T& value);
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    static constexpr size_t capacity();
+
+    const T& at(size_t index) const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    std::array<T, Capacity> _data{};
+    size_t _size{0};
+};
+
+/**
+ * @brief FixedVector<T, Capacity>::push_back
+ * @param value
+ * @return false if the vector is full
+ */
+template<typename T, size_t Capacity>
+bool FixedVector<T, Capacity>::push_back(const T& value)
+{
+    if (_size >= Capacity)
+        return false;
+
+    _data[_size++] = value;
+    return true;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::clear
+ */
+template<typename T, size_t Capacity>
+void FixedVector<T, Capacity>::clear()
+{
+    _size = 0;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::size
+ * @return
+ */
+template<typename T, size_t Capacity>
+size_t FixedVector<T, Capacity>::size() const
+{
+    return _size;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::empty
+ * @return
+ */
+template<typename T, size_t Capacity>
+bool FixedVector<T, Capacity>::empty() const
+{
+    return 0 == _size;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::capacity
+ * @return
+ */
+template<typename T, size_t Capacity>
+constexpr size_t FixedVector<T, Capacity>::capacity()
+{
+    return Capacity;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::at
+ * @param index
+ * @return
+ */
+template<typename T, size_t Capacity>
+const T& FixedVector<T, Capacity>::at(size_t index) const
+{
+    if (index >= _size)
+        throw std::out_of_range("FixedVector::at");
+
+    return _data[index];
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::begin
+ * @return
+ */
+template<typename T, size_t Capacity>
+typename FixedVector<T, Capacity>::iterator FixedVector<T, Capacity>::begin()
+{
+    return _data.begin();
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::end
+ * @return
+ */
+template<typename T, size_t Capacity>
+typename FixedVector<T, Capacity>::iterator FixedVector<T, Capacity>::end()
+{
+    return _data.begin() + _size;
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::begin
+ * @return
+ */
+template<typename T, size_t Capacity>
+typename FixedVector<T, Capacity>::const_iterator FixedVector<T, Capacity>::begin() const
+{
+    return _data.begin();
+}
+
+/**
+ * @brief FixedVector<T, Capacity>::end
+ * @return
+ */
+template<typename T, size_t Capacity>
+typename FixedVector<T, Capacity>::const_iterator FixedVector<T, Capacity>::end() const
+{
+    return _data.begin() + _size;
+}
+
+} // util
+} // common
+
+#endif // FIXED_VECTOR_HPP
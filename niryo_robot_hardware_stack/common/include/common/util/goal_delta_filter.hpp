@@ -0,0 +1,200 @@
+/*
+goal_delta_filter.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef GOAL_DELTA_FILTER_HPP
+#define GOAL_DELTA_FILTER_HPP
+
+// std
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#include "common/model/joint_trajectory_cmd.hpp"
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The GoalDeltaFilter class removes from a trajectory command the goals already written to their motor
+ * It keeps the last goal transmitted successfully to each motor. Goal writes are TxOnly (no status packet), a successful
+ * transmission does not prove the motor applied the goal : the refresh period bounds how long a lost goal stays unwritten.
+ * A goal is written again only if it moved by more than the deadband (in motor ticks), or if the motor has no transmitted goal.
+ * Disabled, every goal is written. Not thread safe : used under the control loop mutex of the interface core, without allocation.
+ * Only getSuppressedCount can be called from another thread.
+ */
+template<typename ParamType>
+class GoalDeltaFilter
+{
+public:
+    using Cmd = common::model::JointTrajectoryCmd<ParamType>;
+
+    GoalDeltaFilter() = default;
+
+    void setEnabled(bool enabled);
+    void setDeadband(uint32_t deadband);
+    void setRefreshPeriod(double refresh_period);
+    bool isEnabled() const;
+
+    const Cmd& filter(const Cmd &cmd, double now);
+    void setTransmitted(uint8_t id, ParamType goal);
+    void invalidate(uint8_t id);
+    void reset();
+
+    uint64_t getSuppressedCount() const;
+
+private:
+    struct Goal
+    {
+        ParamType value{};
+        bool transmitted{false};
+    };
+
+    bool _enabled{false};
+    uint32_t _deadband{0};
+    double _refresh_period{0.0};
+    double _next_refresh{0.0};
+
+    // indexed by motor id
+    std::array<Goal, 256> _goals{};
+    Cmd _filtered_cmd;
+    std::atomic<uint64_t> _suppressed_count{0};
+};
+
+/**
+ * @brief GoalDeltaFilter::setEnabled
+ * @param enabled
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    reset();
+}
+
+/**
+ * @brief GoalDeltaFilter::setDeadband
+ * @param deadband : largest change of a goal not written, in motor ticks. 0 only skips identical goals
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::setDeadband(uint32_t deadband)
+{
+    _deadband = deadband;
+}
+
+/**
+ * @brief GoalDeltaFilter::setRefreshPeriod
+ * @param refresh_period : in seconds, 0 never writes all the goals
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::setRefreshPeriod(double refresh_period)
+{
+    _refresh_period = refresh_period;
+}
+
+/**
+ * @brief GoalDeltaFilter::isEnabled
+ * @return
+ */
+template<typename ParamType>
+bool GoalDeltaFilter<ParamType>::isEnabled() const
+{
+    return _enabled;
+}
+
+/**
+ * @brief GoalDeltaFilter::filter
+ * @param cmd : goals of the motors
+ * @param now : in seconds, monotonic
+ * @return goals to write, valid until the next call
+ */
+template<typename ParamType>
+const typename GoalDeltaFilter<ParamType>::Cmd& GoalDeltaFilter<ParamType>::filter(const Cmd &cmd, double now)
+{
+    if (!_enabled)
+        return cmd;
+
+    // safety net : every goal is written again once per refresh period
+    bool refresh = _refresh_period > 0.0 && now >= _next_refresh;
+    if (refresh)
+        _next_refresh = now + _refresh_period;
+
+    _filtered_cmd.clear();
+    for (auto const &goal : cmd)
+    {
+        const Goal &last_goal = _goals.at(goal.first);
+        int64_t delta = static_cast<int64_t>(goal.second) - static_cast<int64_t>(last_goal.value);
+
+        if (refresh || !last_goal.transmitted || static_cast<uint64_t>(std::llabs(delta)) > _deadband)
+            _filtered_cmd.push_back(goal);
+        else
+            _suppressed_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return _filtered_cmd;
+}
+
+/**
+ * @brief GoalDeltaFilter::setTransmitted : the goal has been transmitted to the motor without error
+ * @param id
+ * @param goal
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::setTransmitted(uint8_t id, ParamType goal)
+{
+    _goals.at(id).value = goal;
+    _goals.at(id).transmitted = true;
+}
+
+/**
+ * @brief GoalDeltaFilter::invalidate : the goal of the motor is unknown (failed write), it will be written at the next filter
+ * @param id
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::invalidate(uint8_t id)
+{
+    _goals.at(id).transmitted = false;
+}
+
+/**
+ * @brief GoalDeltaFilter::reset : the goals of all the motors are unknown (goals written by other commands, reconnection)
+ */
+template<typename ParamType>
+void GoalDeltaFilter<ParamType>::reset()
+{
+    for (auto &goal : _goals)
+        goal.transmitted = false;
+}
+
+/**
+ * @brief GoalDeltaFilter::getSuppressedCount
+ * @return number of goals not written since the start
+ */
+template<typename ParamType>
+uint64_t GoalDeltaFilter<ParamType>::getSuppressedCount() const
+{
+    return _suppressed_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // GOAL_DELTA_FILTER_HPP
@@ -0,0 +1,194 @@
+/*
+latency_histogram.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The LatencyHistogram class counts durations in fixed log2 buckets, without allocation
+ * Bucket 0 counts the durations below 1 us, bucket i the durations in [2^(i-1), 2^i[ us,
+ * and the last bucket all the durations above 2^(NB_BUCKETS - 2) us (about 1 s).
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr size_t NB_BUCKETS = 22;
+
+    LatencyHistogram() = default;
+
+    void add(double duration);
+    void reset();
+
+    uint32_t getCount() const;
+    double getMean() const;
+    double getMax() const;
+    double getPercentile(double percentile) const;
+    const std::array<uint32_t, NB_BUCKETS>& getBuckets() const;
+
+    static double getBucketUpperBound(size_t bucket);
+
+private:
+    static size_t getBucket(double duration);
+
+    std::array<uint32_t, NB_BUCKETS> _buckets{};
+    uint32_t _count{0};
+    double _sum{0.0};
+    double _max{0.0};
+};
+
+/**
+ * @brief LatencyHistogram::add
+ * @param duration : in seconds
+ */
+inline
+void LatencyHistogram::add(double duration)
+{
+    duration = std::max(duration, 0.0);
+
+    _buckets.at(getBucket(duration))++;
+    _count++;
+    _sum += duration;
+    _max = std::max(_max, duration);
+}
+
+/**
+ * @brief LatencyHistogram::reset
+ */
+inline
+void LatencyHistogram::reset()
+{
+    _buckets.fill(0);
+    _count = 0;
+    _sum = 0.0;
+    _max = 0.0;
+}
+
+/**
+ * @brief LatencyHistogram::getCount
+ * @return
+ */
+inline
+uint32_t LatencyHistogram::getCount() const
+{
+    return _count;
+}
+
+/**
+ * @brief LatencyHistogram::getMean
+ * @return mean duration in seconds, 0 if empty
+ */
+inline
+double LatencyHistogram::getMean() const
+{
+    return _count ? _sum / _count : 0.0;
+}
+
+/**
+ * @brief LatencyHistogram::getMax
+ * @return longest duration in seconds
+ */
+inline
+double LatencyHistogram::getMax() const
+{
+    return _max;
+}
+
+/**
+ * @brief LatencyHistogram::getPercentile
+ * @param percentile : between 0 and 1
+ * @return upper bound of the bucket holding the percentile, in seconds, never above the longest duration
+ */
+inline
+double LatencyHistogram::getPercentile(double percentile) const
+{
+    if (0 == _count)
+        return 0.0;
+
+    auto rank = static_cast<uint32_t>(std::ceil(std::min(std::max(percentile, 0.0), 1.0) * _count));
+    rank = std::max(rank, 1u);
+
+    uint32_t cumulated_count = 0;
+    for (size_t bucket = 0; bucket < NB_BUCKETS; ++bucket)
+    {
+        cumulated_count += _buckets.at(bucket);
+        if (cumulated_count >= rank)
+            return std::min(getBucketUpperBound(bucket), _max);
+    }
+
+    return _max;
+}
+
+/**
+ * @brief LatencyHistogram::getBuckets
+ * @return
+ */
+inline
+const std::array<uint32_t, LatencyHistogram::NB_BUCKETS>& LatencyHistogram::getBuckets() const
+{
+    return _buckets;
+}
+
+/**
+ * @brief LatencyHistogram::getBucketUpperBound
+ * @param bucket
+ * @return exclusive upper bound of the bucket in seconds, infinity for the last one
+ */
+inline
+double LatencyHistogram::getBucketUpperBound(size_t bucket)
+{
+    if (bucket + 1 >= NB_BUCKETS)
+        return std::numeric_limits<double>::infinity();
+
+    return std::ldexp(1e-6, static_cast<int>(bucket));
+}
+
+/**
+ * @brief LatencyHistogram::getBucket
+ * @param duration : in seconds
+ * @return
+ */
+inline
+size_t LatencyHistogram::getBucket(double duration)
+{
+    double duration_us = duration * 1e6;
+    if (duration_us < 1.0)
+        return 0;
+
+    // 2^e <= duration_us < 2^(e + 1)
+    auto bucket = static_cast<size_t>(std::ilogb(duration_us)) + 1;
+    return std::min(bucket, NB_BUCKETS - 1);
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // LATENCY_HISTOGRAM_HPP
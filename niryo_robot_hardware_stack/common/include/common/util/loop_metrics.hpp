@@ -0,0 +1,318 @@
+/*
+loop_metrics.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOP_METRICS_HPP
+#define LOOP_METRICS_HPP
+
+// std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "niryo_robot_msgs/DurationHistogram.h"
+#include "niryo_robot_msgs/LoopMetrics.h"
+
+#include "common/util/latency_histogram.hpp"
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The ELoopStage enum : stages of a control loop cycle
+ */
+enum class ELoopStage
+{
+    READ,
+    UPDATE,
+    WRITE,
+    STATUS,
+    NB_STAGES
+};
+
+/**
+ * @brief The LoopMetrics class measures the cycles of a periodic loop :
+ * period, execution time, wake-up latency, deadline misses and the stages of the longest cycle.
+ * startCycle, endStage and endCycle are called by the loop thread only,
+ * getMsg can be called from any thread.
+ * A cycle misses its deadline when it ends more than one period after its planned wake-up.
+ */
+class LoopMetrics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LoopMetrics(std::string loop_name);
+
+    void setExpectedPeriod(double expected_period);
+    void setThreadSettings(const std::string &thread_settings);
+
+    void startCycle();
+    void endStage(ELoopStage stage);
+    void endCycle();
+    void pause();
+
+    niryo_robot_msgs::LoopMetrics getMsg();
+    void reset();
+
+    static std::string stageName(ELoopStage stage);
+
+private:
+    static constexpr size_t NB_STAGES = static_cast<size_t>(ELoopStage::NB_STAGES);
+
+    static niryo_robot_msgs::DurationHistogram toMsg(const LatencyHistogram &histogram);
+
+    std::mutex _mutex;
+    std::string _loop_name;
+    std::atomic<double> _expected_period{0.0};
+    std::string _thread_settings;
+
+    // current cycle, loop thread only
+    Clock::time_point _cycle_start;
+    Clock::time_point _stage_start;
+    std::array<double, NB_STAGES> _stage_durations{};
+    double _wake_up_latency{0.0};
+    // no previous cycle after a start or a pause, the period is not known
+    bool _has_previous_cycle{false};
+    Clock::time_point _previous_cycle_start;
+    Clock::time_point _previous_cycle_end;
+
+    // cumulated since the start
+    LatencyHistogram _period;
+    LatencyHistogram _execution_time;
+    LatencyHistogram _wake_up_latency_histogram;
+    uint64_t _cycle_count{0};
+    uint64_t _deadline_miss_count{0};
+    double _worst_execution_time{0.0};
+    std::array<double, NB_STAGES> _worst_stage_durations{};
+};
+
+/**
+ * @brief LoopMetrics::LoopMetrics
+ * @param loop_name
+ */
+inline
+LoopMetrics::LoopMetrics(std::string loop_name) :
+    _loop_name(std::move(loop_name))
+{
+}
+
+/**
+ * @brief LoopMetrics::setExpectedPeriod
+ * @param expected_period : in seconds
+ */
+inline
+void LoopMetrics::setExpectedPeriod(double expected_period)
+{
+    _expected_period.store(expected_period);
+}
+
+/**
+ * @brief LoopMetrics::setThreadSettings
+ * @param thread_settings : effective scheduling of the loop thread
+ */
+inline
+void LoopMetrics::setThreadSettings(const std::string &thread_settings)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _thread_settings = thread_settings;
+}
+
+/**
+ * @brief LoopMetrics::startCycle : to be called when the loop wakes up
+ */
+inline
+void LoopMetrics::startCycle()
+{
+    Clock::time_point now = Clock::now();
+
+    _cycle_start = now;
+    _stage_start = now;
+    _stage_durations.fill(0.0);
+    _wake_up_latency = 0.0;
+
+    if (_has_previous_cycle)
+    {
+        // the loop should have woken up one period after the previous start, or right after the previous end if it overran
+        Clock::time_point planned_wake_up = std::max(_previous_cycle_start + std::chrono::duration_cast<Clock::duration>(
+                                                                                 std::chrono::duration<double>(_expected_period.load())),
+                                                     _previous_cycle_end);
+        _wake_up_latency = std::max(std::chrono::duration<double>(now - planned_wake_up).count(), 0.0);
+    }
+}
+
+/**
+ * @brief LoopMetrics::endStage : the time since the previous stage (or the start of the cycle) is given to this stage
+ * @param stage
+ */
+inline
+void LoopMetrics::endStage(ELoopStage stage)
+{
+    Clock::time_point now = Clock::now();
+    _stage_durations.at(static_cast<size_t>(stage)) += std::chrono::duration<double>(now - _stage_start).count();
+    _stage_start = now;
+}
+
+/**
+ * @brief LoopMetrics::endCycle : to be called before the loop sleeps
+ */
+inline
+void LoopMetrics::endCycle()
+{
+    Clock::time_point now = Clock::now();
+    double execution_time = std::chrono::duration<double>(now - _cycle_start).count();
+
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    _execution_time.add(execution_time);
+    if (_has_previous_cycle)
+    {
+        _period.add(std::chrono::duration<double>(_cycle_start - _previous_cycle_start).count());
+        _wake_up_latency_histogram.add(_wake_up_latency);
+    }
+
+    double expected_period = _expected_period.load();
+    if (expected_period > 0.0 && _wake_up_latency + execution_time > expected_period)
+        _deadline_miss_count++;
+
+    if (execution_time > _worst_execution_time)
+    {
+        _worst_execution_time = execution_time;
+        _worst_stage_durations = _stage_durations;
+    }
+
+    _cycle_count++;
+
+    _has_previous_cycle = true;
+    _previous_cycle_start = _cycle_start;
+    _previous_cycle_end = now;
+}
+
+/**
+ * @brief LoopMetrics::pause : the loop stops cycling (disconnection, disabled loop),
+ * the next cycle has no period nor wake-up latency
+ */
+inline
+void LoopMetrics::pause()
+{
+    _has_previous_cycle = false;
+}
+
+/**
+ * @brief LoopMetrics::getMsg
+ * @return metrics cumulated since the start
+ */
+inline
+niryo_robot_msgs::LoopMetrics LoopMetrics::getMsg()
+{
+    niryo_robot_msgs::LoopMetrics msg;
+    msg.loop = _loop_name;
+
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    msg.expected_period = _expected_period.load();
+    msg.thread_settings = _thread_settings;
+    msg.cycle_count = _cycle_count;
+    msg.deadline_miss_count = _deadline_miss_count;
+
+    msg.period = toMsg(_period);
+    msg.execution_time = toMsg(_execution_time);
+    msg.wake_up_latency = toMsg(_wake_up_latency_histogram);
+
+    msg.worst_execution_time = _worst_execution_time;
+    for (size_t stage = 0; stage < NB_STAGES; ++stage)
+    {
+        msg.stage_names.emplace_back(stageName(static_cast<ELoopStage>(stage)));
+        msg.worst_stage_durations.emplace_back(_worst_stage_durations.at(stage));
+    }
+
+    return msg;
+}
+
+/**
+ * @brief LoopMetrics::reset
+ */
+inline
+void LoopMetrics::reset()
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    _period.reset();
+    _execution_time.reset();
+    _wake_up_latency_histogram.reset();
+    _cycle_count = 0;
+    _deadline_miss_count = 0;
+    _worst_execution_time = 0.0;
+    _worst_stage_durations.fill(0.0);
+}
+
+/**
+ * @brief LoopMetrics::stageName
+ * @param stage
+ * @return
+ */
+inline
+std::string LoopMetrics::stageName(ELoopStage stage)
+{
+    switch (stage)
+    {
+        case ELoopStage::READ:
+            return "read";
+        case ELoopStage::UPDATE:
+            return "update";
+        case ELoopStage::WRITE:
+            return "write";
+        case ELoopStage::STATUS:
+            return "status";
+        case ELoopStage::NB_STAGES:
+            break;
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief LoopMetrics::toMsg
+ * @param histogram
+ * @return
+ */
+inline
+niryo_robot_msgs::DurationHistogram LoopMetrics::toMsg(const LatencyHistogram &histogram)
+{
+    niryo_robot_msgs::DurationHistogram msg;
+
+    msg.mean = histogram.getMean();
+    msg.p50 = histogram.getPercentile(0.5);
+    msg.p99 = histogram.getPercentile(0.99);
+    msg.max = histogram.getMax();
+    msg.buckets.assign(histogram.getBuckets().begin(), histogram.getBuckets().end());
+
+    return msg;
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // LOOP_METRICS_HPP
@@ -0,0 +1,261 @@
+/*
+loop_timer.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOP_TIMER_HPP
+#define LOOP_TIMER_HPP
+
+// linux
+#include <time.h>
+
+// std
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The LoopTimer class wakes a periodic loop on absolute deadlines of CLOCK_MONOTONIC
+ * The deadlines stay on the grid start + k * period : the loop does not drift and does not depend on ROS time.
+ * After an overrun the next cycle starts at once, and the deadlines missed by more than one period are skipped (no burst).
+ * All the times are seconds of CLOCK_MONOTONIC.
+ */
+class LoopTimer
+{
+public:
+    explicit LoopTimer(double period = 0.0);
+
+    void setPeriod(double period);
+    double getPeriod() const;
+
+    void reset();
+    bool sleep();
+
+    double getCycleTime() const;
+    double getWakeUpTime() const;
+    uint64_t getMissedCount() const;
+
+    static double now();
+
+private:
+    static int64_t nowNs();
+
+    int64_t _period_ns{0};
+    // deadline of the current cycle, on the grid
+    int64_t _cycle_deadline_ns{0};
+    int64_t _wake_up_ns{0};
+    uint64_t _missed_count{0};
+};
+
+/**
+ * @brief The SubRate class : slower rate phase-locked on the cycles of a LoopTimer
+ * isDue is given the cycle time of the timer, so the sub-rate does not suffer from the wake-up jitter
+ * and keeps its mean frequency even if it is not a divider of the loop frequency.
+ */
+class SubRate
+{
+public:
+    SubRate() = default;
+
+    void setPeriod(double period);
+    void reset(double now);
+    bool isDue(double cycle_time);
+
+private:
+    double _period{0.0};
+    double _deadline{0.0};
+};
+
+/**
+ * @brief LoopTimer::LoopTimer
+ * @param period : in seconds
+ */
+inline
+LoopTimer::LoopTimer(double period)
+{
+    setPeriod(period);
+    reset();
+}
+
+/**
+ * @brief LoopTimer::setPeriod : taken into account from the next cycle
+ * @param period : in seconds
+ */
+inline
+void LoopTimer::setPeriod(double period)
+{
+    _period_ns = period > 0.0 ? static_cast<int64_t>(std::llround(period * 1e9)) : 0;
+}
+
+/**
+ * @brief LoopTimer::getPeriod
+ * @return
+ */
+inline
+double LoopTimer::getPeriod() const
+{
+    return static_cast<double>(_period_ns) * 1e-9;
+}
+
+/**
+ * @brief LoopTimer::reset : the grid of the deadlines restarts now
+ */
+inline
+void LoopTimer::reset()
+{
+    _wake_up_ns = nowNs();
+    _cycle_deadline_ns = _wake_up_ns;
+}
+
+/**
+ * @brief LoopTimer::sleep : waits for the deadline of the next cycle
+ * @return false if the deadline was already passed (overrun)
+ */
+inline
+bool LoopTimer::sleep()
+{
+    _cycle_deadline_ns += _period_ns;
+
+    int64_t now_ns = nowNs();
+    bool deadline_met = now_ns < _cycle_deadline_ns;
+
+    if (deadline_met)
+    {
+        struct timespec deadline;
+        deadline.tv_sec = static_cast<time_t>(_cycle_deadline_ns / 1000000000);
+        deadline.tv_nsec = static_cast<long>(_cycle_deadline_ns % 1000000000);
+
+        while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr))
+        {
+        }
+
+        now_ns = nowNs();
+    }
+    else if (_period_ns > 0 && now_ns - _cycle_deadline_ns >= _period_ns)
+    {
+        // more than one period late : the cycle is the last deadline of the grid before now
+        int64_t missed = (now_ns - _cycle_deadline_ns) / _period_ns;
+        _cycle_deadline_ns += missed * _period_ns;
+        _missed_count += static_cast<uint64_t>(missed);
+    }
+
+    // the only clock sample of the cycle
+    _wake_up_ns = now_ns;
+
+    return deadline_met;
+}
+
+/**
+ * @brief LoopTimer::getCycleTime
+ * @return deadline of the current cycle, on the grid of the deadlines
+ */
+inline
+double LoopTimer::getCycleTime() const
+{
+    return static_cast<double>(_cycle_deadline_ns) * 1e-9;
+}
+
+/**
+ * @brief LoopTimer::getWakeUpTime
+ * @return time at which the current cycle actually started
+ */
+inline
+double LoopTimer::getWakeUpTime() const
+{
+    return static_cast<double>(_wake_up_ns) * 1e-9;
+}
+
+/**
+ * @brief LoopTimer::getMissedCount
+ * @return number of deadlines skipped since the creation of the timer
+ */
+inline
+uint64_t LoopTimer::getMissedCount() const
+{
+    return _missed_count;
+}
+
+/**
+ * @brief LoopTimer::now
+ * @return seconds of CLOCK_MONOTONIC
+ */
+inline
+double LoopTimer::now()
+{
+    return static_cast<double>(nowNs()) * 1e-9;
+}
+
+/**
+ * @brief LoopTimer::nowNs
+ * @return nanoseconds of CLOCK_MONOTONIC
+ */
+inline
+int64_t LoopTimer::nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief SubRate::setPeriod
+ * @param period : in seconds
+ */
+inline
+void SubRate::setPeriod(double period)
+{
+    _period = period;
+}
+
+/**
+ * @brief SubRate::reset : the sub-rate is due at the first cycle after now
+ * @param now
+ */
+inline
+void SubRate::reset(double now)
+{
+    _deadline = now;
+}
+
+/**
+ * @brief SubRate::isDue
+ * @param cycle_time : LoopTimer::getCycleTime
+ * @return true once per period
+ */
+inline
+bool SubRate::isDue(double cycle_time)
+{
+    if (cycle_time < _deadline)
+        return false;
+
+    // next deadline one period later, or on the first period after now if we are late by more than one period
+    _deadline += _period;
+    if (_period > 0.0 && _deadline <= cycle_time)
+        _deadline += std::ceil((cycle_time - _deadline) / _period + 1e-9) * _period;
+
+    return true;
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // LOOP_TIMER_HPP
@@ -0,0 +1,281 @@
+/*
+mpsc_priority_queue.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef MPSC_PRIORITY_QUEUE_HPP
+#define MPSC_PRIORITY_QUEUE_HPP
+
+// std
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The MpscPriorityQueue class is a bounded lock free queue with several priority levels
+ * Any number of threads can push into it without blocking (multiple producers),
+ * only one thread is allowed to pop from it (single consumer).
+ * Each priority level is a ring buffer of Capacity elements, elements of the same priority are popped in FIFO order
+ * Priority 0 is the highest priority.
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+class MpscPriorityQueue
+{
+    static_assert(Capacity >= 2 && 0 == (Capacity & (Capacity - 1)), "MpscPriorityQueue : Capacity must be a power of 2");
+    static_assert(NbPriorities > 0, "MpscPriorityQueue : at least one priority is needed");
+
+public:
+    MpscPriorityQueue();
+
+    // see https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#c21-if-you-define-or-delete-any-copy-move-or-destructor-function-define-or-delete-them-all
+    MpscPriorityQueue( const MpscPriorityQueue& ) = delete;
+    MpscPriorityQueue( MpscPriorityQueue&& ) = delete;
+    MpscPriorityQueue& operator= ( MpscPriorityQueue && ) = delete;
+    MpscPriorityQueue& operator= ( const MpscPriorityQueue& ) = delete;
+
+    // producers
+    bool push(T&& value, size_t priority);
+
+    // consumer
+    bool pop(T& value);
+    bool pop(T& value, size_t priority);
+    const T* front(size_t priority) const;
+
+    // getters (approximated if producers are pushing at the same time)
+    bool empty() const;
+    bool empty(size_t priority) const;
+    size_t size(size_t priority) const;
+
+    static constexpr size_t capacity();
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    // producers and consumer indexes are separated by a cache line to avoid false sharing
+    struct Ring
+    {
+        std::array<Cell, Capacity> cells;
+        std::atomic<size_t> enqueue_pos{0};
+        char pad[64];
+        std::atomic<size_t> dequeue_pos{0};
+    };
+
+    std::array<Ring, NbPriorities> _rings;
+
+    static constexpr size_t MASK = Capacity - 1;
+};
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::MpscPriorityQueue
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+MpscPriorityQueue<T, Capacity, NbPriorities>::MpscPriorityQueue()
+{
+    // the sequence of a cell tells which turn it is waiting for
+    for (auto &ring : _rings)
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            ring.cells.at(i).sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::push : can be called concurrently by any thread
+ * @param value : left untouched if the push fails
+ * @param priority
+ * @return false if the ring of this priority is full
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+bool MpscPriorityQueue<T, Capacity, NbPriorities>::push(T&& value, size_t priority)
+{
+    if (priority >= NbPriorities)
+        return false;
+
+    Ring &ring = _rings.at(priority);
+    Cell *cell = nullptr;
+    size_t pos = ring.enqueue_pos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        cell = &ring.cells[pos & MASK];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+        if (0 == dif)
+        {
+            // cell is free, try to reserve it
+            if (ring.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (dif < 0)
+        {
+            // full
+            return false;
+        }
+        else
+        {
+            // another producer took this cell
+            pos = ring.enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->data = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::pop : pop the oldest element of the highest not empty priority
+ * @param value
+ * @return false if the queue is empty
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+bool MpscPriorityQueue<T, Capacity, NbPriorities>::pop(T& value)
+{
+    for (size_t priority = 0; priority < NbPriorities; ++priority)
+    {
+        if (pop(value, priority))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::pop : pop the oldest element of the given priority
+ * Must only be called by the consumer thread
+ * @param value
+ * @param priority
+ * @return false if there is no element of this priority
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+bool MpscPriorityQueue<T, Capacity, NbPriorities>::pop(T& value, size_t priority)
+{
+    if (priority >= NbPriorities)
+        return false;
+
+    Ring &ring = _rings.at(priority);
+    size_t pos = ring.dequeue_pos.load(std::memory_order_relaxed);
+    Cell &cell = ring.cells[pos & MASK];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+    // empty, or the producer of this cell has not finished yet
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+        return false;
+
+    value = std::move(cell.data);
+    cell.data = T{};
+    cell.sequence.store(pos + Capacity, std::memory_order_release);
+    ring.dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::front : oldest element of the given priority, without popping it
+ * Must only be called by the consumer thread, the pointer is valid until the next pop of this priority
+ * @param priority
+ * @return nullptr if there is no element of this priority
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+const T* MpscPriorityQueue<T, Capacity, NbPriorities>::front(size_t priority) const
+{
+    if (priority >= NbPriorities)
+        return nullptr;
+
+    const Ring &ring = _rings.at(priority);
+    size_t pos = ring.dequeue_pos.load(std::memory_order_relaxed);
+    const Cell &cell = ring.cells[pos & MASK];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+        return nullptr;
+
+    return &cell.data;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::empty
+ * @return
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+bool MpscPriorityQueue<T, Capacity, NbPriorities>::empty() const
+{
+    for (size_t priority = 0; priority < NbPriorities; ++priority)
+    {
+        if (!empty(priority))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::empty
+ * @param priority
+ * @return
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+bool MpscPriorityQueue<T, Capacity, NbPriorities>::empty(size_t priority) const
+{
+    return 0 == size(priority);
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::size
+ * @param priority
+ * @return number of elements reserved by producers and not popped yet
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+size_t MpscPriorityQueue<T, Capacity, NbPriorities>::size(size_t priority) const
+{
+    if (priority >= NbPriorities)
+        return 0;
+
+    const Ring &ring = _rings.at(priority);
+    size_t dequeue_pos = ring.dequeue_pos.load(std::memory_order_acquire);
+    size_t enqueue_pos = ring.enqueue_pos.load(std::memory_order_acquire);
+
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+}
+
+/**
+ * @brief MpscPriorityQueue<T, Capacity, NbPriorities>::capacity
+ * @return max number of elements for each priority
+ */
+template<typename T, size_t Capacity, size_t NbPriorities>
+constexpr size_t MpscPriorityQueue<T, Capacity, NbPriorities>::capacity()
+{
+    return Capacity;
+}
+
+} // util
+} // common
+
+#endif // MPSC_PRIORITY_QUEUE_HPP
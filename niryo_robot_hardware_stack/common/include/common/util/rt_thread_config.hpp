@@ -0,0 +1,211 @@
+/*
+rt_thread_config.hpp
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef RT_THREAD_CONFIG_HPP
+#define RT_THREAD_CONFIG_HPP
+
+// linux
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// std
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The RtThreadConfig class : real-time profile of a loop thread
+ * The profile is applied by the thread itself, at its start. Each setting failing
+ * (missing CAP_SYS_NICE / CAP_IPC_LOCK, unknown cpu) is skipped with a warning and the thread keeps its default.
+ * mlockall applies to the whole process. Isolating the cpus from the other tasks is done by the kernel (isolcpus).
+ */
+class RtThreadConfig
+{
+public:
+    RtThreadConfig() = default;
+
+    void readParameters(ros::NodeHandle &nh, const std::string &param_ns);
+
+    std::string apply() const;
+
+    static std::string getEffectiveSettings();
+
+public:
+    // SCHED_FIFO priority, 0 keeps the default scheduler
+    int priority{0};
+    // cpus the thread runs on, all cpus if empty
+    std::vector<int> cpu_affinity;
+    // lock the current and future memory of the process
+    bool lock_memory{false};
+    // bytes of stack touched at start, no page fault in the loop afterwards when the memory is locked
+    int prefault_stack_size{0};
+
+    static constexpr int MAX_PREFAULT_STACK_SIZE = 1024 * 1024;
+
+private:
+    static void prefaultStack(size_t size);
+};
+
+/**
+ * @brief RtThreadConfig::readParameters
+ * @param nh
+ * @param param_ns : namespace of the profile, relative to nh
+ */
+inline
+void RtThreadConfig::readParameters(ros::NodeHandle &nh, const std::string &param_ns)
+{
+    nh.getParam(param_ns + "/priority", priority);
+    nh.getParam(param_ns + "/cpu_affinity", cpu_affinity);
+    nh.getParam(param_ns + "/lock_memory", lock_memory);
+    nh.getParam(param_ns + "/prefault_stack_size", prefault_stack_size);
+
+    ROS_DEBUG("RtThreadConfig::readParameters - %s : priority %d, %d cpus, lock memory %d, prefault stack %d bytes",
+              param_ns.c_str(), priority, static_cast<int>(cpu_affinity.size()), lock_memory, prefault_stack_size);
+}
+
+/**
+ * @brief RtThreadConfig::apply : to be called at the start of the configured thread
+ * @return effective settings of the thread
+ */
+inline
+std::string RtThreadConfig::apply() const
+{
+    if (lock_memory && 0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+        ROS_WARN("RtThreadConfig::apply - unable to lock the memory (%s), memory kept unlocked", strerror(errno));
+
+    if (prefault_stack_size > 0)
+        prefaultStack(static_cast<size_t>(prefault_stack_size < MAX_PREFAULT_STACK_SIZE ? prefault_stack_size : MAX_PREFAULT_STACK_SIZE));
+
+    if (!cpu_affinity.empty())
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (auto const cpu : cpu_affinity)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpu_set);
+        }
+
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (0 != err)
+            ROS_WARN("RtThreadConfig::apply - unable to set the cpu affinity (%s), thread kept on all cpus", strerror(err));
+    }
+
+    if (priority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = std::max(std::min(priority, sched_get_priority_max(SCHED_FIFO)), sched_get_priority_min(SCHED_FIFO));
+
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (0 != err)
+            ROS_WARN("RtThreadConfig::apply - unable to set SCHED_FIFO priority %d (%s), default scheduler kept", param.sched_priority, strerror(err));
+    }
+
+    return getEffectiveSettings();
+}
+
+/**
+ * @brief RtThreadConfig::getEffectiveSettings
+ * @return scheduler, priority and cpus of the calling thread, locked memory of the process
+ */
+inline
+std::string RtThreadConfig::getEffectiveSettings()
+{
+    std::ostringstream settings;
+
+    int policy = SCHED_OTHER;
+    sched_param param{};
+    if (0 == pthread_getschedparam(pthread_self(), &policy, &param))
+    {
+        switch (policy)
+        {
+            case SCHED_FIFO:
+                settings << "SCHED_FIFO priority " << param.sched_priority;
+                break;
+            case SCHED_RR:
+                settings << "SCHED_RR priority " << param.sched_priority;
+                break;
+            default:
+                settings << "SCHED_OTHER";
+                break;
+        }
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (0 == pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set))
+    {
+        settings << ", cpus";
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &cpu_set))
+                settings << " " << cpu;
+        }
+    }
+
+    // locked memory of the process, as seen by the kernel
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (0 == line.compare(0, 6, "VmLck:"))
+        {
+            std::istringstream locked(line.substr(6));
+            long locked_kb = 0;
+            locked >> locked_kb;
+            settings << ", locked memory " << locked_kb << " kB";
+            break;
+        }
+    }
+
+    return settings.str();
+}
+
+/**
+ * @brief RtThreadConfig::prefaultStack : touches each page of the next stack bytes of the thread
+ * @param size
+ */
+inline
+void RtThreadConfig::prefaultStack(size_t size)
+{
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile auto *stack = static_cast<volatile unsigned char *>(alloca(size));
+
+    for (size_t offset = 0; offset < size; offset += page_size)
+        stack[offset] = 0;
+}
+
+}  // namespace util
+}  // namespace common
+
+#endif  // RT_THREAD_CONFIG_HPP
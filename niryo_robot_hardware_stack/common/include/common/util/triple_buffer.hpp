@@ -0,0 +1,140 @@
+/*
+triple_buffer.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+// std
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The TripleBuffer class hands the latest value of a writer thread over to a reader thread, wait free
+ * The writer fills its own buffer then publishes it, the reader always takes the newest published value.
+ * Both threads never work on the same buffer, so there is neither lock nor torn read, and no allocation.
+ * Only one writer thread and one reader thread are allowed.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // see https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#c21-if-you-define-or-delete-any-copy-move-or-destructor-function-define-or-delete-them-all
+    TripleBuffer( const TripleBuffer& ) = delete;
+    TripleBuffer( TripleBuffer&& ) = delete;
+    TripleBuffer& operator= ( TripleBuffer && ) = delete;
+    TripleBuffer& operator= ( const TripleBuffer& ) = delete;
+
+    // writer
+    T& getWriteBuffer();
+    void publish();
+
+    // reader
+    bool consume();
+    const T& getReadBuffer() const;
+
+    uint32_t getOverwrittenCount() const;
+
+private:
+    std::array<T, 3> _buffers{};
+
+    // index of the buffer exchanged between writer and reader, with a flag telling it has not been consumed yet
+    std::atomic<uint8_t> _middle{1};
+    // owned by the writer thread
+    uint8_t _write_index{0};
+    // owned by the reader thread
+    uint8_t _read_index{2};
+
+    // number of published values replaced by a newer one before being consumed
+    std::atomic<uint32_t> _overwritten_count{0};
+
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t NEW_DATA_FLAG = 0x04;
+};
+
+/**
+ * @brief TripleBuffer<T>::getWriteBuffer : buffer to be filled by the writer before publish
+ * @return
+ */
+template<typename T>
+T& TripleBuffer<T>::getWriteBuffer()
+{
+    return _buffers[_write_index];
+}
+
+/**
+ * @brief TripleBuffer<T>::publish : make the write buffer available for the reader
+ */
+template<typename T>
+void TripleBuffer<T>::publish()
+{
+    uint8_t previous = _middle.exchange(static_cast<uint8_t>(_write_index | NEW_DATA_FLAG), std::memory_order_acq_rel);
+    _write_index = previous & INDEX_MASK;
+
+    if (previous & NEW_DATA_FLAG)
+        _overwritten_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief TripleBuffer<T>::consume : take the newest published value in the read buffer
+ * @return false if nothing has been published since the last consume
+ */
+template<typename T>
+bool TripleBuffer<T>::consume()
+{
+    if (!(_middle.load(std::memory_order_relaxed) & NEW_DATA_FLAG))
+        return false;
+
+    uint8_t previous = _middle.exchange(_read_index, std::memory_order_acq_rel);
+    _read_index = previous & INDEX_MASK;
+
+    return true;
+}
+
+/**
+ * @brief TripleBuffer<T>::getReadBuffer : value taken by the last consume
+ * @return
+ */
+template<typename T>
+const T& TripleBuffer<T>::getReadBuffer() const
+{
+    return _buffers[_read_index];
+}
+
+/**
+ * @brief TripleBuffer<T>::getOverwrittenCount : can be called from any thread
+ * @return
+ */
+template<typename T>
+uint32_t TripleBuffer<T>::getOverwrittenCount() const
+{
+    return _overwritten_count.load(std::memory_order_relaxed);
+}
+
+} // util
+} // common
+
+#endif // TRIPLE_BUFFER_HPP
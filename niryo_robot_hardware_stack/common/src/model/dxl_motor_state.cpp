@@ -61,37 +61,45 @@ DxlMotorState::DxlMotorState(std::string name, EHardwareType type, EComponentTyp
     // to put in config ?
 
     // according to xl-320 datasheet : 1 speed ~ 0.111 rpm ~ 1.8944 dxl position per second
+    // efforts are approximated from the datasheets stall torque : load unit is 0.1 % of stall torque,
+    // current unit is converted with stall torque / stall current
     switch (_hw_type)
     {
     case EHardwareType::XL320:
         _total_angle = 300;
         _total_range_position = 1024;
         _steps_for_one_speed = 1.8944;  // 0.111 * 1024 / 60
+        _effort_for_one_load = 0.00039;  // 0.39 N.m * 0.1 %
         break;
     case EHardwareType::XC430:
         _total_angle = 360;
         _total_range_position = 4096;
         _steps_for_one_speed = 15.6330667;  // 0.229 * 4096 / 60
+        _effort_for_one_load = 0.0014;  // 1.4 N.m * 0.1 %
         break;
     case EHardwareType::XL330:
         _total_angle = 360;
         _total_range_position = 4096;
         _steps_for_one_speed = 15.6330667;  // 0.229 * 4096 / 60
+        _effort_for_one_load = 0.000354;  // 0.52 N.m / 1.47 A * 1 mA
         break;
     case EHardwareType::XL430:
         _total_angle = 360;
         _total_range_position = 4096;
         _steps_for_one_speed = 15.6330667;  // 0.229 * 4096 / 60
+        _effort_for_one_load = 0.0014;  // 1.4 N.m * 0.1 %
         break;
     case EHardwareType::XM430:
         _total_angle = 360;
         _total_range_position = 4096;
         _steps_for_one_speed = 15.6330667;  // 0.229 * 4096 / 60
+        _effort_for_one_load = 0.0048;  // 4.1 N.m / 2.3 A * 2.69 mA
         break;
     case EHardwareType::FAKE_DXL_MOTOR:
         _total_angle = 360;
         _total_range_position = 4096;
         _steps_for_one_speed = 15.6330667;  // 0.229 * 4096 / 60
+        _effort_for_one_load = 0.0014;  // 1.4 N.m * 0.1 %
         break;
     default:
         break;
@@ -180,14 +188,26 @@ double DxlMotorState::to_rad_pos(int motor_pos)
  * @param rad_vel
  * @return
  */
-int DxlMotorState::to_motor_vel(double rad_vel) { return static_cast<int>(std::round(rad_vel / _vel_multiplier_ratio)); }
+int DxlMotorState::to_motor_vel(double rad_vel)
+{
+    assert(0.0 != _vel_multiplier_ratio);
+
+    return static_cast<int>(std::round(rad_vel * _direction / _vel_multiplier_ratio));
+}
 
 /**
- * @brief DxlMotorState::to_motor_vel
+ * @brief DxlMotorState::to_rad_vel
  * @param motor_vel
  * @return
  */
-double DxlMotorState::to_rad_vel(int motor_vel) { return motor_vel * _vel_multiplier_ratio; }
+double DxlMotorState::to_rad_vel(int motor_vel) { return motor_vel * _direction * _vel_multiplier_ratio; }
+
+/**
+ * @brief DxlMotorState::to_effort
+ * @param motor_load : present load, or present current for motors without load register
+ * @return
+ */
+double DxlMotorState::to_effort(int motor_load) { return motor_load * _direction * _effort_for_one_load; }
 
 /**
  * @brief DxlMotorState::setPositionPGain
@@ -251,7 +271,8 @@ void DxlMotorState::updateMultiplierRatio()
     assert(0.0 != _total_angle);
 
     _pos_multiplier_ratio = RADIAN_TO_DEGREE * _total_range_position / _total_angle;
-    _vel_multiplier_ratio = 0.229;
+    // rad/s for one speed unit
+    _vel_multiplier_ratio = _steps_for_one_speed / _pos_multiplier_ratio;
 }
 
 }  // namespace model
@@ -154,7 +154,7 @@ double StepperMotorState::to_rad_pos(int motor_pos)
 int StepperMotorState::to_motor_vel(double rad_vel)
 {
     assert(0.0 != _vel_multiplier_ratio);
-    return static_cast<int>(std::round(rad_vel / _vel_multiplier_ratio));
+    return static_cast<int>(std::round(rad_vel * _direction / _vel_multiplier_ratio));
 }
 
 /**
@@ -162,7 +162,13 @@ int StepperMotorState::to_motor_vel(double rad_vel)
  * @param motor_vel
  * @return
  */
-double StepperMotorState::to_rad_vel(int motor_vel) { return motor_vel * _vel_multiplier_ratio; }
+double StepperMotorState::to_rad_vel(int motor_vel) { return motor_vel * _direction * _vel_multiplier_ratio; }
+
+/**
+ * @brief StepperMotorState::to_effort : steppers have no load feedback
+ * @return
+ */
+double StepperMotorState::to_effort(int /*motor_load*/) { return 0.0; }
 
 // ****************
 //  Setters
@@ -261,7 +267,8 @@ void StepperMotorState::updateMultiplierRatio()
     else
     {
         _pos_multiplier_ratio = 360 / (_motor_ratio * total_angle);
-        _vel_multiplier_ratio = 0.01;
+        // present velocity unit is 0.01 rpm, on the same axis as the position : reduced by the motor ratio too
+        _vel_multiplier_ratio = 0.01 * _motor_ratio * total_angle / 60;
     }
 }
 
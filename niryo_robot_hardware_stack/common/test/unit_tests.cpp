@@ -18,10 +18,24 @@
 #include "common/model/dxl_motor_state.hpp"
 #include "common/model/single_motor_cmd.hpp"
 #include "common/model/stepper_motor_state.hpp"
-
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/model/joint_trajectory_cmd.hpp"
+#include "common/util/bus_metrics.hpp"
+#include "common/util/goal_delta_filter.hpp"
+#include "common/util/latency_histogram.hpp"
+#include "common/util/loop_metrics.hpp"
+#include "common/util/loop_timer.hpp"
+#include "common/util/mpsc_priority_queue.hpp"
+#include "common/util/rt_thread_config.hpp"
+#include "common/util/triple_buffer.hpp"
+
+#include <chrono>
 #include <cmath>
+#include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 // Bring in gtest
 #include <gtest/gtest.h>
@@ -133,6 +147,19 @@ TEST_P(DXLCommonTest, extremeHigh)
     EXPECT_NEAR(dxlState.to_rad_pos(dxlState.getTotalRangePosition()), totalAngle_rad + dxlState.getOffsetPosition(), precision) << "to_motor_pos failed";
 }
 
+TEST_P(DXLCommonTest, velocityAndEffort)
+{
+    // a speed of 1000 moves 1000 * steps for one speed positions in one second
+    int nb_steps = static_cast<int>(std::round(1000 * dxlState.getStepsForOneSpeed()));
+    EXPECT_NEAR(dxlState.to_rad_vel(1000), dxlState.to_rad_pos(nb_steps) - dxlState.to_rad_pos(0), precision) << "to_rad_vel failed";
+    EXPECT_EQ(dxlState.to_motor_vel(dxlState.to_rad_vel(1000)), 1000) << "to_motor_vel o to_rad_vel is not identity";
+
+    // effort follows the sign of the load
+    EXPECT_GT(dxlState.to_effort(100), 0.0);
+    EXPECT_LT(dxlState.to_effort(-100), 0.0);
+    EXPECT_DOUBLE_EQ(dxlState.to_effort(0), 0.0);
+}
+
 TEST_P(DXLIdentityRadTest, identityFromRad)
 {
     // check combinations is identity
@@ -255,6 +282,17 @@ TEST(CommonTestSuite, testDefaultInvalid)
     EXPECT_FALSE(stepperState.isValid());
 }
 
+TEST(CommonTestSuite, testStepperTtlVelocity)
+{
+    common::model::StepperMotorState stepperState(EHardwareType::STEPPER, EComponentType::JOINT, common::model::EBusProtocol::TTL, 2);
+    stepperState.setMotorRatio(0.0872);
+    stepperState.updateMultiplierRatio();
+
+    // a speed of 6000 (60 rpm) moves 360 positions in one second, converted with the same motor ratio
+    EXPECT_NEAR(stepperState.to_rad_vel(6000), stepperState.to_rad_pos(360) - stepperState.to_rad_pos(0), 0.001) << "to_rad_vel failed";
+    EXPECT_EQ(stepperState.to_motor_vel(stepperState.to_rad_vel(6000)), 6000) << "to_motor_vel o to_rad_vel is not identity";
+}
+
 TEST(CommonTestSuite, testCreationDxlCmd)
 {
     // DxlSingleCmd valid param
@@ -304,6 +342,498 @@ TEST(CommonTestSuite, testCreationStepperCmd)
     ASSERT_NE(cmd.getId(), static_cast<uint8_t>(1));
     ASSERT_EQ(cmd.getParam(), static_cast<uint8_t>(5));
 }
+TEST(CommonTestSuite, testMpscPriorityQueueOrder)
+{
+    common::util::MpscPriorityQueue<std::unique_ptr<int>, 4, 2> queue;
+    ASSERT_TRUE(queue.empty());
+
+    // fill low priority ring, then it overflows
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.push(std::make_unique<int>(i), 1));
+
+    auto overflow = std::make_unique<int>(10);
+    ASSERT_FALSE(queue.push(std::move(overflow), 1));
+    ASSERT_TRUE(overflow);
+
+    ASSERT_TRUE(queue.push(std::make_unique<int>(100), 0));
+    ASSERT_EQ(queue.size(0), 1u);
+    ASSERT_EQ(queue.size(1), 4u);
+
+    // front does not pop
+    ASSERT_NE(queue.front(1), nullptr);
+    ASSERT_EQ(**queue.front(1), 0);
+    ASSERT_EQ(queue.size(1), 4u);
+
+    // highest priority first, then FIFO order
+    std::unique_ptr<int> value;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(*value, 100);
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(*value, i);
+    }
+
+    ASSERT_FALSE(queue.pop(value));
+    ASSERT_EQ(queue.front(0), nullptr);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(CommonTestSuite, testMpscPriorityQueueMultipleProducers)
+{
+    constexpr int nb_producers = 4;
+    constexpr int nb_values = 1000;
+
+    common::util::MpscPriorityQueue<int, 64, 1> queue;
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < nb_producers; ++p)
+    {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < nb_values; ++i)
+            {
+                int value = p * nb_values + i;
+                while (!queue.push(std::move(value), 0))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // values of each producer must be received in order
+    std::vector<int> last_values(nb_producers, -1);
+    int nb_received = 0;
+    while (nb_received < nb_producers * nb_values)
+    {
+        int value = 0;
+        if (queue.pop(value))
+        {
+            int p = value / nb_values;
+            ASSERT_GT(value % nb_values, last_values.at(p));
+            last_values.at(p) = value % nb_values;
+            nb_received++;
+        }
+    }
+
+    for (auto &t : producers)
+        t.join();
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(CommonTestSuite, testFixedVector)
+{
+    common::model::TtlJointTrajectoryCmd cmd;
+    ASSERT_TRUE(cmd.empty());
+
+    for (size_t i = 0; i < cmd.capacity(); ++i)
+        ASSERT_TRUE(cmd.push_back(std::make_pair(static_cast<uint8_t>(i), static_cast<uint32_t>(i * 10))));
+
+    // full
+    ASSERT_FALSE(cmd.push_back(std::make_pair(0, 0)));
+    ASSERT_EQ(cmd.size(), cmd.capacity());
+    ASSERT_EQ(cmd.at(2).second, 20u);
+    ASSERT_THROW(cmd.at(cmd.capacity()), std::out_of_range);
+
+    size_t nb_elements = 0;
+    for (auto const &c : cmd)
+        ASSERT_EQ(c.first, nb_elements++);
+    ASSERT_EQ(nb_elements, cmd.size());
+
+    cmd.clear();
+    ASSERT_TRUE(cmd.empty());
+    ASSERT_EQ(cmd.begin(), cmd.end());
+}
+
+TEST(CommonTestSuite, testTripleBufferNewestValue)
+{
+    common::util::TripleBuffer<int> buffer;
+    ASSERT_FALSE(buffer.consume());
+
+    buffer.getWriteBuffer() = 1;
+    buffer.publish();
+    buffer.getWriteBuffer() = 2;
+    buffer.publish();
+
+    // reader takes the newest value, the first one has been overwritten
+    ASSERT_TRUE(buffer.consume());
+    ASSERT_EQ(buffer.getReadBuffer(), 2);
+    ASSERT_EQ(buffer.getOverwrittenCount(), 1u);
+
+    // nothing new
+    ASSERT_FALSE(buffer.consume());
+    ASSERT_EQ(buffer.getReadBuffer(), 2);
+
+    buffer.getWriteBuffer() = 3;
+    buffer.publish();
+    ASSERT_TRUE(buffer.consume());
+    ASSERT_EQ(buffer.getReadBuffer(), 3);
+    ASSERT_EQ(buffer.getOverwrittenCount(), 1u);
+}
+
+TEST(CommonTestSuite, testTripleBufferNoTornRead)
+{
+    constexpr int nb_values = 100000;
+
+    common::util::TripleBuffer<common::model::TtlJointTrajectoryCmd> buffer;
+
+    // all the elements of a published command have the same value
+    std::thread writer([&buffer]() {
+        for (int i = 1; i <= nb_values; ++i)
+        {
+            auto &cmd = buffer.getWriteBuffer();
+            cmd.clear();
+            for (uint8_t id = 0; id < 6; ++id)
+                cmd.push_back(std::make_pair(id, static_cast<uint32_t>(i)));
+            buffer.publish();
+        }
+    });
+
+    uint32_t nb_consumed = 0;
+    uint32_t last_value = 0;
+    while (last_value < nb_values)
+    {
+        if (buffer.consume())
+        {
+            auto const &cmd = buffer.getReadBuffer();
+            ASSERT_EQ(cmd.size(), 6u);
+            for (auto const &c : cmd)
+                ASSERT_EQ(c.second, cmd.at(0).second);
+
+            // always newer
+            ASSERT_GT(cmd.at(0).second, last_value);
+            last_value = cmd.at(0).second;
+            nb_consumed++;
+        }
+    }
+
+    writer.join();
+
+    ASSERT_EQ(nb_consumed + buffer.getOverwrittenCount(), static_cast<uint32_t>(nb_values));
+}
+
+TEST(CommonTestSuite, testLatencyHistogram)
+{
+    common::util::LatencyHistogram histogram;
+    ASSERT_EQ(histogram.getCount(), 0u);
+    ASSERT_EQ(histogram.getPercentile(0.5), 0.0);
+
+    // 0.5 us, 90 x 300 us, 9 x 3 ms, 2 s
+    histogram.add(0.5e-6);
+    for (int i = 0; i < 90; ++i)
+        histogram.add(300e-6);
+    for (int i = 0; i < 9; ++i)
+        histogram.add(3e-3);
+    histogram.add(2.0);
+
+    ASSERT_EQ(histogram.getCount(), 101u);
+    ASSERT_EQ(histogram.getMax(), 2.0);
+    ASSERT_NEAR(histogram.getMean(), (0.5e-6 + 90 * 300e-6 + 9 * 3e-3 + 2.0) / 101, 1e-9);
+
+    auto const &buckets = histogram.getBuckets();
+    ASSERT_EQ(buckets.at(0), 1u);
+    // 256 <= 300 < 512 us
+    ASSERT_EQ(buckets.at(9), 90u);
+    // 2048 <= 3000 < 4096 us
+    ASSERT_EQ(buckets.at(12), 9u);
+    ASSERT_EQ(buckets.back(), 1u);
+
+    // upper bound of the bucket
+    ASSERT_DOUBLE_EQ(histogram.getPercentile(0.5), 512e-6);
+    ASSERT_DOUBLE_EQ(histogram.getPercentile(0.95), 4096e-6);
+    ASSERT_DOUBLE_EQ(histogram.getPercentile(1.0), 2.0);
+
+    histogram.reset();
+    ASSERT_EQ(histogram.getCount(), 0u);
+    ASSERT_EQ(histogram.getMax(), 0.0);
+}
+
+TEST(CommonTestSuite, testBusMetrics)
+{
+    using common::util::BusMetrics;
+    using common::util::EBusResult;
+    using common::util::EBusTransaction;
+
+    BusMetrics metrics("ttl");
+
+    auto start = BusMetrics::Clock::now() - std::chrono::milliseconds(1);
+    metrics.record(EBusTransaction::JOINTS_READ, common::model::EHardwareType::XL430, EBusResult::SUCCESS, start);
+    metrics.record(EBusTransaction::JOINTS_READ, common::model::EHardwareType::XL430, EBusResult::TIMEOUT, start);
+    metrics.record(EBusTransaction::GOAL_WRITE, common::model::EHardwareType::UNKNOWN, EBusResult::SUCCESS, start);
+
+    auto msg = metrics.getMsg();
+    ASSERT_EQ(msg.bus, "ttl");
+    ASSERT_EQ(msg.transactions.size(), 2u);
+    ASSERT_GT(msg.busy_fraction, 0.0);
+
+    auto const &joints_read = msg.transactions.at(0);
+    ASSERT_EQ(joints_read.transaction, "joints_read");
+    ASSERT_EQ(joints_read.success_count, 1u);
+    ASSERT_EQ(joints_read.timeout_count, 1u);
+    ASSERT_EQ(joints_read.corrupt_count + joints_read.error_count, 0u);
+    ASSERT_GE(joints_read.max_duration, 1e-3);
+    size_t nb_buckets = common::util::LatencyHistogram::NB_BUCKETS;
+    ASSERT_EQ(joints_read.duration_histogram.size(), nb_buckets);
+
+    ASSERT_EQ(msg.transactions.at(1).transaction, "goal_write");
+
+    // counts are cumulated, the busy fraction is computed since the previous message
+    msg = metrics.getMsg();
+    ASSERT_EQ(msg.transactions.at(0).success_count, 1u);
+    ASSERT_EQ(msg.busy_fraction, 0.0);
+
+    metrics.reset();
+    ASSERT_TRUE(metrics.getMsg().transactions.empty());
+}
+
+TEST(CommonTestSuite, testLoopMetrics)
+{
+    using common::util::ELoopStage;
+
+    common::util::LoopMetrics metrics("test_loop");
+    metrics.setExpectedPeriod(0.005);
+
+    // two cycles on time, one cycle overrunning its period
+    for (int i = 0; i < 3; ++i)
+    {
+        metrics.startCycle();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        metrics.endStage(ELoopStage::READ);
+        if (2 == i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(8));
+        metrics.endStage(ELoopStage::WRITE);
+        metrics.endCycle();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    auto msg = metrics.getMsg();
+    ASSERT_EQ(msg.loop, "test_loop");
+    ASSERT_EQ(msg.cycle_count, 3u);
+    ASSERT_EQ(msg.deadline_miss_count, 1u);
+    ASSERT_GE(msg.execution_time.max, 8e-3);
+    ASSERT_GT(msg.period.mean, 0.0);
+
+    // breakdown of the longest cycle
+    ASSERT_EQ(msg.stage_names.size(), 4u);
+    ASSERT_EQ(msg.stage_names.at(static_cast<size_t>(ELoopStage::WRITE)), "write");
+    ASSERT_GE(msg.worst_stage_durations.at(static_cast<size_t>(ELoopStage::WRITE)), 8e-3);
+    ASSERT_GE(msg.worst_stage_durations.at(static_cast<size_t>(ELoopStage::READ)), 200e-6);
+    ASSERT_EQ(msg.worst_stage_durations.at(static_cast<size_t>(ELoopStage::STATUS)), 0.0);
+    ASSERT_DOUBLE_EQ(msg.worst_execution_time, msg.execution_time.max);
+
+    // no period across a pause
+    metrics.pause();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    metrics.startCycle();
+    metrics.endCycle();
+    ASSERT_LT(metrics.getMsg().period.max, 20e-3);
+
+    metrics.reset();
+    ASSERT_EQ(metrics.getMsg().cycle_count, 0u);
+}
+
+TEST(CommonTestSuite, testRtThreadConfig)
+{
+    common::util::RtThreadConfig config;
+    config.cpu_affinity = {0};
+    config.prefault_stack_size = 64 * 1024;
+
+    // the cpus given to the process may not include the first one
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+    std::string settings;
+    std::string effective_settings;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    std::thread loop([&]() {
+        settings = config.apply();
+        effective_settings = common::util::RtThreadConfig::getEffectiveSettings();
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    });
+    loop.join();
+
+    // the settings returned are the ones of the thread, which is moved to the first cpu if it can
+    ASSERT_EQ(settings, effective_settings);
+    if (CPU_ISSET(0, &allowed))
+    {
+        ASSERT_EQ(CPU_COUNT(&cpu_set), 1);
+        ASSERT_TRUE(CPU_ISSET(0, &cpu_set));
+        ASSERT_NE(settings.find(", cpus 0,"), std::string::npos);
+    }
+    ASSERT_NE(settings.find("locked memory"), std::string::npos);
+}
+
+TEST(CommonTestSuite, testLoopTimer)
+{
+    common::util::LoopTimer timer(0.002);
+    double start = timer.getCycleTime();
+
+    // the wake-ups depend on the load of the machine : a few overruns are tolerated,
+    // but the deadlines always stay on the grid
+    auto on_grid = [&timer, start]() {
+        double cycles = (timer.getCycleTime() - start) / 0.002;
+        return std::fabs(cycles - std::round(cycles)) < 1e-6;
+    };
+
+    int overruns = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (!timer.sleep())
+            overruns++;
+        ASSERT_TRUE(on_grid());
+        ASSERT_GE(timer.getWakeUpTime(), timer.getCycleTime());
+    }
+    ASSERT_LE(overruns, 50);
+    ASSERT_GE(timer.getCycleTime(), start + 100 * 0.002 - 1e-9);
+
+    // overrun of more than two periods : the missed deadlines are skipped, the grid is kept
+    uint64_t missed_count = timer.getMissedCount();
+    std::this_thread::sleep_for(std::chrono::milliseconds(7));
+    ASSERT_FALSE(timer.sleep());
+    ASSERT_GE(timer.getMissedCount(), missed_count + 2);
+    ASSERT_LE(timer.getCycleTime(), timer.getWakeUpTime());
+    ASSERT_GT(timer.getCycleTime() + 0.002, timer.getWakeUpTime());
+    ASSERT_TRUE(on_grid());
+}
+
+TEST(CommonTestSuite, testSubRate)
+{
+    // 15 Hz on a 200 Hz loop : not a divider, the mean rate is kept
+    common::util::SubRate rate;
+    rate.setPeriod(1.0 / 15.0);
+    rate.reset(0.0);
+
+    int count = 0;
+    for (int cycle = 0; cycle < 600; ++cycle)
+    {
+        if (rate.isDue(cycle * 0.005))
+            count++;
+    }
+    ASSERT_EQ(count, 45);
+
+    // late by several periods : due once, no burst afterwards
+    ASSERT_TRUE(rate.isDue(10.0));
+    ASSERT_FALSE(rate.isDue(10.005));
+    ASSERT_TRUE(rate.isDue(10.07));
+}
+
+TEST(CommonTestSuite, testGoalDeltaFilter)
+{
+    common::util::GoalDeltaFilter<int32_t> filter;
+    common::model::CanJointTrajectoryCmd cmd;
+    cmd.push_back(std::make_pair<uint8_t, int32_t>(2, 100));
+    cmd.push_back(std::make_pair<uint8_t, int32_t>(3, -200));
+
+    // disabled : every goal is written
+    ASSERT_EQ(filter.filter(cmd, 0.0).size(), 2u);
+
+    filter.setDeadband(5);
+    filter.setRefreshPeriod(1.0);
+    filter.setEnabled(true);
+
+    // no goal transmitted yet, then the refresh is due at the first cycle
+    ASSERT_EQ(filter.filter(cmd, 0.0).size(), 2u);
+    filter.setTransmitted(2, 100);
+    filter.setTransmitted(3, -200);
+
+    // unchanged goals and changes within the deadband are not written
+    ASSERT_TRUE(filter.filter(cmd, 0.1).empty());
+    cmd.clear();
+    cmd.push_back(std::make_pair<uint8_t, int32_t>(2, 105));
+    cmd.push_back(std::make_pair<uint8_t, int32_t>(3, -206));
+    ASSERT_EQ(filter.filter(cmd, 0.2).size(), 1u);
+    ASSERT_EQ(filter.filter(cmd, 0.2).at(0).first, 3);
+    filter.setTransmitted(3, -206);
+    ASSERT_EQ(filter.getSuppressedCount(), 4u);
+
+    // a failed write is written again
+    filter.invalidate(2);
+    ASSERT_EQ(filter.filter(cmd, 0.3).size(), 1u);
+    filter.setTransmitted(2, 105);
+
+    // safety net : all the goals every refresh period
+    ASSERT_TRUE(filter.filter(cmd, 0.9).empty());
+    ASSERT_EQ(filter.filter(cmd, 1.0).size(), 2u);
+    ASSERT_TRUE(filter.filter(cmd, 1.1).empty());
+
+    // another command has been written : all the goals are unknown
+    filter.reset();
+    ASSERT_EQ(filter.filter(cmd, 1.2).size(), 2u);
+}
+
+TEST(CommonTestSuite, testJointStatesSnapshot)
+{
+    common::model::JointStatesSnapshot snapshot;
+    ASSERT_EQ(snapshot.find(2), nullptr);
+
+    ASSERT_TRUE(snapshot.update(2, 100, 1, 10, 0.5));
+    ASSERT_TRUE(snapshot.update(3, 200, 2, 20, 0.5));
+    ASSERT_TRUE(snapshot.update(2, 150, 3, -30, 0.6));
+
+    // updated in place, no duplicate
+    ASSERT_EQ(snapshot.samples.size(), 2u);
+    ASSERT_NE(snapshot.find(2), nullptr);
+    ASSERT_EQ(snapshot.find(2)->position, 150);
+    ASSERT_EQ(snapshot.find(2)->velocity, 3);
+    ASSERT_EQ(snapshot.find(2)->load, -30);
+    ASSERT_DOUBLE_EQ(snapshot.find(2)->stamp, 0.6);
+    ASSERT_EQ(snapshot.find(3)->position, 200);
+
+    for (size_t i = snapshot.samples.size(); i < common::model::MAX_JOINT_STATES_SNAPSHOT_SIZE; ++i)
+        ASSERT_TRUE(snapshot.update(static_cast<uint8_t>(10 + i), 0, 0, 0, 0.0));
+
+    // full : known joints are still updated, new ones are refused
+    ASSERT_TRUE(snapshot.update(3, 250, 0, 0, 0.7));
+    ASSERT_FALSE(snapshot.update(100, 0, 0, 0, 0.7));
+    ASSERT_EQ(snapshot.find(100), nullptr);
+
+    snapshot.cycle = 4;
+    snapshot.clear();
+    ASSERT_EQ(snapshot.find(2), nullptr);
+    ASSERT_EQ(snapshot.cycle, 4u);
+}
+
+TEST(CommonTestSuite, testJointStatesSnapshotSameCycle)
+{
+    constexpr uint64_t nb_cycles = 50000;
+
+    common::util::TripleBuffer<common::model::JointStatesSnapshot> buffer;
+
+    // bus thread : all the joints of a cycle are read at the position of the cycle number
+    std::thread bus_thread([&buffer]() {
+        common::model::JointStatesSnapshot states;
+        for (uint64_t cycle = 1; cycle <= nb_cycles; ++cycle)
+        {
+            for (uint8_t id = 2; id < 8; ++id)
+                states.update(id, static_cast<int>(cycle), 0, 0, static_cast<double>(cycle));
+            states.cycle = cycle;
+            states.stamp = static_cast<double>(cycle);
+
+            buffer.getWriteBuffer() = states;
+            buffer.publish();
+        }
+    });
+
+    uint64_t last_cycle = 0;
+    while (last_cycle < nb_cycles)
+    {
+        buffer.consume();
+        auto const &states = buffer.getReadBuffer();
+
+        // never mixed between cycles, never going back
+        ASSERT_GE(states.cycle, last_cycle);
+        for (auto const &sample : states.samples)
+        {
+            ASSERT_EQ(static_cast<uint64_t>(sample.position), states.cycle);
+            ASSERT_DOUBLE_EQ(sample.stamp, states.stamp);
+        }
+        last_cycle = states.cycle;
+    }
+
+    bus_thread.join();
+}
 }  // namespace
 
 // Run all the tests that were declared with TEST()
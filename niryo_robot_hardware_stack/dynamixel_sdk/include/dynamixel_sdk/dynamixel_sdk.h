@@ -25,8 +25,10 @@
 #include "group_bulk_read.h"
 #include "group_bulk_write.h"
 #include "group_sync_read.h"
+#include "group_fast_sync_read.h"
 #include "group_sync_write.h"
 #include "packet_handler.h"
+#include "packet_tracer.h"
 #include "port_handler.h"
 
 #endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_DYNAMIXELSDK_H_ */
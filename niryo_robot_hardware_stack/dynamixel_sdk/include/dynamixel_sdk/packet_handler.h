@@ -61,6 +61,7 @@
 #define INST_STATUS 85       // 0x55
 #define INST_SYNC_READ 130   // 0x82
 #define INST_BULK_WRITE 147  // 0x93
+#define INST_FAST_SYNC_READ 138  // 0x8A
 
 // Communication Result
 #define COMM_SUCCESS 0            // tx or rx packet communication success
@@ -548,6 +549,30 @@ class WINDECLSPEC PacketHandler
     /// @return communication results which come from PacketHandler::txPacket()
     ////////////////////////////////////////////////////////////////////////////////
     virtual int syncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that transmits INST_FAST_SYNC_READ instruction packet
+    /// @description The function makes an instruction packet with INST_FAST_SYNC_READ,
+    /// @description transmits the packet with PacketHandler::txPacket().
+    /// @param port PortHandler instance
+    /// @param start_address Address of the data for Fast Sync Read
+    /// @param data_length Length of the data for Fast Sync Read
+    /// @param param Parameter for Fast Sync Read {ID1, ID2, ID3, ...}
+    /// @param param_length Length of the data for Fast Sync Read
+    /// @return communication results which come from PacketHandler::txPacket()
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that receives the status packet of a Fast Sync Read
+    /// @description All the devices answer in a single status packet with the broadcast ID,
+    /// @description the function checks its CRC and copies its parameters.
+    /// @param port PortHandler instance
+    /// @param param_length Expected length of the parameters
+    /// @param param Parameters of the status packet {ERR1, ID1, DATA1..., CRC1, ERR2, ID2, DATA2..., CRC2, ..., ERRn, IDn, DATAn...}
+    /// @return communication results which come from PacketHandler::rxPacket()
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int fastSyncReadRx(PortHandler *port, uint16_t param_length, uint8_t *param) = 0;
     // SyncReadRx   -> GroupSyncRead class
     // SyncReadTxRx -> GroupSyncRead class
 
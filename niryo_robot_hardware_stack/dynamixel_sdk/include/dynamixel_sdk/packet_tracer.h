@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Copyright 2017 ROBOTIS CO., LTD.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for tracing the bytes sent and received on a port
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PACKETTRACER_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PACKETTRACER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <thread>
+
+#include "port_handler.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that records the bytes of a port into a binary capture file
+/// @description The port thread pushes the records in a lock-free ring, which is written to the file by a background thread.
+/// @description When the ring is full, the records are dropped and a DIRECTION_DROPPED_ record gives their count.
+/// @description Capture file : CAPTURE_MAGIC_ (8 bytes), then for each record, in little endian :
+/// @description timestamp (int64, nsec of CLOCK_MONOTONIC), direction (uint8), length (uint16), bytes (length)
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC PacketTracer
+{
+  public:
+    static const char CAPTURE_MAGIC_[9];                ///< "TTLTRC01", version included
+    static const int RECORD_HEADER_LEN_ = 8 + 1 + 2;   ///< Timestamp, direction, length
+    static const int RING_LEN_ = 1 << 18;              ///< Bytes of the ring, about 1 sec of a 2 Mbps bus
+
+    static const uint8_t DIRECTION_TX_ = 0;       ///< Bytes written on the port
+    static const uint8_t DIRECTION_RX_ = 1;       ///< Bytes read from the port
+    static const uint8_t DIRECTION_DROPPED_ = 2;  ///< Number of records dropped before this one (uint32)
+
+    PacketTracer();
+    virtual ~PacketTracer();
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that opens the capture file and starts the background thread
+    /// @param file_name Capture file, truncated
+    /// @return false when the file can not be opened
+    ////////////////////////////////////////////////////////////////////////////////
+    bool start(const char *file_name);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that writes the records left in the ring, stops the background thread and closes the file
+    /// @description The tracer has to be removed from the port first.
+    ////////////////////////////////////////////////////////////////////////////////
+    void stop();
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that records bytes of the port
+    /// @description Called by a single thread, the one using the port. Never blocks : the record is dropped when the ring is full.
+    /// @param direction DIRECTION_TX_ or DIRECTION_RX_
+    /// @param data Bytes sent or received
+    /// @param length Number of bytes
+    ////////////////////////////////////////////////////////////////////////////////
+    void trace(uint8_t direction, const uint8_t *data, int length);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the number of records dropped since start()
+    ////////////////////////////////////////////////////////////////////////////////
+    uint64_t getDroppedCount() const { return dropped_total_.load(); }
+
+    bool isRunning() const { return running_.load(); }
+
+  private:
+    void push(uint64_t &head, const uint8_t *data, int length);
+    bool flush();
+    void flushLoop();
+
+    uint8_t ring_[RING_LEN_];
+    std::atomic<uint64_t> head_;  // written by the port thread
+    std::atomic<uint64_t> tail_;  // written by the background thread
+    uint32_t dropped_;            // dropped since the last DIRECTION_DROPPED_ record, port thread only
+    std::atomic<uint64_t> dropped_total_;
+
+    std::atomic<bool> running_;
+    std::thread flush_thread_;
+    FILE *file_;
+};
+
+}  // namespace dynamixel
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PACKETTRACER_H_ */
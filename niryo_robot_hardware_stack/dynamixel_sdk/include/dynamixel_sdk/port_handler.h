@@ -50,6 +50,8 @@
 namespace dynamixel
 {
 
+class PacketTracer;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief The class for port control that inherits PortHandlerLinux, PortHandlerWindows, PortHandlerMac, or PortHandlerArduino
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,6 +59,8 @@ class WINDECLSPEC PortHandler
 {
   public:
     static const int DEFAULT_BAUDRATE_ = 57600;  ///< Default Baudrate
+    static const int TX_PACKET_BUFFER_LEN_ = 1024 + 1024 / 3 + 14;  ///< Longest instruction packet, byte stuffing included
+    static const int RX_PACKET_BUFFER_LEN_ = 1024;                  ///< Longest status packet
 
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that gets PortHandler class inheritance
@@ -126,6 +130,18 @@ class WINDECLSPEC PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     virtual int getBaudRate() = 0;
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that checks whether the low latency mode of the serial driver is set
+    /// @return true when ASYNC_LOW_LATENCY was set on the port when it was opened
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool isLowLatency() { return false; }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the latency timer of the USB serial adapter of the port
+    /// @return Latency timer in msec read back from the adapter, -1 when the port is not an USB serial adapter or when it is unknown
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int getLatencyTimer() { return -1; }
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that checks how much bytes are able to be read from the port buffer
     /// @description The function checks how much bytes are able to be read from the port buffer
@@ -146,6 +162,17 @@ class WINDECLSPEC PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     virtual int readPort(uint8_t *packet, int length) = 0;
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that waits for bytes and reads them from the port buffer
+    /// @description The function waits until length bytes are received or the packet timeout is passed,
+    /// @description and returns a number of bytes read.
+    /// @description By default, the function does not wait and reads the bytes already received with readPort().
+    /// @param packet Buffer for the packet received
+    /// @param length Length of the buffer for read
+    /// @return Length of bytes read
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int readPortBlocking(uint8_t *packet, int length) { return readPort(packet, length); }
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that writes bytes on the port buffer
     /// @description The function writes bytes on the port buffer,
@@ -177,6 +204,63 @@ class WINDECLSPEC PortHandler
     /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
     ////////////////////////////////////////////////////////////////////////////////
     virtual bool isPacketTimeout() = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets and starts stopwatch for watching the timeout of the status packets of some devices
+    /// @description The timeout can then take into account the return delay time and the response latency of each device.
+    /// @description By default, the function calls setPacketTimeout(packet_length).
+    /// @param packet_length Length of the status packets expected to be received
+    /// @param id_list Devices which are expected to answer
+    /// @param id_count Number of devices in id_list
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void setDevicePacketTimeout(uint16_t packet_length, const uint8_t *id_list, int id_count) { setPacketTimeout(packet_length); }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that notifies the port that the status packet of a device is received
+    /// @description Used to measure the response latency of the devices waited with setDevicePacketTimeout().
+    /// @param id ID of the device
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void notifyStatusReceived(uint8_t id) {}
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets the return delay time configured in a device
+    /// @param id ID of the device
+    /// @param return_delay_us Return delay time in microseconds
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void setReturnDelayTime(uint8_t id, uint32_t return_delay_us) {}
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that forgets the return delay time and the response latency of a device
+    /// @param id ID of the device
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void clearDeviceTiming(uint8_t id) {}
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets the tracer recording the bytes sent and received on the port
+    /// @description By default, the port is not traced.
+    /// @param tracer Started tracer, kept by the caller, or 0 to stop tracing
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void setPacketTracer(PacketTracer *tracer) {}
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that gets the buffer of the instruction packets sent on the port
+    /// @description The buffer is allocated with the port and reused by every transaction, as a port handles one transaction at a time.
+    /// @param length Length needed by the packet
+    /// @return 0 when the packet does not fit in the buffer
+    ////////////////////////////////////////////////////////////////////////////////
+    uint8_t *getTxPacketBuffer(int length) { return (length <= TX_PACKET_BUFFER_LEN_) ? tx_packet_buffer_ : 0; }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that gets the buffer of the status packets received on the port
+    /// @description The buffer is allocated with the port and reused by every transaction, as a port handles one transaction at a time.
+    /// @param length Length needed by the packet
+    /// @return 0 when the packet does not fit in the buffer
+    ////////////////////////////////////////////////////////////////////////////////
+    uint8_t *getRxPacketBuffer(int length) { return (length <= RX_PACKET_BUFFER_LEN_) ? rx_packet_buffer_ : 0; }
+
+  private:
+    uint8_t tx_packet_buffer_[TX_PACKET_BUFFER_LEN_];
+    uint8_t rx_packet_buffer_[RX_PACKET_BUFFER_LEN_];
 };
 
 }  // namespace dynamixel
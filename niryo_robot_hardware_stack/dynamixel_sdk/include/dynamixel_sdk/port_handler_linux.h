@@ -22,6 +22,9 @@
 #ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERLINUX_H_
 #define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERLINUX_H_
 
+#include <map>
+
+#include "packet_tracer.h"
 #include "port_handler.h"
 #include "serial/serial.h"
 
@@ -34,12 +37,52 @@ namespace dynamixel
 class PortHandlerLinux : public PortHandler
 {
   private:
+    static const int LATENCY_WINDOW_ = 128;      ///< Response latency samples kept for each device
+    static const int LATENCY_MIN_SAMPLES_ = 16;  ///< Samples needed before using the p99 latency of a device
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return delay time and response latency of a device, the latency excluding the transmission and the return delay time
+    ////////////////////////////////////////////////////////////////////////////////
+    struct DeviceTiming
+    {
+        int64_t return_delay_ns;
+        uint32_t latency_ns[LATENCY_WINDOW_];
+        int nb_samples;
+        int next_sample;
+        int64_t p99_latency_ns;
+        bool late;  // answered after its timeout, LATENCY_TIMER is used until its latency is learned again
+    };
+
     serial::Serial serial_;
-    double packet_start_time_ms_;
-    double packet_timeout_ms_;
+    int64_t packet_start_time_ns_;
+    int64_t packet_timeout_ns_;
+
+    int epoll_fd_;
+    int timer_fd_;
+    int read_min_;  // VMIN of the port, -1 if unknown
+
+    bool low_latency_;
+    int latency_timer_;  // msec, read back from the USB serial adapter, -1 if unknown
+
+    std::map<uint8_t, DeviceTiming> device_timings_;
+    uint8_t pending_ids_[256];  // devices of the current packet timeout
+    int pending_id_count_;
+    int64_t last_status_time_ns_;
+    int rx_bytes_since_status_;
+
+    PacketTracer *tracer_;  // 0 when the port is not traced
+
+    int64_t getCurrentTimeNs();
+    int64_t getTimeSinceStartNs();
 
-    double getCurrentTimeMs();
-    double getTimeSinceStart();
+    bool setReadMin(int read_min);
+
+    void setLowLatency();
+    int64_t getDefaultLatencyMarginNs();
+
+    DeviceTiming &getDeviceTiming(uint8_t id);
+    int64_t getLatencyMarginNs(uint8_t id);
+    void addLatencySample(uint8_t id, int64_t latency_ns);
 
     void gpioHigh();
     void gpioLow();
@@ -113,6 +156,21 @@ class PortHandlerLinux : public PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     int getBaudRate();
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that checks whether the low latency mode of the serial driver is set
+    /// @description ASYNC_LOW_LATENCY is set with TIOCSSERIAL when an USB serial adapter is opened.
+    /// @return true when the flag was read back on the port
+    ////////////////////////////////////////////////////////////////////////////////
+    bool isLowLatency();
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the latency timer of the USB serial adapter of the port
+    /// @description The latency timer is set to LATENCY_TIMER_TARGET through sysfs when an USB serial adapter is opened and the file is writable,
+    /// @description then read back. It is used in the packet timeouts instead of LATENCY_TIMER.
+    /// @return Latency timer in msec, -1 when the port is not an USB serial adapter or when it is unknown
+    ////////////////////////////////////////////////////////////////////////////////
+    int getLatencyTimer();
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that checks how much bytes are able to be read from the port buffer
     /// @description The function checks how much bytes are able to be read from the port buffer
@@ -133,6 +191,18 @@ class PortHandlerLinux : public PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     int readPort(uint8_t *packet, int length);
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that waits for bytes and reads them from the port buffer
+    /// @description The function sets VMIN to the number of bytes expected and blocks on the port with epoll,
+    /// @description so that it wakes up once, when the bytes are received or when the packet timeout is passed.
+    /// @description VMIN is set back to 0 before returning.
+    /// @description The bytes are read directly into packet.
+    /// @param packet Buffer for the packet received
+    /// @param length Length of the buffer for read
+    /// @return Length of bytes read
+    ////////////////////////////////////////////////////////////////////////////////
+    int readPortBlocking(uint8_t *packet, int length);
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that writes bytes on the port buffer
     /// @description The function writes bytes on the port buffer,
@@ -164,6 +234,40 @@ class PortHandlerLinux : public PortHandler
     /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
     ////////////////////////////////////////////////////////////////////////////////
     bool isPacketTimeout();
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets and starts stopwatch for watching the timeout of the status packets of some devices
+    /// @description The timeout is the transmission time of the status packets, the return delay time of each device,
+    /// @description and the largest p99 response latency learned for the devices, plus a guard.
+    /// @description A device without enough samples uses the largest p99 learned on the port, or LATENCY_TIMER if it already answered late.
+    /// @param packet_length Length of the status packets expected to be received
+    /// @param id_list Devices which are expected to answer
+    /// @param id_count Number of devices in id_list
+    ////////////////////////////////////////////////////////////////////////////////
+    void setDevicePacketTimeout(uint16_t packet_length, const uint8_t *id_list, int id_count);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that notifies the port that the status packet of a device is received
+    /// @description The time since the previous status packet, minus its transmission time and the return delay time of the device,
+    /// @description is a sample of the response latency of the device.
+    /// @param id ID of the device
+    ////////////////////////////////////////////////////////////////////////////////
+    void notifyStatusReceived(uint8_t id);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets the return delay time configured in a device
+    /// @param id ID of the device
+    /// @param return_delay_us Return delay time in microseconds
+    ////////////////////////////////////////////////////////////////////////////////
+    void setReturnDelayTime(uint8_t id, uint32_t return_delay_us);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that forgets the return delay time and the response latency of a device
+    /// @param id ID of the device
+    ////////////////////////////////////////////////////////////////////////////////
+    void clearDeviceTiming(uint8_t id);
+
+    void setPacketTracer(PacketTracer *tracer);
 };
 
 }  // namespace dynamixel
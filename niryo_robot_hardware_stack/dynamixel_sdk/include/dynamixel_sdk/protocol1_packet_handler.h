@@ -495,6 +495,31 @@ class WINDECLSPEC Protocol1PacketHandler : public PacketHandler
     // SyncReadRx   -> GroupSyncRead class
     // SyncReadTxRx -> GroupSyncRead class
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that transmits INST_FAST_SYNC_READ instruction packet
+    /// @description The function makes an instruction packet with INST_FAST_SYNC_READ,
+    /// @description transmits the packet with Protocol1PacketHandler::txPacket().
+    /// @param port PortHandler instance
+    /// @param start_address Address of the data for Fast Sync Read
+    /// @param data_length Length of the data for Fast Sync Read
+    /// @param param Parameter for Fast Sync Read {ID1, ID2, ID3, ...}
+    /// @param param_length Length of the data for Fast Sync Read
+    /// @return COMM_NOT_AVAILABLE
+    ////////////////////////////////////////////////////////////////////////////////
+    int fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that receives the status packet of a Fast Sync Read
+    /// @description All the devices answer in a single status packet with the broadcast ID,
+    /// @description the function checks its CRC and copies its parameters.
+    /// @param port PortHandler instance
+    /// @param param_length Expected length of the parameters
+    /// @param param Parameters of the status packet {ERR1, ID1, DATA1..., CRC1, ERR2, ID2, DATA2..., CRC2, ..., ERRn, IDn, DATAn...}
+    /// @return COMM_NOT_AVAILABLE
+    ////////////////////////////////////////////////////////////////////////////////
+    int fastSyncReadRx(PortHandler *port, uint16_t param_length, uint8_t *param);
+    // FastSyncReadTxRx -> GroupFastSyncRead class
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that transmits Sync Write instruction packet
     /// @description The function makes an instruction packet with INST_SYNC_WRITE,
@@ -37,9 +37,7 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
 
     Protocol2PacketHandler();
 
-    uint16_t updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size);
-    void addStuffing(uint8_t *packet);
-    void removeStuffing(uint8_t *packet);
+    int rxPacket(PortHandler *port, uint8_t *rxpacket, bool broadcast_status);
 
   public:
     ////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +54,39 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
     ////////////////////////////////////////////////////////////////////////////////
     float getProtocolVersion() { return 2.0; }
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that computes the CRC16 of a data block, 8 bytes at a time (slice-by-8 tables)
+    /// @param crc_accum CRC of the previous data blocks (0 for the first one)
+    /// @param data_blk_ptr Data block
+    /// @param data_blk_size Size of the data block
+    /// @return CRC16 of the data, identical to updateCRCReference()
+    ////////////////////////////////////////////////////////////////////////////////
+    uint16_t updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that computes the CRC16 of a data block one byte at a time
+    /// @description Reference implementation of the protocol 2.0 CRC16, used to validate updateCRC()
+    /// @param crc_accum CRC of the previous data blocks (0 for the first one)
+    /// @param data_blk_ptr Data block
+    /// @param data_blk_size Size of the data block
+    /// @return CRC16 of the data
+    ////////////////////////////////////////////////////////////////////////////////
+    uint16_t updateCRCReference(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that inserts a 0xFD after each 0xFF 0xFF 0xFD sequence of the parameters of an instruction packet
+    /// @description The packet buffer must be large enough for the stuffed packet, its length field is updated
+    /// @param packet Instruction packet, CRC not computed yet
+    ////////////////////////////////////////////////////////////////////////////////
+    void addStuffing(uint8_t *packet);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that removes the 0xFD inserted after each 0xFF 0xFF 0xFD sequence of a status packet
+    /// @description The length field of the packet is updated
+    /// @param packet Status packet
+    ////////////////////////////////////////////////////////////////////////////////
+    void removeStuffing(uint8_t *packet);
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that gets description of communication result
     /// @param result Communication result which might be gotten by the tx rx functions
@@ -509,6 +540,31 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
     // SyncReadRx   -> GroupSyncRead class
     // SyncReadTxRx -> GroupSyncRead class
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that transmits INST_FAST_SYNC_READ instruction packet
+    /// @description The function makes an instruction packet with INST_FAST_SYNC_READ,
+    /// @description transmits the packet with Protocol2PacketHandler::txPacket().
+    /// @param port PortHandler instance
+    /// @param start_address Address of the data for Fast Sync Read
+    /// @param data_length Length of the data for Fast Sync Read
+    /// @param param Parameter for Fast Sync Read {ID1, ID2, ID3, ...}
+    /// @param param_length Length of the data for Fast Sync Read
+    /// @return communication results which come from Protocol2PacketHandler::txPacket()
+    ////////////////////////////////////////////////////////////////////////////////
+    int fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that receives the status packet of a Fast Sync Read
+    /// @description All the devices answer in a single status packet with the broadcast ID,
+    /// @description the function checks its CRC and copies its parameters.
+    /// @param port PortHandler instance
+    /// @param param_length Expected length of the parameters
+    /// @param param Parameters of the status packet {ERR1, ID1, DATA1..., CRC1, ERR2, ID2, DATA2..., CRC2, ..., ERRn, IDn, DATAn...}
+    /// @return communication results which come from Protocol2PacketHandler::rxPacket()
+    ////////////////////////////////////////////////////////////////////////////////
+    int fastSyncReadRx(PortHandler *port, uint16_t param_length, uint8_t *param);
+    // FastSyncReadTxRx -> GroupFastSyncRead class
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that transmits INST_SYNC_WRITE instruction packet
     /// @description The function makes an instruction packet with INST_SYNC_WRITE,
@@ -51,6 +51,8 @@ void GroupSyncRead::makeParam()
     int idx = 0;
     for (unsigned int i = 0; i < id_list_.size(); i++)
         param_[idx++] = id_list_[i];
+
+    is_param_changed_ = false;
 }
 
 bool GroupSyncRead::addParam(uint8_t id)
@@ -59,6 +59,8 @@ void GroupSyncWrite::makeParam()
         for (int c = 0; c < data_length_; c++)
             param_[idx++] = (data_list_[id])[c];
     }
+
+    is_param_changed_ = false;
 }
 
 bool GroupSyncWrite::addParam(uint8_t id, uint8_t *data)
@@ -94,12 +96,18 @@ bool GroupSyncWrite::changeParam(uint8_t id, uint8_t *data)
     if (it == id_list_.end())  // NOT exist
         return false;
 
-    delete[] data_list_[id];
-    data_list_[id] = new uint8_t[data_length_];
+    // same length : the data buffer is reused
     for (int c = 0; c < data_length_; c++)
         data_list_[id][c] = data[c];
 
-    is_param_changed_ = true;
+    // the parameter packet is patched in place, it is only rebuilt when the list of ids changes
+    if (param_ != 0 && is_param_changed_ == false)
+    {
+        int idx = (it - id_list_.begin()) * (1 + data_length_) + 1;  // ID(1)
+        for (int c = 0; c < data_length_; c++)
+            param_[idx + c] = data[c];
+    }
+
     return true;
 }
 
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright 2017 ROBOTIS CO., LTD.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "dynamixel_sdk/packet_tracer.h"
+
+#define FLUSH_PERIOD_MS 20  // period of the background thread when the ring is empty
+
+using namespace dynamixel;
+
+const char PacketTracer::CAPTURE_MAGIC_[9] = "TTLTRC01";
+
+PacketTracer::PacketTracer() : head_(0), tail_(0), dropped_(0), dropped_total_(0), running_(false), file_(0) {}
+
+PacketTracer::~PacketTracer() { stop(); }
+
+bool PacketTracer::start(const char *file_name)
+{
+    if (running_.load())
+        return false;
+
+    file_ = fopen(file_name, "wb");
+    if (file_ == 0)
+        return false;
+
+    fwrite(CAPTURE_MAGIC_, 1, 8, file_);
+
+    head_.store(0);
+    tail_.store(0);
+    dropped_ = 0;
+    dropped_total_.store(0);
+
+    running_.store(true);
+    flush_thread_ = std::thread(&PacketTracer::flushLoop, this);
+
+    return true;
+}
+
+void PacketTracer::stop()
+{
+    if (!running_.exchange(false))
+        return;
+
+    if (flush_thread_.joinable())
+        flush_thread_.join();
+
+    flush();
+    fclose(file_);
+    file_ = 0;
+}
+
+void PacketTracer::trace(uint8_t direction, const uint8_t *data, int length)
+{
+    if (!running_.load(std::memory_order_relaxed) || length <= 0 || length > 0xFFFF)
+        return;
+
+    struct timespec tv;
+    clock_gettime(CLOCK_MONOTONIC, &tv);
+    int64_t timestamp_ns = (int64_t)tv.tv_sec * 1000000000 + tv.tv_nsec;
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t free_len = RING_LEN_ - (head - tail_.load(std::memory_order_acquire));
+    uint64_t needed_len = RECORD_HEADER_LEN_ + length + (dropped_ > 0 ? RECORD_HEADER_LEN_ + 4 : 0);
+    if (free_len < needed_len)
+    {
+        dropped_++;
+        dropped_total_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint8_t header[RECORD_HEADER_LEN_];
+    for (int b = 0; b < 8; b++)
+        header[b] = (uint8_t)(timestamp_ns >> (8 * b));
+
+    if (dropped_ > 0)
+    {
+        uint8_t count[4] = {(uint8_t)dropped_, (uint8_t)(dropped_ >> 8), (uint8_t)(dropped_ >> 16), (uint8_t)(dropped_ >> 24)};
+        header[8] = DIRECTION_DROPPED_;
+        header[9] = 4;
+        header[10] = 0;
+        push(head, header, RECORD_HEADER_LEN_);
+        push(head, count, 4);
+        dropped_ = 0;
+    }
+
+    header[8] = direction;
+    header[9] = (uint8_t)(length & 0xFF);
+    header[10] = (uint8_t)(length >> 8);
+    push(head, header, RECORD_HEADER_LEN_);
+    push(head, data, length);
+
+    // the records are complete when the background thread sees them
+    head_.store(head, std::memory_order_release);
+}
+
+void PacketTracer::push(uint64_t &head, const uint8_t *data, int length)
+{
+    int offset = (int)(head % RING_LEN_);
+    int first_len = std::min(length, RING_LEN_ - offset);
+
+    memcpy(&ring_[offset], data, first_len);
+    memcpy(&ring_[0], data + first_len, length - first_len);
+
+    head += length;
+}
+
+bool PacketTracer::flush()
+{
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == tail)
+        return false;
+
+    int offset = (int)(tail % RING_LEN_);
+    int length = (int)(head - tail);
+    int first_len = std::min(length, RING_LEN_ - offset);
+
+    fwrite(&ring_[offset], 1, first_len, file_);
+    fwrite(&ring_[0], 1, length - first_len, file_);
+    fflush(file_);
+
+    tail_.store(head, std::memory_order_release);
+    return true;
+}
+
+void PacketTracer::flushLoop()
+{
+    while (running_.load())
+    {
+        if (!flush())
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLUSH_PERIOD_MS));
+    }
+}
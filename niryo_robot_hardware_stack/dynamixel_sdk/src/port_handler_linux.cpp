@@ -27,41 +27,47 @@
 
 #if defined(__linux__)
 
+#include <errno.h>
 #include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <linux/serial.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <termios.h>
 #include <time.h>
+#include <unistd.h>
 
 #if defined __arm__ || defined __aarch64__
 #include <wiringPi.h>
 #endif
 
+#include <algorithm>
+
 #include "dynamixel_sdk/port_handler_linux.h"
 
-#define LATENCY_TIMER                                                                                                                                                              \
-    5  // msec (USB latency timer)
-       // You should adjust the latency timer value. From the version Ubuntu 16.04.2, the default latency timer of the usb serial is '16 msec'.
-       // When you are going to use sync / bulk read, the latency timer should be loosen.
-       // the lower latency timer value, the faster communication speed.
+#define LATENCY_TIMER 5         // msec, USB latency timer assumed when it can not be read back from the adapter
+#define LATENCY_TIMER_TARGET 1  // msec, USB latency timer set when the port is opened
 
 // Note:
-// You can check its value by:
-// $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
+// The latency timer of an USB serial adapter delays the status packets, 16 msec by default for FTDI adapters.
+// When an USB serial adapter is opened, openPort() sets ASYNC_LOW_LATENCY on the port (which also sets the latency timer of the FTDI adapters to 1 msec),
+// and writes LATENCY_TIMER_TARGET into /sys/bus/usb-serial/devices/ttyUSB0/latency_timer when the file is writable.
+// The effective value is then read back and used in the packet timeouts.
 //
-// If you think that the communication is too slow, type following after plugging the usb in to change the latency timer
-//
-// Method 1. Type following (you should do this everytime when the usb once was plugged out or the connection was dropped)
-// $ echo 1 | sudo tee /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-// $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-//
-// Method 2. If you want to set it as be done automatically, and don't want to do above everytime, make rules file in /etc/udev/rules.d/. For example,
+// If the file is not writable by the user of the driver, it can be set by an udev rule, for example:
 // $ echo ACTION==\"add\", SUBSYSTEM==\"usb-serial\", DRIVER==\"ftdi_sio\", ATTR{latency_timer}=\"1\" > 99-dynamixelsdk-usb.rules
 // $ sudo cp ./99-dynamixelsdk-usb.rules /etc/udev/rules.d/
 // $ sudo udevadm control --reload-rules
 // $ sudo udevadm trigger --action=add
 // $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-//
-// or if you have another good idea that can be an alternatives,
-// please give us advice via github issue https://github.com/ROBOTIS-GIT/DynamixelSDK/issues
+
+#define LATENCY_GUARD_NS 500000  // added to the p99 response latency learned for the devices
 
 #define GPIO_HALF_DUPLEX_DIRECTION 17
 
@@ -80,7 +86,8 @@
 
 using namespace dynamixel;
 
-PortHandlerLinux::PortHandlerLinux(const char *port_name) : packet_start_time_ms_(0.0), packet_timeout_ms_(0.0)
+PortHandlerLinux::PortHandlerLinux(const char *port_name)
+    : packet_start_time_ns_(0), packet_timeout_ns_(0), epoll_fd_(-1), timer_fd_(-1), read_min_(-1), low_latency_(false), latency_timer_(-1), pending_id_count_(0), last_status_time_ns_(0), rx_bytes_since_status_(0), tracer_(0)
 {
     is_using_ = false;
     setPortName(port_name);
@@ -124,10 +131,51 @@ bool PortHandlerLinux::openPort()
 #endif
 
     serial_.open();
+    read_min_ = -1;
+
+    if (serial_.isOpen())
+        setLowLatency();
+
+    // epoll instance waited on by readPortBlocking, which falls back on readPort without it
+    if (serial_.isOpen() && epoll_fd_ < 0)
+    {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = serial_.getFd();
+        if (epoll_fd_ >= 0 && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, serial_.getFd(), &event) != 0)
+        {
+            close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+
+        // timer of the packet timeout, epoll_wait itself only has a millisecond resolution
+        timer_fd_ = (epoll_fd_ >= 0) ? timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) : -1;
+        event.data.fd = timer_fd_;
+        if (timer_fd_ >= 0 && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &event) != 0)
+        {
+            close(timer_fd_);
+            timer_fd_ = -1;
+        }
+    }
+
     return serial_.isOpen();
 }
 
-void PortHandlerLinux::closePort() { serial_.close(); }
+void PortHandlerLinux::closePort()
+{
+    if (timer_fd_ >= 0)
+        close(timer_fd_);
+    timer_fd_ = -1;
+
+    if (epoll_fd_ >= 0)
+        close(epoll_fd_);
+    epoll_fd_ = -1;
+
+    serial_.close();
+}
 
 void PortHandlerLinux::clearPort() { serial_.flush(); }
 
@@ -140,17 +188,94 @@ const char *PortHandlerLinux::getPortName() { return serial_.getPort().c_str();
 bool PortHandlerLinux::setBaudRate(const int baudrate)
 {
     serial_.setBaudrate(baudrate);
+    read_min_ = -1;  // VMIN reset by the port reconfiguration
     return serial_.getBaudrate() == baudrate;
 }
 
 int PortHandlerLinux::getBaudRate() { return serial_.getBaudrate(); }
 
+bool PortHandlerLinux::isLowLatency() { return low_latency_; }
+
+int PortHandlerLinux::getLatencyTimer() { return latency_timer_; }
+
 int PortHandlerLinux::getBytesAvailable() { return serial_.available(); }
 
-int PortHandlerLinux::readPort(uint8_t *packet, int length) { return serial_.read(packet, length); }
+int PortHandlerLinux::readPort(uint8_t *packet, int length)
+{
+    int bytes_read = serial_.read(packet, length);
+    rx_bytes_since_status_ += bytes_read;
+    if (tracer_ && bytes_read > 0)
+        tracer_->trace(PacketTracer::DIRECTION_RX_, packet, bytes_read);
+    return bytes_read;
+}
+
+int PortHandlerLinux::readPortBlocking(uint8_t *packet, int length)
+{
+    int fd = serial_.getFd();
+    if (fd < 0 || epoll_fd_ < 0)
+        return readPort(packet, length);
+
+    int bytes_read = 0;
+    while (bytes_read < length)
+    {
+        // the port is non blocking : read what is already received
+        ssize_t bytes_read_now = read(fd, &packet[bytes_read], length - bytes_read);
+        if (bytes_read_now > 0)
+        {
+            bytes_read += bytes_read_now;
+            continue;
+        }
+        if (bytes_read_now < 0 && errno != EAGAIN && errno != EINTR)
+            break;
+
+        int64_t timeout_ns = packet_timeout_ns_ - getTimeSinceStartNs();
+        if (timeout_ns <= 0)
+            break;
+
+        // the port only becomes readable when VMIN bytes are received, hence a single wake up per packet
+        if (!setReadMin(length - bytes_read))
+            break;
+
+        if (timer_fd_ >= 0)
+        {
+            int64_t deadline_ns = packet_start_time_ns_ + packet_timeout_ns_;
+            struct itimerspec deadline;
+            memset(&deadline, 0, sizeof(deadline));
+            deadline.it_value.tv_sec = deadline_ns / 1000000000;
+            deadline.it_value.tv_nsec = deadline_ns % 1000000000;
+            timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &deadline, NULL);
+        }
+
+        struct epoll_event events[2];
+        int nb_events = epoll_wait(epoll_fd_, events, 2, static_cast<int>(ceil(timeout_ns / 1000000.0)));
+        if (nb_events == 0 || (nb_events < 0 && errno != EINTR))
+            break;
+
+        bool port_error = false;
+        for (int e = 0; e < nb_events; e++)
+        {
+            if (events[e].data.fd == fd && (events[e].events & (EPOLLERR | EPOLLHUP)))
+                port_error = true;
+        }
+        if (port_error)
+            break;
+    }
+
+    // the other reads of the port (readPort, the serial library) expect the default VMIN
+    if (read_min_ != 0)
+        setReadMin(0);
+
+    rx_bytes_since_status_ += bytes_read;
+    if (tracer_ && bytes_read > 0)
+        tracer_->trace(PacketTracer::DIRECTION_RX_, packet, bytes_read);
+    return bytes_read;
+}
 
 int PortHandlerLinux::writePort(uint8_t *packet, int length)
 {
+    if (tracer_)
+        tracer_->trace(PacketTracer::DIRECTION_TX_, packet, length);
+
     gpioHigh();
     size_t written = serial_.write(packet, length);
     serial_.waitByteTimes(written);
@@ -160,40 +285,229 @@ int PortHandlerLinux::writePort(uint8_t *packet, int length)
 
 void PortHandlerLinux::setPacketTimeout(uint16_t packet_length)
 {
-    packet_start_time_ms_ = getCurrentTimeMs();
-    uint32_t byte_time_ms = serial_.getByteTimeNs() / 1000000;
-    packet_timeout_ms_ = (byte_time_ms * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+    packet_start_time_ns_ = getCurrentTimeNs();
+    packet_timeout_ns_ = (int64_t)serial_.getByteTimeNs() * packet_length + getDefaultLatencyMarginNs();
+    pending_id_count_ = 0;
 }
 
 void PortHandlerLinux::setPacketTimeout(double msec)
 {
-    packet_start_time_ms_ = getCurrentTimeMs();
-    packet_timeout_ms_ = msec;
+    packet_start_time_ns_ = getCurrentTimeNs();
+    packet_timeout_ns_ = (int64_t)(msec * 1000000.0);
+    pending_id_count_ = 0;
 }
 
 bool PortHandlerLinux::isPacketTimeout()
 {
-    if (getTimeSinceStart() > packet_timeout_ms_)
+    if (getTimeSinceStartNs() > packet_timeout_ns_)
     {
-        packet_timeout_ms_ = 0;
+        // a device started to answer after its timeout : its latency has to be learned again
+        if (rx_bytes_since_status_ > 0)
+        {
+            for (int i = 0; i < pending_id_count_; i++)
+            {
+                DeviceTiming &timing = getDeviceTiming(pending_ids_[i]);
+                timing.nb_samples = 0;
+                timing.next_sample = 0;
+                timing.late = true;
+            }
+        }
+        pending_id_count_ = 0;
+
+        packet_timeout_ns_ = 0;
         return true;
     }
     return false;
 }
 
-double PortHandlerLinux::getCurrentTimeMs()
+void PortHandlerLinux::setDevicePacketTimeout(uint16_t packet_length, const uint8_t *id_list, int id_count)
+{
+    packet_start_time_ns_ = getCurrentTimeNs();
+    last_status_time_ns_ = packet_start_time_ns_;
+    rx_bytes_since_status_ = 0;
+
+    int64_t return_delay_ns = 0;
+    int64_t margin_ns = 0;
+    pending_id_count_ = 0;
+    for (int i = 0; i < id_count && pending_id_count_ < (int)sizeof(pending_ids_); i++)
+    {
+        pending_ids_[pending_id_count_++] = id_list[i];
+
+        std::map<uint8_t, DeviceTiming>::iterator it = device_timings_.find(id_list[i]);
+        if (it != device_timings_.end())
+            return_delay_ns += it->second.return_delay_ns;
+        margin_ns = std::max(margin_ns, getLatencyMarginNs(id_list[i]));
+    }
+
+    packet_timeout_ns_ = (int64_t)serial_.getByteTimeNs() * packet_length + return_delay_ns + margin_ns;
+}
+
+void PortHandlerLinux::notifyStatusReceived(uint8_t id)
+{
+    if (std::find(pending_ids_, pending_ids_ + pending_id_count_, id) == pending_ids_ + pending_id_count_)
+        return;
+
+    int64_t now_ns = getCurrentTimeNs();
+    std::map<uint8_t, DeviceTiming>::iterator it = device_timings_.find(id);
+    int64_t return_delay_ns = (it != device_timings_.end()) ? it->second.return_delay_ns : 0;
+
+    // status packets of a sync read are received in a row, the latency of each one is counted from the previous one
+    addLatencySample(id, now_ns - last_status_time_ns_ - (int64_t)serial_.getByteTimeNs() * rx_bytes_since_status_ - return_delay_ns);
+
+    last_status_time_ns_ = now_ns;
+    rx_bytes_since_status_ = 0;
+}
+
+void PortHandlerLinux::setReturnDelayTime(uint8_t id, uint32_t return_delay_us) { getDeviceTiming(id).return_delay_ns = (int64_t)return_delay_us * 1000; }
+
+void PortHandlerLinux::clearDeviceTiming(uint8_t id) { device_timings_.erase(id); }
+
+void PortHandlerLinux::setPacketTracer(PacketTracer *tracer) { tracer_ = tracer; }
+
+PortHandlerLinux::DeviceTiming &PortHandlerLinux::getDeviceTiming(uint8_t id)
+{
+    std::map<uint8_t, DeviceTiming>::iterator it = device_timings_.find(id);
+    if (it == device_timings_.end())
+    {
+        DeviceTiming timing;
+        memset(&timing, 0, sizeof(timing));
+        it = device_timings_.insert(std::make_pair(id, timing)).first;
+    }
+
+    return it->second;
+}
+
+int64_t PortHandlerLinux::getLatencyMarginNs(uint8_t id)
+{
+    const int64_t default_margin_ns = getDefaultLatencyMarginNs();
+
+    std::map<uint8_t, DeviceTiming>::iterator it = device_timings_.find(id);
+    if (it != device_timings_.end() && it->second.nb_samples >= LATENCY_MIN_SAMPLES_)
+        return it->second.p99_latency_ns + LATENCY_GUARD_NS;
+
+    if (it != device_timings_.end() && it->second.late)
+        return default_margin_ns;
+
+    // unknown device, or missing one : latency of the other devices of the port, which mostly comes from the adapter
+    int64_t port_p99_latency_ns = -1;
+    for (it = device_timings_.begin(); it != device_timings_.end(); ++it)
+    {
+        if (it->second.nb_samples >= LATENCY_MIN_SAMPLES_)
+            port_p99_latency_ns = std::max(port_p99_latency_ns, it->second.p99_latency_ns);
+    }
+
+    return (port_p99_latency_ns >= 0) ? port_p99_latency_ns + LATENCY_GUARD_NS : default_margin_ns;
+}
+
+void PortHandlerLinux::addLatencySample(uint8_t id, int64_t latency_ns)
+{
+    DeviceTiming &timing = getDeviceTiming(id);
+
+    timing.latency_ns[timing.next_sample] = (uint32_t)std::min<int64_t>(std::max<int64_t>(latency_ns, 0), UINT32_MAX);
+    timing.next_sample = (timing.next_sample + 1) % LATENCY_WINDOW_;
+    if (timing.nb_samples < LATENCY_WINDOW_)
+        timing.nb_samples++;
+
+    // p99 of the window, updated every few samples
+    if (timing.nb_samples >= LATENCY_MIN_SAMPLES_ && timing.next_sample % 8 == 0)
+    {
+        uint32_t latency_ns_sorted[LATENCY_WINDOW_];
+        std::copy(timing.latency_ns, timing.latency_ns + timing.nb_samples, latency_ns_sorted);
+
+        uint32_t *p99 = latency_ns_sorted + (timing.nb_samples * 99) / 100;
+        std::nth_element(latency_ns_sorted, p99, latency_ns_sorted + timing.nb_samples);
+        timing.p99_latency_ns = *p99;
+        timing.late = false;
+    }
+}
+
+bool PortHandlerLinux::setReadMin(int read_min)
+{
+    if (read_min > 255)  // VMIN is a single byte
+        read_min = 255;
+
+    if (read_min == read_min_)
+        return true;
+
+    struct termios options;
+    if (tcgetattr(serial_.getFd(), &options) != 0)
+        return false;
+
+    options.c_cc[VMIN] = static_cast<cc_t>(read_min);
+    options.c_cc[VTIME] = 0;
+    if (tcsetattr(serial_.getFd(), TCSANOW, &options) != 0)
+        return false;
+
+    read_min_ = read_min;
+    return true;
+}
+
+/**
+ * @brief PortHandlerLinux::setLowLatency
+ * Low latency settings of an USB serial adapter. Each step is skipped when the driver
+ * or the permissions do not allow it, the port then keeps working with the settings of the system.
+ */
+void PortHandlerLinux::setLowLatency()
+{
+    low_latency_ = false;
+    latency_timer_ = -1;
+
+    // the port name can be a link, e.g. /dev/serial/by-id/..., the sysfs entry is named after the tty
+    char device_path[PATH_MAX];
+    if (realpath(serial_.getPort().c_str(), device_path) == NULL)
+        return;
+
+    char sysfs_path[PATH_MAX];
+    snprintf(sysfs_path, sizeof(sysfs_path), "/sys/bus/usb-serial/devices/%s", basename(device_path));
+    if (access(sysfs_path, F_OK) != 0)
+        return;  // not an USB serial adapter
+
+    struct serial_struct serial_info;
+    if (ioctl(serial_.getFd(), TIOCGSERIAL, &serial_info) == 0)
+    {
+        serial_info.flags |= ASYNC_LOW_LATENCY;
+        if (ioctl(serial_.getFd(), TIOCSSERIAL, &serial_info) == 0 && ioctl(serial_.getFd(), TIOCGSERIAL, &serial_info) == 0)
+            low_latency_ = (serial_info.flags & ASYNC_LOW_LATENCY) != 0;
+    }
+
+    // latency timer of the FTDI adapters
+    strncat(sysfs_path, "/latency_timer", sizeof(sysfs_path) - strlen(sysfs_path) - 1);
+    FILE *latency_timer_file = fopen(sysfs_path, "w");
+    if (latency_timer_file != NULL)
+    {
+        fprintf(latency_timer_file, "%d", LATENCY_TIMER_TARGET);
+        fclose(latency_timer_file);
+    }
+
+    latency_timer_file = fopen(sysfs_path, "r");
+    if (latency_timer_file != NULL)
+    {
+        int latency_timer = -1;
+        if (fscanf(latency_timer_file, "%d", &latency_timer) == 1 && latency_timer >= 0)
+            latency_timer_ = latency_timer;
+        fclose(latency_timer_file);
+    }
+}
+
+int64_t PortHandlerLinux::getDefaultLatencyMarginNs()
+{
+    int latency_timer = (latency_timer_ >= 0) ? latency_timer_ : LATENCY_TIMER;
+    return (latency_timer * 2 + 2) * 1000000LL;
+}
+
+int64_t PortHandlerLinux::getCurrentTimeNs()
 {
     struct timespec tv;
     clock_gettime(CLOCK_MONOTONIC, &tv);
-    return ((double)tv.tv_sec * 1000.0 + (double)tv.tv_nsec * 0.001 * 0.001);
+    return (int64_t)tv.tv_sec * 1000000000LL + tv.tv_nsec;
 }
 
-double PortHandlerLinux::getTimeSinceStart()
+int64_t PortHandlerLinux::getTimeSinceStartNs()
 {
-    double time = getCurrentTimeMs() - packet_start_time_ms_;
+    int64_t time = getCurrentTimeNs() - packet_start_time_ns_;
 
-    if (time < 0.0)
-        packet_start_time_ms_ = getCurrentTimeMs();
+    if (time < 0)
+        packet_start_time_ns_ = getCurrentTimeNs();
 
     return time;
 }
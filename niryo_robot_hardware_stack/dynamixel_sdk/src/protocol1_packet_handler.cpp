@@ -666,6 +666,10 @@ int Protocol1PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
 
 int Protocol1PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) { return COMM_NOT_AVAILABLE; }
 
+int Protocol1PacketHandler::fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) { return COMM_NOT_AVAILABLE; }
+
+int Protocol1PacketHandler::fastSyncReadRx(PortHandler *port, uint16_t param_length, uint8_t *param) { return COMM_NOT_AVAILABLE; }
+
 int Protocol1PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length)
 {
     int result = COMM_TX_FAIL;
@@ -140,23 +140,42 @@ const char *Protocol2PacketHandler::getRxPacketError(uint8_t error)
     }
 }
 
-unsigned short Protocol2PacketHandler::updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size)
+static const uint16_t crc_table[256] = {
+    0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011, 0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022, 0x8063, 0x0066, 0x006C, 0x8069,
+    0x0078, 0x807D, 0x8077, 0x0072, 0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041, 0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
+    0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1, 0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1, 0x8093, 0x0096, 0x009C, 0x8099,
+    0x0088, 0x808D, 0x8087, 0x0082, 0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192, 0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
+    0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1, 0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2, 0x0140, 0x8145, 0x814F, 0x014A,
+    0x815B, 0x015E, 0x0154, 0x8151, 0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162, 0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
+    0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101, 0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312, 0x0330, 0x8335, 0x833F, 0x033A,
+    0x832B, 0x032E, 0x0324, 0x8321, 0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371, 0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
+    0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1, 0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2, 0x83A3, 0x03A6, 0x03AC, 0x83A9,
+    0x03B8, 0x83BD, 0x83B7, 0x03B2, 0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381, 0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
+    0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2, 0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2, 0x02D0, 0x82D5, 0x82DF, 0x02DA,
+    0x82CB, 0x02CE, 0x02C4, 0x82C1, 0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252, 0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
+    0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202};
+
+// crc_slice_table[k][i] : CRC of the byte i followed by k null bytes, crc_slice_table[0] being crc_table
+struct CrcSliceTable
+{
+    uint16_t table[8][256];
+
+    CrcSliceTable()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            table[0][i] = crc_table[i];
+            for (int k = 1; k < 8; k++)
+                table[k][i] = (uint16_t)(table[k - 1][i] << 8) ^ crc_table[table[k - 1][i] >> 8];
+        }
+    }
+};
+
+static const CrcSliceTable crc_slice_table;
+
+unsigned short Protocol2PacketHandler::updateCRCReference(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size)
 {
     uint16_t i;
-    static const uint16_t crc_table[256] = {
-        0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011, 0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022, 0x8063, 0x0066, 0x006C, 0x8069,
-        0x0078, 0x807D, 0x8077, 0x0072, 0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041, 0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
-        0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1, 0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1, 0x8093, 0x0096, 0x009C, 0x8099,
-        0x0088, 0x808D, 0x8087, 0x0082, 0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192, 0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
-        0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1, 0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2, 0x0140, 0x8145, 0x814F, 0x014A,
-        0x815B, 0x015E, 0x0154, 0x8151, 0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162, 0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
-        0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101, 0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312, 0x0330, 0x8335, 0x833F, 0x033A,
-        0x832B, 0x032E, 0x0324, 0x8321, 0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371, 0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
-        0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1, 0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2, 0x83A3, 0x03A6, 0x03AC, 0x83A9,
-        0x03B8, 0x83BD, 0x83B7, 0x03B2, 0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381, 0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
-        0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2, 0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2, 0x02D0, 0x82D5, 0x82DF, 0x02DA,
-        0x82CB, 0x02CE, 0x02C4, 0x82C1, 0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252, 0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
-        0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202};
 
     for (uint16_t j = 0; j < data_blk_size; j++)
     {
@@ -167,6 +186,20 @@ unsigned short Protocol2PacketHandler::updateCRC(uint16_t crc_accum, uint8_t *da
     return crc_accum;
 }
 
+unsigned short Protocol2PacketHandler::updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size)
+{
+    const uint16_t(*t)[256] = crc_slice_table.table;
+
+    // the CRC only depends on the first two bytes of a slice, the six others are looked up independently
+    for (; data_blk_size >= 8; data_blk_size -= 8, data_blk_ptr += 8)
+    {
+        crc_accum = t[7][(crc_accum >> 8) ^ data_blk_ptr[0]] ^ t[6][(crc_accum & 0xFF) ^ data_blk_ptr[1]] ^ t[5][data_blk_ptr[2]] ^ t[4][data_blk_ptr[3]] ^
+                    t[3][data_blk_ptr[4]] ^ t[2][data_blk_ptr[5]] ^ t[1][data_blk_ptr[6]] ^ t[0][data_blk_ptr[7]];
+    }
+
+    return updateCRCReference(crc_accum, data_blk_ptr, data_blk_size);
+}
+
 void Protocol2PacketHandler::addStuffing(uint8_t *packet)
 {
     int packet_length_in = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]);
@@ -175,38 +208,33 @@ void Protocol2PacketHandler::addStuffing(uint8_t *packet)
     if (packet_length_in < 8)  // INSTRUCTION, ADDR_L, ADDR_H, CRC16_L, CRC16_H + FF FF FD
         return;
 
-    uint8_t *packet_ptr;
-    uint16_t packet_length_before_crc = packet_length_in - 2;
-    for (uint16_t i = 3; i < packet_length_before_crc; i++)
+    // index of the 0xFD of each FF FF FD sequence of the parameters, found by memchr which scans a word at a time
+    uint16_t stuffing_index[TXPACKET_MAX_LEN / 3 + 1];
+    uint16_t stuffing_count = 0;
+
+    uint8_t *data_end = &packet[PKT_INSTRUCTION + packet_length_in - 2];  // CRC
+    uint8_t *packet_ptr = &packet[PKT_PARAMETER0 + 2];
+    while (packet_ptr < data_end && (packet_ptr = (uint8_t *)memchr(packet_ptr, 0xFD, data_end - packet_ptr)) != 0)
     {
-        packet_ptr = &packet[i + PKT_INSTRUCTION - 2];
-        if (packet_ptr[0] == 0xFF && packet_ptr[1] == 0xFF && packet_ptr[2] == 0xFD)
-            packet_length_out++;
+        if (packet_ptr[-1] == 0xFF && packet_ptr[-2] == 0xFF && stuffing_count < sizeof(stuffing_index) / sizeof(stuffing_index[0]))
+            stuffing_index[stuffing_count++] = packet_ptr - packet;
+        packet_ptr++;
     }
 
-    if (packet_length_in == packet_length_out)  // no stuffing required
+    if (stuffing_count == 0)  // no stuffing required
         return;
 
-    uint16_t out_index = packet_length_out + 6 - 2;  // last index before crc
-    uint16_t in_index = packet_length_in + 6 - 2;    // last index before crc
-    while (out_index != in_index)
+    // from the end, every block following a FF FF FD is shifted once by the number of FF FF FD before it
+    uint16_t block_end = data_end - packet;
+    for (uint16_t k = stuffing_count; k > 0; k--)
     {
-        if (packet[in_index] == 0xFD && packet[in_index - 1] == 0xFF && packet[in_index - 2] == 0xFF)
-        {
-            packet[out_index--] = 0xFD;  // byte stuffing
-            if (out_index != in_index)
-            {
-                packet[out_index--] = packet[in_index--];  // FD
-                packet[out_index--] = packet[in_index--];  // FF
-                packet[out_index--] = packet[in_index--];  // FF
-            }
-        }
-        else
-        {
-            packet[out_index--] = packet[in_index--];
-        }
+        uint16_t fd_index = stuffing_index[k - 1];
+        memmove(&packet[fd_index + 1 + k], &packet[fd_index + 1], block_end - fd_index - 1);
+        packet[fd_index + k] = 0xFD;  // byte stuffing
+        block_end = fd_index + 1;
     }
 
+    packet_length_out += stuffing_count;
     packet[PKT_LENGTH_L] = DXL_LOBYTE(packet_length_out);
     packet[PKT_LENGTH_H] = DXL_HIBYTE(packet_length_out);
 
@@ -215,22 +243,35 @@ void Protocol2PacketHandler::addStuffing(uint8_t *packet)
 
 void Protocol2PacketHandler::removeStuffing(uint8_t *packet)
 {
-    int i = 0, index = 0;
     int packet_length_in = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]);
     int packet_length_out = packet_length_in;
 
-    index = PKT_INSTRUCTION;
-    for (i = 0; i < packet_length_in - 2; i++)  // except CRC
+    // FF FF FD FD sequences are searched from their first 0xFD, the packet is only moved after the first one
+    uint8_t *data_end = &packet[PKT_INSTRUCTION + packet_length_in - 2];  // CRC
+    uint8_t *packet_ptr = &packet[PKT_INSTRUCTION];
+    uint8_t *block_begin = packet_ptr;
+    uint8_t *out_ptr = packet_ptr;
+    while (packet_ptr < data_end && (packet_ptr = (uint8_t *)memchr(packet_ptr, 0xFD, data_end - packet_ptr)) != 0)
     {
-        if (packet[i + PKT_INSTRUCTION] == 0xFD && packet[i + PKT_INSTRUCTION + 1] == 0xFD && packet[i + PKT_INSTRUCTION - 1] == 0xFF && packet[i + PKT_INSTRUCTION - 2] == 0xFF)
+        if (packet_ptr + 1 < data_end && packet_ptr[1] == 0xFD && packet_ptr[-1] == 0xFF && packet_ptr[-2] == 0xFF)
         {  // FF FF FD FD
+            if (out_ptr != block_begin)
+                memmove(out_ptr, block_begin, packet_ptr + 1 - block_begin);
+            out_ptr += packet_ptr + 1 - block_begin;
+            block_begin = packet_ptr + 2;
+            packet_ptr += 2;
             packet_length_out--;
-            i++;
         }
-        packet[index++] = packet[i + PKT_INSTRUCTION];
+        else
+        {
+            packet_ptr++;
+        }
     }
-    packet[index++] = packet[PKT_INSTRUCTION + packet_length_in - 2];
-    packet[index++] = packet[PKT_INSTRUCTION + packet_length_in - 1];
+
+    if (packet_length_in == packet_length_out)  // no stuffing
+        return;
+
+    memmove(out_ptr, block_begin, data_end + 2 - block_begin);  // remaining data and CRC
 
     packet[PKT_LENGTH_L] = DXL_LOBYTE(packet_length_out);
     packet[PKT_LENGTH_H] = DXL_HIBYTE(packet_length_out);
@@ -280,7 +321,10 @@ int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
     return COMM_SUCCESS;
 }
 
-int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
+int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket) { return rxPacket(port, rxpacket, false); }
+
+// broadcast_status : accept the status packet with the broadcast ID answering a Fast Sync Read
+int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket, bool broadcast_status)
 {
     int result = COMM_TX_FAIL;
 
@@ -289,7 +333,7 @@ int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
 
     while (true)
     {
-        rx_length += port->readPort(&rxpacket[rx_length], wait_length - rx_length);
+        rx_length += port->readPortBlocking(&rxpacket[rx_length], wait_length - rx_length);
         if (rx_length >= wait_length)
         {
             uint16_t idx = 0;
@@ -303,7 +347,7 @@ int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
 
             if (idx == 0)  // found at the beginning of the packet
             {
-                if (rxpacket[PKT_RESERVED] != 0x00 || rxpacket[PKT_ID] > 0xFC || DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) > RXPACKET_MAX_LEN ||
+                if (rxpacket[PKT_RESERVED] != 0x00 || (rxpacket[PKT_ID] > 0xFC && !(broadcast_status && rxpacket[PKT_ID] == BROADCAST_ID)) || DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) > RXPACKET_MAX_LEN ||
                     rxpacket[PKT_INSTRUCTION] != 0x55)
                 {
                     // remove the first byte in the packet
@@ -388,7 +432,12 @@ int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
     port->is_using_ = false;
 
     if (result == COMM_SUCCESS)
+    {
+        // the devices answering a fast sync read are notified by GroupFastSyncRead, which knows their blocks
+        if (rxpacket[PKT_ID] != BROADCAST_ID)
+            port->notifyStatusReceived(rxpacket[PKT_ID]);
         removeStuffing(rxpacket);
+    }
     else if (result == COMM_RX_TIMEOUT || result == COMM_RX_CORRUPT)
     {
         // Flush data received but not read and clear Port (trying to avoid data block motors)
@@ -428,11 +477,11 @@ int Protocol2PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uin
     }
     else if (txpacket[PKT_INSTRUCTION] == INST_READ)
     {
-        port->setPacketTimeout((uint16_t)(DXL_MAKEWORD(txpacket[PKT_PARAMETER0 + 2], txpacket[PKT_PARAMETER0 + 3]) + 11));
+        port->setDevicePacketTimeout((uint16_t)(DXL_MAKEWORD(txpacket[PKT_PARAMETER0 + 2], txpacket[PKT_PARAMETER0 + 3]) + 11), &txpacket[PKT_ID], 1);
     }
     else
     {
-        port->setPacketTimeout((uint16_t)11);
+        port->setDevicePacketTimeout((uint16_t)11, &txpacket[PKT_ID], 1);
         // HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H
     }
 
@@ -651,7 +700,7 @@ int Protocol2PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 
     // set packet timeout
     if (result == COMM_SUCCESS)
-        port->setPacketTimeout((uint16_t)(length + 11));
+        port->setDevicePacketTimeout((uint16_t)(length + 11), &id, 1);
 
     return result;
 }
@@ -659,7 +708,7 @@ int Protocol2PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 int Protocol2PacketHandler::readRx(PortHandler *port, uint8_t id, uint16_t length, uint8_t *data, uint8_t *error)
 {
     int result = COMM_TX_FAIL;
-    uint8_t *rxpacket = (uint8_t *)malloc(RXPACKET_MAX_LEN);
+    uint8_t *rxpacket = port->getRxPacketBuffer(RXPACKET_MAX_LEN);
     //(length + 11 + (length/3));  // (length/3): consider stuffing
 
     if (rxpacket == NULL)
@@ -682,7 +731,6 @@ int Protocol2PacketHandler::readRx(PortHandler *port, uint8_t id, uint16_t lengt
         // memcpy(data, &rxpacket[PKT_PARAMETER0+1], length);
     }
 
-    free(rxpacket);
     // delete[] rxpacket;
     return result;
 }
@@ -692,7 +740,7 @@ int Protocol2PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
     int result = COMM_TX_FAIL;
 
     uint8_t txpacket[14] = {0};
-    uint8_t *rxpacket = (uint8_t *)malloc(RXPACKET_MAX_LEN);
+    uint8_t *rxpacket = port->getRxPacketBuffer(RXPACKET_MAX_LEN);
     //(length + 11 + (length/3));  // (length/3): consider stuffing
 
     if (rxpacket == NULL)
@@ -700,7 +748,6 @@ int Protocol2PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
 
     if (id >= BROADCAST_ID)
     {
-        free(rxpacket);
         return COMM_NOT_AVAILABLE;
     }
 
@@ -726,7 +773,6 @@ int Protocol2PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
         // memcpy(data, &rxpacket[PKT_PARAMETER0+1], length);
     }
 
-    free(rxpacket);
     // delete[] rxpacket;
     return result;
 }
@@ -789,7 +835,7 @@ int Protocol2PacketHandler::writeTxOnly(PortHandler *port, uint8_t id, uint16_t
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(length + 12 + (length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(length + 12 + (length / 3));
 
     if (txpacket == NULL)
         return result;
@@ -808,7 +854,6 @@ int Protocol2PacketHandler::writeTxOnly(PortHandler *port, uint8_t id, uint16_t
     result = txPacket(port, txpacket);
     port->is_using_ = false;
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -817,7 +862,7 @@ int Protocol2PacketHandler::writeTxRx(PortHandler *port, uint8_t id, uint16_t ad
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(length + 12 + (length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(length + 12 + (length / 3));
     uint8_t rxpacket[RXPACKET_MAX_LEN] = {0};
 
     if (txpacket == NULL)
@@ -836,7 +881,6 @@ int Protocol2PacketHandler::writeTxRx(PortHandler *port, uint8_t id, uint16_t ad
 
     result = txRxPacket(port, txpacket, rxpacket, error, timeout_ms);
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -878,7 +922,7 @@ int Protocol2PacketHandler::regWriteTxOnly(PortHandler *port, uint8_t id, uint16
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(length + 12 + (length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(length + 12 + (length / 3));
 
     if (txpacket == NULL)
         return result;
@@ -897,7 +941,6 @@ int Protocol2PacketHandler::regWriteTxOnly(PortHandler *port, uint8_t id, uint16
     result = txPacket(port, txpacket);
     port->is_using_ = false;
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -906,7 +949,7 @@ int Protocol2PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(length + 12 + (length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(length + 12 + (length / 3));
     uint8_t rxpacket[11] = {0};
 
     if (txpacket == NULL)
@@ -925,7 +968,6 @@ int Protocol2PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
 
     result = txRxPacket(port, txpacket, rxpacket, error);
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -934,7 +976,7 @@ int Protocol2PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(param_length + 14 + (param_length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(param_length + 14 + (param_length / 3));
     // 14: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
 
     if (txpacket == NULL)
@@ -955,9 +997,68 @@ int Protocol2PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address
 
     result = txPacket(port, txpacket);
     if (result == COMM_SUCCESS)
-        port->setPacketTimeout((uint16_t)((11 + data_length) * param_length));
+        port->setDevicePacketTimeout((uint16_t)((11 + data_length) * param_length), param, param_length);
+
+    return result;
+}
+
+int Protocol2PacketHandler::fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length)
+{
+    int result = COMM_TX_FAIL;
+
+    uint8_t *txpacket = port->getTxPacketBuffer(param_length + 14 + (param_length / 3));
+    // 14: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+
+    if (txpacket == NULL)
+        return result;
+
+    txpacket[PKT_ID] = BROADCAST_ID;
+    txpacket[PKT_LENGTH_L] = DXL_LOBYTE(param_length + 7);  // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+    txpacket[PKT_LENGTH_H] = DXL_HIBYTE(param_length + 7);  // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+    txpacket[PKT_INSTRUCTION] = INST_FAST_SYNC_READ;
+    txpacket[PKT_PARAMETER0 + 0] = DXL_LOBYTE(start_address);
+    txpacket[PKT_PARAMETER0 + 1] = DXL_HIBYTE(start_address);
+    txpacket[PKT_PARAMETER0 + 2] = DXL_LOBYTE(data_length);
+    txpacket[PKT_PARAMETER0 + 3] = DXL_HIBYTE(data_length);
+
+    for (uint16_t s = 0; s < param_length; s++)
+        txpacket[PKT_PARAMETER0 + 4 + s] = param[s];
+
+    // a single status packet : HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST + (ERR ID DATA CRC16_L CRC16_H) for each device
+    result = txPacket(port, txpacket);
+    if (result == COMM_SUCCESS)
+        port->setDevicePacketTimeout((uint16_t)(8 + (4 + data_length) * param_length), param, param_length);
+
+    return result;
+}
+
+int Protocol2PacketHandler::fastSyncReadRx(PortHandler *port, uint16_t param_length, uint8_t *param)
+{
+    int result = COMM_TX_FAIL;
+    uint8_t *rxpacket = port->getRxPacketBuffer(RXPACKET_MAX_LEN);
+
+    if (rxpacket == NULL)
+        return result;
+
+    do
+    {
+        result = rxPacket(port, rxpacket, true);
+    } while (result == COMM_SUCCESS && rxpacket[PKT_ID] != BROADCAST_ID);
+
+    if (result == COMM_SUCCESS)
+    {
+        // 3: INST CRC16_L CRC16_H
+        if (DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) != param_length + 3)
+        {
+            result = COMM_RX_CORRUPT;
+        }
+        else
+        {
+            for (uint16_t s = 0; s < param_length; s++)
+                param[s] = rxpacket[PKT_PARAMETER0 + s];
+        }
+    }
 
-    free(txpacket);
     return result;
 }
 
@@ -965,7 +1066,7 @@ int Protocol2PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(param_length + 14 + (param_length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(param_length + 14 + (param_length / 3));
     // 14: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
 
     if (txpacket == NULL)
@@ -986,7 +1087,6 @@ int Protocol2PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
 
     result = txRxPacket(port, txpacket, 0, 0);
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -995,7 +1095,7 @@ int Protocol2PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(param_length + 10 + (param_length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(param_length + 10 + (param_length / 3));
     // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST CRC16_L CRC16_H
 
     if (txpacket == NULL)
@@ -1014,12 +1114,16 @@ int Protocol2PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
     if (result == COMM_SUCCESS)
     {
         int wait_length = 0;
-        for (uint16_t i = 0; i < param_length; i += 5)
+        uint8_t id_list[256];
+        int id_count = 0;
+        for (uint16_t i = 0; i < param_length && id_count < 256; i += 5)
+        {
             wait_length += DXL_MAKEWORD(param[i + 3], param[i + 4]) + 10;
-        port->setPacketTimeout((uint16_t)wait_length);
+            id_list[id_count++] = param[i];
+        }
+        port->setDevicePacketTimeout((uint16_t)wait_length, id_list, id_count);
     }
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
@@ -1028,7 +1132,7 @@ int Protocol2PacketHandler::bulkWriteTxOnly(PortHandler *port, uint8_t *param, u
 {
     int result = COMM_TX_FAIL;
 
-    uint8_t *txpacket = (uint8_t *)malloc(param_length + 10 + (param_length / 3));
+    uint8_t *txpacket = port->getTxPacketBuffer(param_length + 10 + (param_length / 3));
     // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST CRC16_L CRC16_H
 
     if (txpacket == NULL)
@@ -1045,7 +1149,6 @@ int Protocol2PacketHandler::bulkWriteTxOnly(PortHandler *port, uint8_t *param, u
 
     result = txRxPacket(port, txpacket, 0, 0);
 
-    free(txpacket);
     // delete[] txpacket;
     return result;
 }
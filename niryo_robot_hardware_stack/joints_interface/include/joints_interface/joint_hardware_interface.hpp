@@ -36,6 +36,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "can_driver/can_interface_core.hpp"
 #include "ttl_driver/ttl_interface_core.hpp"
 #include "common/model/joint_state.hpp"
+#include "common/model/joint_states_snapshot.hpp"
 
 namespace joints_interface
 {
@@ -33,6 +33,9 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include <ros/ros.h>
 
 #include "common/util/i_interface_core.hpp"
+#include "common/util/loop_metrics.hpp"
+#include "common/util/loop_timer.hpp"
+#include "common/util/rt_thread_config.hpp"
 
 #include <controller_manager/controller_manager.h>
 #include <control_msgs/FollowJointTrajectoryActionResult.h>
@@ -45,6 +48,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "niryo_robot_msgs/SetInt.h"
 #include "niryo_robot_msgs/SetBool.h"
 #include "niryo_robot_msgs/CommandStatus.h"
+#include "niryo_robot_msgs/LoopMetrics.h"
 #include "niryo_robot_msgs/Trigger.h"
 #include "common/model/hardware_type_enum.hpp"
 
@@ -96,6 +100,7 @@ class JointsInterfaceCore : common::util::IInterfaceCore
         void _callbackTrajectoryResult(const control_msgs::FollowJointTrajectoryActionResult& msg);
 
         void _publishLearningMode();
+        void _publishLoopMetrics(const ros::TimerEvent &);
 
     private:
         ros::NodeHandle _nh;
@@ -113,10 +118,18 @@ class JointsInterfaceCore : common::util::IInterfaceCore
         std::shared_ptr<can_driver::CanInterfaceCore> _can_interface;
 
         std::thread _control_loop_thread;
-        ros::Rate _control_loop_rate{1.0};
+        common::util::LoopTimer _control_loop_timer{1.0};
+        common::util::RtThreadConfig _control_loop_rt_config;
 
         ros::Publisher _learning_mode_publisher;
 
+        ros::Publisher _loop_metrics_publisher;
+        ros::Timer _loop_metrics_publisher_timer;
+        ros::Duration _loop_metrics_publisher_duration{1.0};
+
+        // stages of the control loop: READ and WRITE the hardware interface, STATUS the collision check, UPDATE the controllers
+        common::util::LoopMetrics _loop_metrics{"ros_control_loop"};
+
         ros::Subscriber _trajectory_result_subscriber;
 
         ros::ServiceServer _reset_controller_server; // workaround to compensate missed steps
@@ -432,15 +432,31 @@ bool JointHardwareInterface::initDxlState(ros::NodeHandle &robot_hwnh, const std
 /**
  * @brief JointHardwareInterface::read
  * Reads the current state of the robot and update pos and vel of
+ * Positions are taken from the snapshots published by the bus threads, so that all joints of a bus come from the same read cycle
  */
 void JointHardwareInterface::read(const ros::Time & /*time*/, const ros::Duration & /*period*/)
 {
+    const common::model::JointStatesSnapshot *can_states = _can_interface ? &_can_interface->getJointStatesSnapshot() : nullptr;
+    const common::model::JointStatesSnapshot *ttl_states = _ttl_interface ? &_ttl_interface->getJointStatesSnapshot() : nullptr;
+
     for (auto &jState : _joint_state_list)
     {
         if (jState && jState->isValid())
         {
-            jState->pos = jState->to_rad_pos(jState->getPosition());
-            // jState->vel = jState->to_rad_vel(jState->getVelocity());
+            const common::model::JointStateSample *sample = nullptr;
+
+            if (can_states && jState->getBusProtocol() == EBusProtocol::CAN)
+                sample = can_states->find(jState->getId());
+            if (ttl_states && jState->getBusProtocol() == EBusProtocol::TTL)
+                sample = ttl_states->find(jState->getId());
+
+            // joint not read yet : keep its last position
+            if (sample)
+            {
+                jState->pos = jState->to_rad_pos(sample->position);
+                jState->vel = jState->to_rad_vel(sample->velocity);
+                jState->eff = jState->to_effort(sample->load);
+            }
         }
     }
 
@@ -453,25 +469,25 @@ void JointHardwareInterface::read(const ros::Time & /*time*/, const ros::Duratio
  */
 void JointHardwareInterface::write(const ros::Time & /*time*/, const ros::Duration & /*period*/)
 {
-    std::vector<std::pair<uint8_t, int32_t>> can_cmd;
-    std::vector<std::pair<uint8_t, uint32_t>> ttl_cmd;
+    common::model::CanJointTrajectoryCmd can_cmd;
+    common::model::TtlJointTrajectoryCmd ttl_cmd;
 
     for (auto const &jState : _joint_state_list)
     {
         if (jState && jState->isValid())
         {
             if (jState->getBusProtocol() == EBusProtocol::CAN)
-                can_cmd.emplace_back(jState->getId(), jState->to_motor_pos(jState->cmd));
+                can_cmd.push_back(std::make_pair(jState->getId(), static_cast<int32_t>(jState->to_motor_pos(jState->cmd))));
             if (jState->getBusProtocol() == EBusProtocol::TTL)
-                ttl_cmd.emplace_back(jState->getId(), jState->to_motor_pos(jState->cmd));
+                ttl_cmd.push_back(std::make_pair(jState->getId(), static_cast<uint32_t>(jState->to_motor_pos(jState->cmd))));
         }
     }
 
     if (_can_interface)
-        _can_interface->setTrajectoryControllerCommands(std::move(can_cmd));
+        _can_interface->setTrajectoryControllerCommands(can_cmd);
 
     if (_ttl_interface)
-        _ttl_interface->setTrajectoryControllerCommands(std::move(ttl_cmd));
+        _ttl_interface->setTrajectoryControllerCommands(ttl_cmd);
 }
 
 /**
@@ -26,6 +26,8 @@
 #include "common/util/util_defs.hpp"
 #include "joints_interface/joints_interface_core.hpp"
 
+using ::common::util::ELoopStage;
+
 namespace joints_interface
 {
 
@@ -101,10 +103,12 @@ void JointsInterfaceCore::initParameters(ros::NodeHandle &nh)
     nh.getParam("/niryo_robot_hardware_interface/hardware_version", _hardware_version);
     nh.getParam("simulation_mode", _simulation_mode);
 
+    _control_loop_rt_config.readParameters(nh, "ros_control_loop_rt");
+
     ROS_DEBUG("JointsInterfaceCore::initParams - Ros control loop frequency %f", control_loop_frequency);
     ROS_DEBUG("Joint Hardware Interface - hardware_version %s", _hardware_version.c_str());
 
-    _control_loop_rate = ros::Rate(control_loop_frequency);
+    _control_loop_timer.setPeriod(1.0 / control_loop_frequency);
 }
 
 /**
@@ -130,6 +134,9 @@ void JointsInterfaceCore::startPublishers(ros::NodeHandle &nh)
 {
     _learning_mode_publisher = nh.advertise<std_msgs::Bool>("/niryo_robot/learning_mode/state", 10, true);
     _publishLearningMode();
+
+    _loop_metrics_publisher = nh.advertise<niryo_robot_msgs::LoopMetrics>("loop_metrics", 1);
+    _loop_metrics_publisher_timer = nh.createTimer(_loop_metrics_publisher_duration, &JointsInterfaceCore::_publishLoopMetrics, this);
 }
 
 /**
@@ -222,15 +229,26 @@ bool JointsInterfaceCore::rebootAll(bool torque_on)
  */
 void JointsInterfaceCore::rosControlLoop()
 {
+    std::string thread_settings = _control_loop_rt_config.apply();
+    ROS_INFO("JointsInterfaceCore::rosControlLoop - thread settings : %s", thread_settings.c_str());
+    _loop_metrics.setThreadSettings(thread_settings);
+
     ros::Time last_time = ros::Time::now();
     ros::Time current_time = ros::Time::now();
     ros::Duration elapsed_time;
 
+    // the loop wakes up on monotonic deadlines, the controllers are still given ros time
+    _control_loop_timer.reset();
+    _loop_metrics.setExpectedPeriod(_control_loop_timer.getPeriod());
+
     while (ros::ok())
     {
         if (_enable_control_loop)
         {
+            _loop_metrics.startCycle();
+
             _robot->read(current_time, elapsed_time);
+            _loop_metrics.endStage(ELoopStage::READ);
 
             // check if a collision is occurred, reset controller to stop robot
             if (_ttl_interface->getCollisionStatus() && !_previous_state_learning_mode && !_robot->needCalibration())
@@ -240,6 +258,7 @@ void JointsInterfaceCore::rosControlLoop()
             }
             else
                 _lock_write_cnt = -1;
+            _loop_metrics.endStage(ELoopStage::STATUS);
 
             current_time = ros::Time::now();
             elapsed_time = ros::Duration(current_time - last_time);
@@ -256,6 +275,7 @@ void JointsInterfaceCore::rosControlLoop()
             {
                 _cm->update(ros::Time::now(), elapsed_time, false);
             }
+            _loop_metrics.endStage(ELoopStage::UPDATE);
 
             // we just use cmd from moveit only in torque on + calibration finished
             if (!_previous_state_learning_mode && _lock_write_cnt == -1 && !_robot->needCalibration())
@@ -271,9 +291,17 @@ void JointsInterfaceCore::rosControlLoop()
                 _lock_write_cnt = -1;
                 _reset_controller = true;
             }
-            bool isFreqMet = _control_loop_rate.sleep();
-            ROS_DEBUG_COND(!isFreqMet, "JointsInterfaceCore::rosControlLoop : freq not met : expected (%f s) vs actual (%f s)", _control_loop_rate.expectedCycleTime().toSec(),
-                           _control_loop_rate.cycleTime().toSec());
+            _loop_metrics.endStage(ELoopStage::WRITE);
+            _loop_metrics.endCycle();
+
+            bool isFreqMet = _control_loop_timer.sleep();
+            ROS_DEBUG_COND(!isFreqMet, "JointsInterfaceCore::rosControlLoop : freq not met : expected (%f s), woke up %f s late", _control_loop_timer.getPeriod(),
+                           _control_loop_timer.getWakeUpTime() - _control_loop_timer.getCycleTime());
+        }
+        else
+        {
+            _loop_metrics.pause();
+            _control_loop_timer.reset();
         }
     }
 }
@@ -431,4 +459,14 @@ void JointsInterfaceCore::_publishLearningMode()
     _learning_mode_publisher.publish(msg);
 }
 
+/**
+ * @brief JointsInterfaceCore::_publishLoopMetrics : period, execution time and wake-up latency of the ros control loop
+ */
+void JointsInterfaceCore::_publishLoopMetrics(const ros::TimerEvent &)
+{
+    niryo_robot_msgs::LoopMetrics msg = _loop_metrics.getMsg();
+    msg.header.stamp = ros::Time::now();
+    _loop_metrics_publisher.publish(msg);
+}
+
 }  // namespace joints_interface
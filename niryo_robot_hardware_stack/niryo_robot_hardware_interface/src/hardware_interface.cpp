@@ -184,6 +184,14 @@ void HardwareInterface::initNodes(ros::NodeHandle &nh)
     ros::NodeHandle nh_conveyor(nh, "conveyor");
     _conveyor_interface = std::make_shared<conveyor_interface::ConveyorInterfaceCore>(nh_conveyor, _ttl_interface, _can_interface);
     ros::Duration(0.25).sleep();
+
+    // every device of the bus is known now : final baud rate, then rates of the control loop for this set of devices
+    if (_ttl_interface)
+    {
+        if (_ttl_interface->isBaudRateNegotiable())
+            _ttl_interface->negotiateBaudRate();
+        _ttl_interface->calibrateBusRates();
+    }
 }
 
 /**
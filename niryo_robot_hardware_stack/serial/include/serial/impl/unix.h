@@ -126,6 +126,8 @@ class serial::Serial::SerialImpl
 
     uint32_t getByteTimeNs() const;
 
+    int getFd() const;
+
     void setBytesize(bytesize_t bytesize);
 
     bytesize_t getBytesize() const;
@@ -481,6 +481,12 @@ class Serial
      */
     uint32_t getByteTimeNs() const;
 
+    /*! Gets the file descriptor of the serial port, to wait for its events.
+     *
+     * \return The file descriptor, -1 if the port is not open.
+     */
+    int getFd() const;
+
     /*! Sets the bytesize for the serial port.
      *
      * \param bytesize Size of each byte in the serial transmission of data,
@@ -756,6 +756,12 @@ Serial::SerialImpl::getByteTimeNs() const
     return byte_time_ns_;
 }
 
+int
+Serial::SerialImpl::getFd() const
+{
+    return is_open_ ? fd_ : -1;
+}
+
 void
 Serial::SerialImpl::setBytesize (serial::bytesize_t bytesize)
 {
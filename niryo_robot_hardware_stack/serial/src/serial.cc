@@ -325,6 +325,12 @@ Serial::getByteTimeNs() const
     return pimpl_->getByteTimeNs();
 }
 
+int
+Serial::getFd() const
+{
+    return pimpl_->getFd();
+}
+
 void
 Serial::setBytesize (bytesize_t bytesize)
 {
@@ -0,0 +1,141 @@
+/*
+ttl_capture.h
+Copyright (C) 2024 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TTL_DEBUG_TOOLS_TTL_CAPTURE_H
+#define TTL_DEBUG_TOOLS_TTL_CAPTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+namespace ttl_debug_tools
+{
+
+/**
+ * @brief The CaptureRecord struct : bytes written or read in a single call on the port
+ */
+struct CaptureRecord
+{
+    int64_t timestamp_ns{0};
+    uint8_t direction{dynamixel::PacketTracer::DIRECTION_TX_};
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief The Frame struct : protocol 2.0 packet found in the capture
+ */
+struct Frame
+{
+    int64_t timestamp_ns{0};  // record holding the last byte of the packet
+    uint8_t direction{dynamixel::PacketTracer::DIRECTION_TX_};
+    uint8_t id{0};
+    uint8_t instruction{0};
+    uint8_t error{0};             // status packets only
+    std::vector<uint8_t> params;  // byte stuffing removed, without the error of the status packets
+    std::vector<uint8_t> bytes;   // whole packet, as on the bus
+    bool crc_ok{false};
+};
+
+/**
+ * @brief The Transaction struct : instruction packet and the status packets received until the next instruction
+ */
+struct Transaction
+{
+    Frame instruction;
+    std::vector<Frame> status_list;
+    size_t expected_status_count{0};  // 0 when it depends on the status return level of the devices (writes)
+    int64_t latency_ns{-1};           // from the instruction to the end of the last status packet
+    int result{COMM_SUCCESS};         // COMM_RX_TIMEOUT if a status packet is missing, COMM_RX_CORRUPT if a CRC is wrong
+    uint8_t error{0};                 // errors of the status packets
+};
+
+/**
+ * @brief The TtlCapture class : reads and decodes the capture files of dynamixel::PacketTracer
+ */
+class TtlCapture
+{
+  public:
+    TtlCapture() = default;
+
+    bool load(const std::string &file_name);
+
+    const std::vector<CaptureRecord> &getRecords() const;
+    uint64_t getDroppedCount() const;
+
+    std::vector<Transaction> decode() const;
+
+    static std::string instructionName(uint8_t instruction);
+    static std::string toString(const Transaction &transaction, int64_t start_time_ns);
+
+  private:
+    static void parseFrames(std::vector<uint8_t> &buffer, int64_t timestamp_ns, uint8_t direction, std::vector<Frame> &frames);
+    static size_t expectedStatusCount(const Frame &instruction);
+
+    std::vector<CaptureRecord> _records;
+    uint64_t _dropped_count{0};
+};
+
+/**
+ * @brief The ReplayPortHandler class : port answering with the bytes received in a capture
+ * Each write on the port is matched with the next instruction of the capture,
+ * and the bytes received after it are given back to the reads. Nothing is ever waited.
+ * Used to run the packet handler and the drivers offline on a capture.
+ */
+class ReplayPortHandler : public dynamixel::PortHandler
+{
+  public:
+    explicit ReplayPortHandler(std::vector<CaptureRecord> records);
+
+    size_t getMismatchCount() const;
+    bool isFinished() const;
+
+    // dynamixel::PortHandler interface
+    void gpioHigh() override {}
+    void gpioLow() override {}
+    bool openPort() override { return true; }
+    void closePort() override {}
+    void clearPort() override;
+    void flushInput() override { clearPort(); }
+    void setPortName(const char * /*port_name*/) override {}
+    const char *getPortName() override { return "replay"; }
+    bool setBaudRate(const int baudrate) override;
+    int getBaudRate() override;
+    int getBytesAvailable() override;
+    int readPort(uint8_t *packet, int length) override;
+    int writePort(uint8_t *packet, int length) override;
+    void setPacketTimeout(uint16_t /*packet_length*/) override {}
+    void setPacketTimeout(double /*msec*/) override {}
+    bool isPacketTimeout() override { return true; }
+
+  private:
+    std::vector<CaptureRecord> _records;
+    size_t _next_record{0};
+
+    std::vector<uint8_t> _rx;
+    size_t _rx_pos{0};
+
+    size_t _mismatch_count{0};
+    int _baudrate{1000000};
+};
+
+}  // namespace ttl_debug_tools
+
+#endif  // TTL_DEBUG_TOOLS_TTL_CAPTURE_H
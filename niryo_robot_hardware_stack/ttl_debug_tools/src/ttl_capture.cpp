@@ -0,0 +1,421 @@
+/*
+    ttl_capture.cpp
+    Copyright (C) 2024 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dynamixel_sdk/protocol2_packet_handler.h"
+#include "ttl_debug_tools/ttl_capture.h"
+
+namespace ttl_debug_tools
+{
+
+// HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H
+static constexpr size_t PACKET_HEADER_SIZE = 7;
+
+/**
+ * @brief TtlCapture::load
+ * @param file_name : capture file written by dynamixel::PacketTracer
+ * @return false if the file can not be read or is not a capture file
+ */
+bool TtlCapture::load(const std::string &file_name)
+{
+    _records.clear();
+    _dropped_count = 0;
+
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, sizeof(magic)) || 0 != std::memcmp(magic, dynamixel::PacketTracer::CAPTURE_MAGIC_, sizeof(magic)))
+        return false;
+
+    uint8_t header[dynamixel::PacketTracer::RECORD_HEADER_LEN_];
+    while (file.read(reinterpret_cast<char *>(header), sizeof(header)))
+    {
+        CaptureRecord record;
+        for (int b = 0; b < 8; ++b)
+            record.timestamp_ns |= static_cast<int64_t>(header[b]) << (8 * b);
+        record.direction = header[8];
+        record.data.resize(DXL_MAKEWORD(header[9], header[10]));
+
+        // truncated record, when the capture was not stopped
+        if (!file.read(reinterpret_cast<char *>(record.data.data()), static_cast<std::streamsize>(record.data.size())))
+            break;
+
+        if (dynamixel::PacketTracer::DIRECTION_DROPPED_ == record.direction && record.data.size() == 4)
+            _dropped_count += DXL_MAKEDWORD(DXL_MAKEWORD(record.data[0], record.data[1]), DXL_MAKEWORD(record.data[2], record.data[3]));
+
+        _records.emplace_back(std::move(record));
+    }
+
+    return true;
+}
+
+/**
+ * @brief TtlCapture::getRecords
+ * @return
+ */
+const std::vector<CaptureRecord> &TtlCapture::getRecords() const { return _records; }
+
+/**
+ * @brief TtlCapture::getDroppedCount
+ * @return number of records dropped by the tracer
+ */
+uint64_t TtlCapture::getDroppedCount() const { return _dropped_count; }
+
+/**
+ * @brief TtlCapture::decode : packets of the capture, grouped in transactions
+ * @return
+ */
+std::vector<Transaction> TtlCapture::decode() const
+{
+    std::vector<Frame> frames;
+    std::vector<uint8_t> tx_buffer;
+    std::vector<uint8_t> rx_buffer;
+
+    for (auto const &record : _records)
+    {
+        if (dynamixel::PacketTracer::DIRECTION_TX_ == record.direction)
+        {
+            tx_buffer.insert(tx_buffer.end(), record.data.begin(), record.data.end());
+            parseFrames(tx_buffer, record.timestamp_ns, record.direction, frames);
+        }
+        else if (dynamixel::PacketTracer::DIRECTION_RX_ == record.direction)
+        {
+            rx_buffer.insert(rx_buffer.end(), record.data.begin(), record.data.end());
+            parseFrames(rx_buffer, record.timestamp_ns, record.direction, frames);
+        }
+        else
+        {
+            // bytes are missing, the packets in progress can not be completed
+            tx_buffer.clear();
+            rx_buffer.clear();
+        }
+    }
+
+    std::vector<Transaction> transactions;
+    for (auto &frame : frames)
+    {
+        if (dynamixel::PacketTracer::DIRECTION_TX_ == frame.direction)
+        {
+            Transaction transaction;
+            transaction.expected_status_count = expectedStatusCount(frame);
+            transaction.instruction = std::move(frame);
+            transactions.emplace_back(std::move(transaction));
+        }
+        else if (!transactions.empty())
+        {
+            // status packets received before the first instruction are ignored
+            transactions.back().status_list.emplace_back(std::move(frame));
+        }
+    }
+
+    for (auto &transaction : transactions)
+    {
+        if (!transaction.status_list.empty())
+            transaction.latency_ns = transaction.status_list.back().timestamp_ns - transaction.instruction.timestamp_ns;
+
+        for (auto const &status : transaction.status_list)
+        {
+            transaction.error |= status.error;
+            if (!status.crc_ok)
+                transaction.result = COMM_RX_CORRUPT;
+        }
+
+        if (COMM_SUCCESS == transaction.result && transaction.status_list.size() < transaction.expected_status_count)
+            transaction.result = COMM_RX_TIMEOUT;
+    }
+
+    return transactions;
+}
+
+/**
+ * @brief TtlCapture::parseFrames : extracts the complete packets at the beginning of the buffer
+ * @param buffer : bytes of one direction, the bytes of the packets extracted are removed
+ * @param timestamp_ns
+ * @param direction
+ * @param frames
+ */
+void TtlCapture::parseFrames(std::vector<uint8_t> &buffer, int64_t timestamp_ns, uint8_t direction, std::vector<Frame> &frames)
+{
+    auto packet_handler = static_cast<dynamixel::Protocol2PacketHandler *>(dynamixel::PacketHandler::getPacketHandler(2.0));
+
+    size_t pos = 0;
+    while (true)
+    {
+        // bytes before a header are noise
+        while (pos + 4 <= buffer.size() && !(0xFF == buffer[pos] && 0xFF == buffer[pos + 1] && 0xFD == buffer[pos + 2] && 0x00 == buffer[pos + 3]))
+            ++pos;
+
+        if (pos + PACKET_HEADER_SIZE > buffer.size())
+            break;
+
+        size_t packet_size = PACKET_HEADER_SIZE + DXL_MAKEWORD(buffer[pos + 5], buffer[pos + 6]);
+        if (packet_size < PACKET_HEADER_SIZE + 3)
+        {
+            // INST CRC_L CRC_H at least
+            pos += 4;
+            continue;
+        }
+        if (pos + packet_size > buffer.size())
+            break;
+
+        Frame frame;
+        frame.timestamp_ns = timestamp_ns;
+        frame.direction = direction;
+        frame.id = buffer[pos + 4];
+        frame.instruction = buffer[pos + 7];
+        frame.bytes.assign(buffer.begin() + static_cast<std::ptrdiff_t>(pos), buffer.begin() + static_cast<std::ptrdiff_t>(pos + packet_size));
+
+        uint16_t crc = packet_handler->updateCRC(0, frame.bytes.data(), static_cast<uint16_t>(packet_size - 2));
+        frame.crc_ok = (DXL_MAKEWORD(frame.bytes[packet_size - 2], frame.bytes[packet_size - 1]) == crc);
+
+        // byte stuffing : 0xFD is added after each 0xFF 0xFF 0xFD of the parameters
+        for (size_t i = PACKET_HEADER_SIZE + 1; i < packet_size - 2; ++i)
+        {
+            size_t count = frame.params.size();
+            if (count >= 3 && 0xFD == frame.bytes[i] && 0xFD == frame.params[count - 1] && 0xFF == frame.params[count - 2] && 0xFF == frame.params[count - 3])
+            {
+                if (i + 1 < packet_size - 2)
+                    frame.params.push_back(frame.bytes[++i]);
+                continue;
+            }
+            frame.params.push_back(frame.bytes[i]);
+        }
+
+        if (INST_STATUS == frame.instruction && !frame.params.empty())
+        {
+            frame.error = frame.params.front();
+            frame.params.erase(frame.params.begin());
+        }
+
+        frames.emplace_back(std::move(frame));
+        pos += packet_size;
+    }
+
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+}
+
+/**
+ * @brief TtlCapture::expectedStatusCount
+ * @param instruction
+ * @return number of status packets answered to the instruction, 0 if it depends on the status return level
+ */
+size_t TtlCapture::expectedStatusCount(const Frame &instruction)
+{
+    switch (instruction.instruction)
+    {
+    case INST_PING:
+    case INST_READ:
+        return (BROADCAST_ID == instruction.id) ? 0 : 1;
+    case INST_SYNC_READ:
+        // ADDR(2) LEN(2) ID(1) ...
+        return instruction.params.size() > 4 ? instruction.params.size() - 4 : 0;
+    case INST_FAST_SYNC_READ:
+        return 1;
+    case INST_BULK_READ:
+        // ID(1) ADDR(2) LEN(2) for each device
+        return instruction.params.size() / 5;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief TtlCapture::instructionName
+ * @param instruction
+ * @return
+ */
+std::string TtlCapture::instructionName(uint8_t instruction)
+{
+    switch (instruction)
+    {
+    case INST_PING:
+        return "PING";
+    case INST_READ:
+        return "READ";
+    case INST_WRITE:
+        return "WRITE";
+    case INST_REG_WRITE:
+        return "REG_WRITE";
+    case INST_ACTION:
+        return "ACTION";
+    case INST_FACTORY_RESET:
+        return "FACTORY_RESET";
+    case INST_REBOOT:
+        return "REBOOT";
+    case INST_CLEAR:
+        return "CLEAR";
+    case INST_STATUS:
+        return "STATUS";
+    case INST_SYNC_READ:
+        return "SYNC_READ";
+    case INST_SYNC_WRITE:
+        return "SYNC_WRITE";
+    case INST_FAST_SYNC_READ:
+        return "FAST_SYNC_READ";
+    case INST_BULK_READ:
+        return "BULK_READ";
+    case INST_BULK_WRITE:
+        return "BULK_WRITE";
+    default:
+        return "INST_" + std::to_string(instruction);
+    }
+}
+
+/**
+ * @brief TtlCapture::toString
+ * @param transaction
+ * @param start_time_ns : time origin of the capture
+ * @return one line description of the transaction
+ */
+std::string TtlCapture::toString(const Transaction &transaction, int64_t start_time_ns)
+{
+    char line[256];
+    int size = snprintf(line, sizeof(line), "[%12.3f ms] %-14s id %3d, %3zu param bytes -> %zu status", (transaction.instruction.timestamp_ns - start_time_ns) / 1e6,
+                        instructionName(transaction.instruction.instruction).c_str(), transaction.instruction.id, transaction.instruction.params.size(),
+                        transaction.status_list.size());
+    std::string description(line, static_cast<size_t>(std::max(size, 0)));
+
+    if (transaction.expected_status_count > 0)
+        description += " / " + std::to_string(transaction.expected_status_count);
+
+    if (transaction.latency_ns >= 0)
+    {
+        snprintf(line, sizeof(line), ", latency %.3f ms", transaction.latency_ns / 1e6);
+        description += line;
+    }
+    if (transaction.error)
+    {
+        snprintf(line, sizeof(line), ", device error 0x%02X", transaction.error);
+        description += line;
+    }
+    if (COMM_RX_TIMEOUT == transaction.result)
+        description += ", TIMEOUT";
+    else if (COMM_RX_CORRUPT == transaction.result)
+        description += ", CORRUPT";
+    if (!transaction.instruction.crc_ok)
+        description += ", instruction CRC error";
+
+    return description;
+}
+
+/**
+ * @brief ReplayPortHandler::ReplayPortHandler
+ * @param records
+ */
+ReplayPortHandler::ReplayPortHandler(std::vector<CaptureRecord> records) : _records(std::move(records)) { is_using_ = false; }
+
+/**
+ * @brief ReplayPortHandler::getMismatchCount
+ * @return number of writes different from the instructions of the capture
+ */
+size_t ReplayPortHandler::getMismatchCount() const { return _mismatch_count; }
+
+/**
+ * @brief ReplayPortHandler::isFinished
+ * @return true when every record of the capture has been replayed
+ */
+bool ReplayPortHandler::isFinished() const { return _next_record >= _records.size(); }
+
+/**
+ * @brief ReplayPortHandler::clearPort
+ */
+void ReplayPortHandler::clearPort()
+{
+    _rx.clear();
+    _rx_pos = 0;
+}
+
+/**
+ * @brief ReplayPortHandler::setBaudRate
+ * @param baudrate
+ * @return
+ */
+bool ReplayPortHandler::setBaudRate(const int baudrate)
+{
+    _baudrate = baudrate;
+    return true;
+}
+
+/**
+ * @brief ReplayPortHandler::getBaudRate
+ * @return
+ */
+int ReplayPortHandler::getBaudRate() { return _baudrate; }
+
+/**
+ * @brief ReplayPortHandler::getBytesAvailable
+ * @return
+ */
+int ReplayPortHandler::getBytesAvailable() { return static_cast<int>(_rx.size() - _rx_pos); }
+
+/**
+ * @brief ReplayPortHandler::readPort
+ * @param packet
+ * @param length
+ * @return number of bytes read
+ */
+int ReplayPortHandler::readPort(uint8_t *packet, int length)
+{
+    int count = 0;
+    while (count < length && _rx_pos < _rx.size())
+        packet[count++] = _rx[_rx_pos++];
+
+    return count;
+}
+
+/**
+ * @brief ReplayPortHandler::writePort : queues the bytes received after the next instruction of the capture
+ * @param packet
+ * @param length
+ * @return
+ */
+int ReplayPortHandler::writePort(uint8_t *packet, int length)
+{
+    clearPort();
+
+    while (_next_record < _records.size() && dynamixel::PacketTracer::DIRECTION_TX_ != _records[_next_record].direction)
+        ++_next_record;
+
+    if (_next_record >= _records.size())
+    {
+        ++_mismatch_count;
+        return length;
+    }
+
+    const std::vector<uint8_t> &instruction = _records[_next_record++].data;
+    if (instruction.size() != static_cast<size_t>(length) || !std::equal(instruction.begin(), instruction.end(), packet))
+        ++_mismatch_count;
+
+    for (; _next_record < _records.size() && dynamixel::PacketTracer::DIRECTION_TX_ != _records[_next_record].direction; ++_next_record)
+    {
+        if (dynamixel::PacketTracer::DIRECTION_RX_ == _records[_next_record].direction)
+            _rx.insert(_rx.end(), _records[_next_record].data.begin(), _records[_next_record].data.end());
+    }
+
+    return length;
+}
+
+}  // namespace ttl_debug_tools
@@ -21,6 +21,7 @@
 #include <boost/program_options.hpp>
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/value_semantic.hpp>
+#include <algorithm>
 #include <chrono>  // NOLINT
 #include <cstddef>
 #include <cstdint>
@@ -33,6 +34,7 @@
 
 // niryo
 #include "dynamixel_sdk/dynamixel_sdk.h"
+#include "ttl_debug_tools/ttl_capture.h"
 #include "ttl_debug_tools/ttl_tools.h"
 
 #define PROTOCOL_VERSION 2.0
@@ -57,6 +59,111 @@ namespace po = boost::program_options;
 #define DEFAULT_PORT ""
 #endif
 
+/**
+ * @brief decodeCapture : prints the transactions of a capture of the bus, with their latency and errors
+ * @param file_name
+ * @return
+ */
+int decodeCapture(const std::string &file_name)
+{
+    ttl_debug_tools::TtlCapture capture;
+    if (!capture.load(file_name))
+    {
+        printf("ERROR: %s is not a capture file\n", file_name.c_str());
+        return 1;
+    }
+
+    std::vector<ttl_debug_tools::Transaction> transactions = capture.decode();
+    if (transactions.empty())
+    {
+        printf("No transaction in %s\n", file_name.c_str());
+        return 0;
+    }
+
+    int64_t start_time_ns = transactions.front().instruction.timestamp_ns;
+    size_t timeout_count = 0;
+    size_t corrupt_count = 0;
+    size_t error_count = 0;
+    size_t latency_count = 0;
+    int64_t latency_sum_ns = 0;
+    int64_t latency_max_ns = 0;
+
+    for (auto const &transaction : transactions)
+    {
+        std::cout << ttl_debug_tools::TtlCapture::toString(transaction, start_time_ns) << "\n";
+
+        timeout_count += (COMM_RX_TIMEOUT == transaction.result) ? 1 : 0;
+        corrupt_count += (COMM_RX_CORRUPT == transaction.result) ? 1 : 0;
+        error_count += transaction.error ? 1 : 0;
+        if (transaction.latency_ns >= 0)
+        {
+            latency_count++;
+            latency_sum_ns += transaction.latency_ns;
+            latency_max_ns = std::max(latency_max_ns, transaction.latency_ns);
+        }
+    }
+
+    printf("--> %zu transactions, %zu timeouts, %zu corrupted, %zu with a device error, %lu records dropped by the tracer\n", transactions.size(), timeout_count,
+           corrupt_count, error_count, static_cast<unsigned long>(capture.getDroppedCount()));
+    if (latency_count)
+        printf("--> latency : mean %.3f ms, max %.3f ms\n", static_cast<double>(latency_sum_ns) / latency_count / 1e6, latency_max_ns / 1e6);
+
+    return 0;
+}
+
+/**
+ * @brief replayCapture : replays the instructions of a capture against the packet handler, which receives the recorded status packets
+ * @param file_name
+ * @return
+ */
+int replayCapture(const std::string &file_name)
+{
+    ttl_debug_tools::TtlCapture capture;
+    if (!capture.load(file_name))
+    {
+        printf("ERROR: %s is not a capture file\n", file_name.c_str());
+        return 1;
+    }
+
+    std::vector<ttl_debug_tools::Transaction> transactions = capture.decode();
+    ttl_debug_tools::ReplayPortHandler port(capture.getRecords());
+    dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION);
+    std::vector<uint8_t> rx_packet(dynamixel::PortHandler::RX_PACKET_BUFFER_LEN_);
+
+    size_t difference_count = 0;
+    int64_t start_time_ns = transactions.empty() ? 0 : transactions.front().instruction.timestamp_ns;
+    for (auto &transaction : transactions)
+    {
+        port.writePort(transaction.instruction.bytes.data(), static_cast<int>(transaction.instruction.bytes.size()));
+
+        // the status packets are decoded by the packet handler as in the drivers
+        int result = COMM_SUCCESS;
+        if (INST_FAST_SYNC_READ == transaction.instruction.instruction && transaction.instruction.params.size() > 4)
+        {
+            uint16_t data_length = DXL_MAKEWORD(transaction.instruction.params[2], transaction.instruction.params[3]);
+            auto param_length = static_cast<uint16_t>((transaction.instruction.params.size() - 4) * (data_length + 4) - 2);
+            if (param_length <= rx_packet.size())
+                result = packetHandler->fastSyncReadRx(&port, param_length, rx_packet.data());
+        }
+        else
+        {
+            for (size_t i = 0; i < transaction.expected_status_count && COMM_SUCCESS == result; ++i)
+                result = packetHandler->rxPacket(&port, rx_packet.data());
+        }
+
+        if (result != transaction.result)
+        {
+            difference_count++;
+            std::cout << ttl_debug_tools::TtlCapture::toString(transaction, start_time_ns) << " -> packet handler : " << packetHandler->getTxRxResult(result) << "\n";
+        }
+    }
+
+    printf("--> %zu transactions replayed, %zu results different from the capture, %zu instructions not matching the capture\n", transactions.size(),
+           difference_count, port.getMismatchCount());
+
+    return 0;
+}
+
 /**
  * @brief handleUserInput
  * @param argc
@@ -76,7 +183,9 @@ int handleUserInput(int argc, char **argv)
             "calibrate", "calibrate joints")("test", "a test movement")("set-register", po::value<std::vector<int>>()->multitoken(),
                                                                         "Set a value to a register (args: reg_addr, value, size)")(
             "set-registers", po::value<std::vector<int>>()->multitoken(), "Set the values to a register for multiples devices (args: reg_addr, size, values)")(
-            "get-registers", po::value<int>()->multitoken(), "get the values of a register for multiples devices (arg: reg_addr)");
+            "get-registers", po::value<int>()->multitoken(), "get the values of a register for multiples devices (arg: reg_addr)")(
+            "decode-capture", po::value<std::string>(), "Decode a capture of the bus written by the packet tracer (arg: file)")(
+            "replay-capture", po::value<std::string>(), "Replay a capture of the bus against the packet handler (arg: file)");
 
         // po::positional_options_description p;
         // p.add("set-register", 3);
@@ -94,6 +203,12 @@ int handleUserInput(int argc, char **argv)
             return 0;
         }
 
+        // --------   offline commands, without the bus
+        if (vars.count("decode-capture"))
+            return decodeCapture(vars["decode-capture"].as<std::string>());
+        if (vars.count("replay-capture"))
+            return replayCapture(vars["replay-capture"].as<std::string>());
+
         // --------   other commands
         int baudrate = vars["baudrate"].as<int>();
         std::string serial_port = vars["port"].as<std::string>();
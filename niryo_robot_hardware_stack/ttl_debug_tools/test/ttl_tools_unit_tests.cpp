@@ -25,11 +25,16 @@
 
 // Bring in my package's API, which is what I'm testing
 #include "dynamixel_sdk/packet_handler.h"
+#include "dynamixel_sdk/packet_tracer.h"
 #include "dynamixel_sdk/port_handler.h"
+#include "dynamixel_sdk/protocol2_packet_handler.h"
+#include "ttl_debug_tools/ttl_capture.h"
 #include "ttl_debug_tools/ttl_tools.h"
 
+#include <cstdio>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Bring in gtest
 #include <gtest/gtest.h>
@@ -59,6 +64,75 @@ TEST(TtlDebugToolsTestSuite, testInit)
     }
 }
 
+// protocol 2.0 packet, the parameters being already stuffed
+std::vector<uint8_t> makePacket(uint8_t id, uint8_t instruction, const std::vector<uint8_t> &params)
+{
+    auto length = static_cast<uint16_t>(params.size() + 3);
+    std::vector<uint8_t> packet{0xFF, 0xFF, 0xFD, 0x00, id, DXL_LOBYTE(length), DXL_HIBYTE(length), instruction};
+    packet.insert(packet.end(), params.begin(), params.end());
+
+    auto packet_handler = static_cast<dynamixel::Protocol2PacketHandler *>(dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION));
+    uint16_t crc = packet_handler->updateCRC(0, packet.data(), static_cast<uint16_t>(packet.size()));
+    packet.push_back(DXL_LOBYTE(crc));
+    packet.push_back(DXL_HIBYTE(crc));
+
+    return packet;
+}
+
+TEST(TtlDebugToolsTestSuite, captureDecodeAndReplay)
+{
+    std::string file_name = testing::TempDir() + "ttl_debug_tools_capture.bin";
+
+    std::vector<uint8_t> read_position = makePacket(2, INST_READ, {132, 0, 4, 0});
+    std::vector<uint8_t> position_status = makePacket(2, INST_STATUS, {0, 0x00, 0x08, 0, 0});
+    std::vector<uint8_t> sync_read = makePacket(BROADCAST_ID, INST_SYNC_READ, {132, 0, 4, 0, 2, 3});
+    // 0xFF 0xFF 0xFD 0x01 written, stuffed on the bus
+    std::vector<uint8_t> write_goal = makePacket(2, INST_WRITE, {116, 0, 0xFF, 0xFF, 0xFD, 0xFD, 0x01});
+
+    dynamixel::PacketTracer tracer;
+    ASSERT_TRUE(tracer.start(file_name.c_str()));
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_TX_, read_position.data(), static_cast<int>(read_position.size()));
+    // a status packet can be read in several parts
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_RX_, position_status.data(), 5);
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_RX_, position_status.data() + 5, static_cast<int>(position_status.size()) - 5);
+    // the motor 3 does not answer
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_TX_, sync_read.data(), static_cast<int>(sync_read.size()));
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_RX_, position_status.data(), static_cast<int>(position_status.size()));
+    tracer.trace(dynamixel::PacketTracer::DIRECTION_TX_, write_goal.data(), static_cast<int>(write_goal.size()));
+    tracer.stop();
+    EXPECT_EQ(tracer.getDroppedCount(), 0u);
+
+    ttl_debug_tools::TtlCapture capture;
+    ASSERT_TRUE(capture.load(file_name));
+    EXPECT_EQ(capture.getRecords().size(), 6u);
+
+    std::vector<ttl_debug_tools::Transaction> transactions = capture.decode();
+    ASSERT_EQ(transactions.size(), 3u);
+
+    EXPECT_EQ(transactions.at(0).instruction.instruction, INST_READ);
+    ASSERT_EQ(transactions.at(0).status_list.size(), 1u);
+    EXPECT_TRUE(transactions.at(0).status_list.at(0).crc_ok);
+    EXPECT_EQ(transactions.at(0).status_list.at(0).params, std::vector<uint8_t>({0x00, 0x08, 0, 0}));
+    EXPECT_GE(transactions.at(0).latency_ns, 0);
+    EXPECT_EQ(transactions.at(0).result, COMM_SUCCESS);
+
+    EXPECT_EQ(transactions.at(1).expected_status_count, 2u);
+    EXPECT_EQ(transactions.at(1).result, COMM_RX_TIMEOUT);
+
+    EXPECT_EQ(transactions.at(2).instruction.params, std::vector<uint8_t>({116, 0, 0xFF, 0xFF, 0xFD, 0x01}));
+    EXPECT_EQ(transactions.at(2).result, COMM_SUCCESS);
+
+    // the packet handler reads the recorded status packet
+    ttl_debug_tools::ReplayPortHandler port(capture.getRecords());
+    dynamixel::PacketHandler *packet_handler = dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION);
+    uint32_t position = 0;
+    EXPECT_EQ(packet_handler->read4ByteTxRx(&port, 2, 132, &position), COMM_SUCCESS);
+    EXPECT_EQ(position, 2048u);
+    EXPECT_EQ(port.getMismatchCount(), 0u);
+
+    std::remove(file_name.c_str());
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv)
 {
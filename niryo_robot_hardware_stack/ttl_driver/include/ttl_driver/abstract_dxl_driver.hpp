@@ -43,6 +43,7 @@ namespace ttl_driver
 
         int writeSingleCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) override;
         int writeSyncCmd(int type, const std::vector<uint8_t> &ids, const std::vector<uint32_t> &params) override;
+        bool canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) const override;
 
     public:
         // specific DXL commands
@@ -68,6 +69,8 @@ namespace ttl_driver
 
         virtual int writeTorqueGoal(uint8_t id, uint16_t torque) = 0;
         virtual int syncWriteTorqueGoal(const std::vector<uint8_t> &id_list, const std::vector<uint16_t> &torque_list) = 0;
+
+        virtual int syncWriteVelocityProfile(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &data_list) = 0;
     };
 
 } // ttl_driver
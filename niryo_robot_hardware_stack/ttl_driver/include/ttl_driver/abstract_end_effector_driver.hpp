@@ -76,6 +76,7 @@ protected:
 public:
     int writeSingleCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) override;
     int writeSyncCmd(int type, const std::vector<uint8_t> &ids, const std::vector<uint32_t> &params) override;
+    bool canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) const override;
 };
 
 } // ttl_driver
@@ -25,12 +25,17 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "dynamixel_sdk/dynamixel_sdk.h"
 #include "common/common_defs.hpp"
 #include "common/model/hardware_type_enum.hpp"
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/util/fixed_vector.hpp"
 
 #include "ttl_driver/abstract_ttl_driver.hpp"
 
 namespace ttl_driver
 {
 
+// {position, velocity, load} of each motor of a sync read, decoded without allocation
+using JointStatusList = common::util::FixedVector<std::array<uint32_t, 3>, common::model::MAX_JOINT_STATES_SNAPSHOT_SIZE>;
+
 /**
  * @brief The XDriver class
  */
@@ -69,13 +74,20 @@ public:
 
     // ram read
     virtual int readVelocityProfile(uint8_t id, std::vector<uint32_t>& data_list) = 0;
+    virtual int readTorqueEnable(uint8_t id, uint8_t& torque_enable) = 0;
 
     virtual int readPosition(uint8_t id, uint32_t& present_position) = 0;
     virtual int readVelocity(uint8_t id, uint32_t& present_velocity) = 0;
 
     virtual int syncReadPosition(const std::vector<uint8_t>& id_list, std::vector<uint32_t>& position_list) = 0;
     virtual int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t>& velocity_list) = 0;
-    virtual int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2> >& data_array_list) = 0;
+    // {position, velocity, load} of each motor, read in a single sync read
+    virtual int syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList& data_array_list) = 0;
+
+    // bulk transactions, shared by the drivers of all the motor types of the bus
+    virtual int addJointStatusToBulkRead(dynamixel::GroupBulkRead& bulk_read, uint8_t id) = 0;
+    virtual int getJointStatusFromBulkRead(dynamixel::GroupBulkRead& bulk_read, uint8_t id, std::array<uint32_t, 3>& data) = 0;
+    virtual int addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite& bulk_write, uint8_t id, uint32_t position) = 0;
 };
 
 } // ttl_driver
@@ -44,6 +44,7 @@ namespace ttl_driver
 
         int writeSingleCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) override;
         int writeSyncCmd(int type, const std::vector<uint8_t> &ids, const std::vector<uint32_t> &params) override;
+        bool canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) const override;
 
         common::model::EStepperCalibrationStatus interpretHomingData(uint8_t status) const;
         std::string interpretErrorState(uint32_t hw_state) const override;
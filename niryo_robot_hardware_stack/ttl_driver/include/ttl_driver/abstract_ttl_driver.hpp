@@ -17,7 +17,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef ABSTRACT_TTL_DRIVER_HPP
 #define ABSTRACT_TTL_DRIVER_HPP
 
+#include <algorithm>
+#include <array>
+#include <map>
 #include <memory>
+#include <set>
+#include <tuple>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -54,6 +59,7 @@ public:
     
     virtual int writeSingleCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >& cmd) = 0;
     virtual int writeSyncCmd(int type, const std::vector<uint8_t>& ids, const std::vector<uint32_t>& params) = 0;
+    virtual bool canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >& cmd) const = 0;
 
 public:
     virtual std::string str() const;
@@ -62,10 +68,17 @@ public:
     virtual std::string interpretErrorState(uint32_t hw_state) const = 0;
 
     // eeprom write
+    virtual int writeReturnDelayTime(uint8_t id, uint32_t return_delay_us);
+    virtual int writeBaudRate(uint8_t id, int baudrate);
+    virtual bool isBaudRateSupported(int baudrate) const;
 
     // eeprom read
     virtual int checkModelNumber(uint8_t id) = 0;
     virtual int readFirmwareVersion(uint8_t id, std::string& version) = 0;
+    virtual int readReturnDelayTime(uint8_t id, uint32_t& return_delay_us);
+
+    // ram write
+    virtual int writeStatusReturnLevel(uint8_t id, uint8_t status_return_level);
 
     // ram read
     virtual int readTemperature(uint8_t id, uint8_t& temperature) = 0;
@@ -79,18 +92,58 @@ public:
     virtual int syncReadHwErrorStatus(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& hw_error_list) = 0;
     virtual int syncReadHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t> >& data_array_list) = 0;
 
+    // fast sync read is only used when all the motors of a sync read support it
+    void setFastSyncReadAvailable(uint8_t id, bool available);
+    bool isFastSyncReadAvailable(const std::vector<uint8_t>& id_list) const;
+
+    // writes are not answered below STATUS_RETURN_ALL, they are sent without waiting for a status
+    void setTxOnlyWrite(uint8_t id, bool tx_only);
+    bool isTxOnlyWrite(uint8_t id) const;
+
+    // status return levels of the protocol 2.0
+    static constexpr uint8_t STATUS_RETURN_PING      = 0;
+    static constexpr uint8_t STATUS_RETURN_PING_READ = 1;
+    static constexpr uint8_t STATUS_RETURN_ALL       = 2;
+
+    // baud rate of the devices out of the factory, supported by all of them
+    static constexpr int DEFAULT_BAUDRATE = 1000000;
+
 protected:
     // we use those commands in the children classes to actually read and write values in registers
     template<typename T>
     int read(uint16_t address, uint8_t id, T& data);
 
-    template<typename T>
-    int syncRead(uint16_t address, const std::vector<uint8_t>& id_list, std::vector<T>& data_list);
+    // sync reads decode into any list with clear() and push_back(), a std::vector or a fixed capacity common::util::FixedVector
+    template<typename T, class List>
+    int syncRead(uint16_t address, const std::vector<uint8_t>& id_list, List& data_list);
 
-    template<typename T, const size_t N>
+    template<typename T, const size_t N, class List>
     int syncReadConsecutiveBytes(uint16_t address,
                                  const std::vector<uint8_t> &id_list,
-                                 std::vector<std::array<T, N> >& data_list);
+                                 List& data_list);
+
+    template<const size_t N, class List>
+    int syncReadFields(const std::array<uint16_t, N>& address_list,
+                       const std::array<uint8_t, N>& length_list,
+                       const std::vector<uint8_t> &id_list,
+                       List& data_list);
+
+    // bulk transactions are owned by the caller, to gather motors of several types in the same packet
+    template<const size_t N>
+    int addBulkReadFields(dynamixel::GroupBulkRead& bulk_read,
+                          uint8_t id,
+                          const std::array<uint16_t, N>& address_list,
+                          const std::array<uint8_t, N>& length_list);
+
+    template<const size_t N>
+    int getBulkReadFields(dynamixel::GroupBulkRead& bulk_read,
+                          uint8_t id,
+                          const std::array<uint16_t, N>& address_list,
+                          const std::array<uint8_t, N>& length_list,
+                          std::array<uint32_t, N>& data);
+
+    template<typename T>
+    int addBulkWrite(dynamixel::GroupBulkWrite& bulk_write, uint16_t address, uint8_t id, T data);
 
     template<typename T>
     int write(uint16_t address, uint8_t id, T data);
@@ -98,14 +151,69 @@ protected:
     template<typename T>
     int syncWrite(uint16_t address, const std::vector<uint8_t>& id_list, const std::vector<T>& data_list);
 
+    template<typename T, const size_t N>
+    int syncWriteConsecutiveBytes(uint16_t address, const std::vector<uint8_t>& id_list, const std::vector<T>& data_list);
+
     static constexpr int PING_WRONG_MODEL_NUMBER = 30;
 
+    // a field the motor does not have, in the lists of syncReadFields and bulk read fields : it is not read and stays at 0
+    static constexpr uint16_t ABSENT_FIELD_ADDRESS = 0;
+    static constexpr uint8_t ABSENT_FIELD_LENGTH = 0;
+
     virtual std::string interpretFirmwareVersion(uint32_t fw_version) const = 0;
 
 private:
+    template<const size_t N>
+    static bool getFieldsRange(const std::array<uint16_t, N>& address_list,
+                               const std::array<uint8_t, N>& length_list,
+                               uint16_t& start_address,
+                               uint16_t& data_size);
+
+    // group transactions are prepared once for a register range and a set of ids, then reused at each cycle
+    using GroupKey = std::tuple<uint16_t, uint16_t, std::array<uint64_t, 4> >;
+
+    template<class Group>
+    using GroupCache = std::map<GroupKey, std::unique_ptr<Group> >;
+
+    template<class Group, typename Init>
+    Group* getGroup(GroupCache<Group>& cache,
+                    uint16_t address,
+                    uint16_t data_size,
+                    const std::vector<uint8_t>& id_list,
+                    Init&& init);
+
+    template<typename Decoder>
+    int syncReadRange(uint16_t address,
+                      uint16_t data_size,
+                      const std::vector<uint8_t> &id_list,
+                      Decoder&& decode);
+
+    template<class GroupRead, typename Decoder>
+    int groupSyncReadRange(GroupCache<GroupRead>& cache,
+                           uint16_t address,
+                           uint16_t data_size,
+                           const std::vector<uint8_t> &id_list,
+                           Decoder&& decode);
+
+    template<typename T>
+    static void encodeParams(T data, uint8_t* params);
+
     std::shared_ptr<dynamixel::PortHandler> _dxlPortHandler;
     std::shared_ptr<dynamixel::PacketHandler> _dxlPacketHandler;
 
+    // ids of the motors whose firmware supports fast sync read
+    std::set<uint8_t> _fast_sync_read_ids;
+
+    // ids of the motors which do not answer the writes
+    std::set<uint8_t> _tx_only_write_ids;
+
+    GroupCache<dynamixel::GroupSyncRead> _sync_read_cache;
+    GroupCache<dynamixel::GroupFastSyncRead> _fast_sync_read_cache;
+    GroupCache<dynamixel::GroupSyncWrite> _sync_write_cache;
+
+    // a cache is emptied when full, it only grows with unusual sets of ids
+    static constexpr size_t MAX_CACHED_GROUPS = 32;
+
     static constexpr uint8_t DXL_LEN_ONE_BYTE    = 1;
     static constexpr uint8_t DXL_LEN_TWO_BYTES   = 2;
     static constexpr uint8_t DXL_LEN_FOUR_BYTES  = 4;
@@ -190,43 +298,234 @@ int AbstractTtlDriver::read(uint16_t address, uint8_t id, T& data)
  * Reads N consecutive blocks of T bytes simultaneously
  * @return
  */
-template<typename T, const size_t N>
+template<typename T, const size_t N, class List>
 int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
                                                 const std::vector<uint8_t> &id_list,
-                                                std::vector<std::array<T, N> >& data_list)
+                                                List& data_list)
 {
     data_list.clear();
     uint16_t data_size = sizeof(T);
-    int dxl_comm_result = COMM_TX_FAIL;
 
-    dynamixel::GroupSyncRead groupSyncRead(_dxlPortHandler.get(), _dxlPacketHandler.get(), address, data_size * N);
+    int dxl_comm_result = syncReadRange(address, data_size * N, id_list,
+                                        [&](auto& group_read, uint8_t id)
+    {
+        std::array<T, N> blocks{};
+
+        for(uint8_t b = 0; b < N; ++b)
+        {
+            T data = static_cast<T>(group_read.getData(id, address + b * data_size, data_size));
+            blocks.at(b) = data;
+        }
+
+        data_list.push_back(blocks);
+    });
+
+    // a fixed capacity list can be too small
+    if (COMM_SUCCESS == dxl_comm_result && data_list.size() != id_list.size())
+        dxl_comm_result = LEN_ID_DATA_NOT_SAME;
 
-    for (auto const& id : id_list)
+    return dxl_comm_result;
+}
+
+/**
+ * @brief AbstractTtlDriver::getFieldsRange : range of registers covering all the fields
+ * @param address_list
+ * @param length_list : absent fields (ABSENT_FIELD_LENGTH) are ignored
+ * @param start_address
+ * @param data_size
+ * @return false if there is no field to read
+ */
+template<const size_t N>
+bool AbstractTtlDriver::getFieldsRange(const std::array<uint16_t, N>& address_list,
+                                       const std::array<uint8_t, N>& length_list,
+                                       uint16_t& start_address,
+                                       uint16_t& data_size)
+{
+    uint16_t end_address = 0;
+    start_address = 0xFFFF;
+
+    for (size_t f = 0; f < N; ++f)
     {
-        if (!groupSyncRead.addParam(id))
+        if (ABSENT_FIELD_LENGTH == length_list.at(f))
+            continue;
+
+        start_address = std::min(start_address, address_list.at(f));
+        end_address = std::max(end_address, static_cast<uint16_t>(address_list.at(f) + length_list.at(f)));
+    }
+
+    if (end_address <= start_address)
+        return false;
+
+    data_size = end_address - start_address;
+    return true;
+}
+
+/**
+ * @brief AbstractTtlDriver::syncReadFields
+ * @param address_list : address of each field
+ * @param length_list : length of each field, 1, 2 or 4 bytes. An absent field (ABSENT_FIELD_LENGTH) is not read and stays at 0
+ * @param id_list
+ * @param data_list
+ * Reads N registers of different sizes with a single sync read covering all of them
+ * The registers must be close to each other, the bytes between them are read too
+ * @return
+ */
+template<const size_t N, class List>
+int AbstractTtlDriver::syncReadFields(const std::array<uint16_t, N>& address_list,
+                                      const std::array<uint8_t, N>& length_list,
+                                      const std::vector<uint8_t> &id_list,
+                                      List& data_list)
+{
+    data_list.clear();
+
+    uint16_t start_address = 0;
+    uint16_t data_size = 0;
+    if (!getFieldsRange<N>(address_list, length_list, start_address, data_size))
+        return COMM_TX_FAIL;
+
+    int dxl_comm_result = syncReadRange(start_address, data_size, id_list,
+                                        [&](auto& group_read, uint8_t id)
+    {
+        std::array<uint32_t, N> fields{};
+
+        for (size_t f = 0; f < N; ++f)
         {
-            groupSyncRead.clearParam();
-            return GROUP_SYNC_REDONDANT_ID;
+            if (ABSENT_FIELD_LENGTH != length_list.at(f))
+                fields.at(f) = group_read.getData(id, address_list.at(f), length_list.at(f));
         }
+
+        data_list.push_back(fields);
+    });
+
+    // a fixed capacity list can be too small
+    if (COMM_SUCCESS == dxl_comm_result && data_list.size() != id_list.size())
+        dxl_comm_result = LEN_ID_DATA_NOT_SAME;
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief AbstractTtlDriver::addBulkReadFields : add the registers of a motor to a bulk read
+ * @param bulk_read
+ * @param id
+ * @param address_list : address of each field
+ * @param length_list : length of each field, 1, 2 or 4 bytes. An absent field (ABSENT_FIELD_LENGTH) is not read
+ * Each motor of a bulk read has its own range of registers, covering all its fields
+ * @return
+ */
+template<const size_t N>
+int AbstractTtlDriver::addBulkReadFields(dynamixel::GroupBulkRead& bulk_read,
+                                         uint8_t id,
+                                         const std::array<uint16_t, N>& address_list,
+                                         const std::array<uint8_t, N>& length_list)
+{
+    uint16_t start_address = 0;
+    uint16_t data_size = 0;
+    if (!getFieldsRange<N>(address_list, length_list, start_address, data_size))
+        return COMM_TX_FAIL;
+
+    if (!bulk_read.addParam(id, start_address, data_size))
+        return GROUP_SYNC_REDONDANT_ID;
+
+    return COMM_SUCCESS;
+}
+
+/**
+ * @brief AbstractTtlDriver::getBulkReadFields : retrieve the fields of a motor after a bulk read
+ * @param bulk_read
+ * @param id
+ * @param address_list : same as given to addBulkReadFields
+ * @param length_list : same as given to addBulkReadFields. An absent field stays at 0
+ * @param data
+ * @return
+ */
+template<const size_t N>
+int AbstractTtlDriver::getBulkReadFields(dynamixel::GroupBulkRead& bulk_read,
+                                         uint8_t id,
+                                         const std::array<uint16_t, N>& address_list,
+                                         const std::array<uint8_t, N>& length_list,
+                                         std::array<uint32_t, N>& data)
+{
+    uint16_t start_address = 0;
+    uint16_t data_size = 0;
+    if (!getFieldsRange<N>(address_list, length_list, start_address, data_size))
+        return COMM_RX_FAIL;
+
+    if (!bulk_read.isAvailable(id, start_address, data_size))
+        return GROUP_SYNC_READ_RX_FAIL;
+
+    data.fill(0);
+    for (size_t f = 0; f < N; ++f)
+    {
+        if (ABSENT_FIELD_LENGTH != length_list.at(f))
+            data.at(f) = bulk_read.getData(id, address_list.at(f), length_list.at(f));
     }
 
-    dxl_comm_result = groupSyncRead.txRxPacket();
+    return COMM_SUCCESS;
+}
 
-    if (COMM_SUCCESS == dxl_comm_result)
+/**
+ * @brief AbstractTtlDriver::syncReadRange : sync read of data_size bytes from address on all the motors of id_list
+ * @param address
+ * @param data_size
+ * @param id_list
+ * @param decode : called with the group read and the id of each motor, in the order of id_list
+ * Uses a fast sync read when all the motors support it, a classic sync read otherwise
+ * @return
+ */
+template<typename Decoder>
+int AbstractTtlDriver::syncReadRange(uint16_t address,
+                                     uint16_t data_size,
+                                     const std::vector<uint8_t> &id_list,
+                                     Decoder&& decode)
+{
+    if (isFastSyncReadAvailable(id_list))
+        return groupSyncReadRange(_fast_sync_read_cache, address, data_size, id_list, std::forward<Decoder>(decode));
+
+    return groupSyncReadRange(_sync_read_cache, address, data_size, id_list, std::forward<Decoder>(decode));
+}
+
+/**
+ * @brief AbstractTtlDriver::groupSyncReadRange
+ * @param cache : prepared group reads of this kind
+ * @param address
+ * @param data_size
+ * @param id_list
+ * @param decode
+ * @return
+ */
+template<class GroupRead, typename Decoder>
+int AbstractTtlDriver::groupSyncReadRange(GroupCache<GroupRead>& cache,
+                                          uint16_t address,
+                                          uint16_t data_size,
+                                          const std::vector<uint8_t> &id_list,
+                                          Decoder&& decode)
+{
+    int dxl_comm_result = COMM_TX_FAIL;
+
+    GroupRead* groupSyncRead = getGroup(cache, address, data_size, id_list,
+                                        [&id_list](GroupRead& group_read)
     {
         for (auto const& id : id_list)
         {
-            if (groupSyncRead.isAvailable(id, address, data_size * N))
-            {
-                std::array<T, N> blocks{};
+            if (!group_read.addParam(id))
+                return false;
+        }
+        return true;
+    });
 
-                for(uint8_t b = 0; b < N; ++b)
-                {
-                    T data = static_cast<T>(groupSyncRead.getData(id, address + b * data_size, data_size));
-                    blocks.at(b) = data;
-                }
+    if (!groupSyncRead)
+        return GROUP_SYNC_REDONDANT_ID;
 
-                data_list.emplace_back(std::move(blocks));
+    dxl_comm_result = groupSyncRead->txRxPacket();
+
+    if (COMM_SUCCESS == dxl_comm_result)
+    {
+        for (auto const& id : id_list)
+        {
+            if (groupSyncRead->isAvailable(id, address, data_size))
+            {
+                decode(*groupSyncRead, id);
             }
             else
             {
@@ -236,11 +535,52 @@ int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
         }
     }
 
-    groupSyncRead.clearParam();
-
     return dxl_comm_result;
 }
 
+/**
+ * @brief AbstractTtlDriver::getGroup : group transaction prepared for a register range and a set of ids
+ * @param cache
+ * @param address
+ * @param data_size
+ * @param id_list : the order of the ids does not matter
+ * @param init : adds the ids to a new group, returns false on failure
+ * The group is created and initialized the first time, then reused without any allocation
+ * @return nullptr if an id is redundant or the initialization failed
+ */
+template<class Group, typename Init>
+Group* AbstractTtlDriver::getGroup(GroupCache<Group>& cache,
+                                   uint16_t address,
+                                   uint16_t data_size,
+                                   const std::vector<uint8_t>& id_list,
+                                   Init&& init)
+{
+    std::array<uint64_t, 4> id_mask{};
+    for (auto const id : id_list)
+    {
+        uint64_t bit = static_cast<uint64_t>(1) << (id % 64);
+        if (id_mask.at(id / 64) & bit)
+            return nullptr;
+
+        id_mask.at(id / 64) |= bit;
+    }
+
+    GroupKey key(address, data_size, id_mask);
+
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second.get();
+
+    auto group = std::make_unique<Group>(_dxlPortHandler.get(), _dxlPacketHandler.get(), address, data_size);
+    if (!init(*group))
+        return nullptr;
+
+    if (cache.size() >= MAX_CACHED_GROUPS)
+        cache.clear();
+
+    return cache.emplace(key, std::move(group)).first->second.get();
+}
+
 /**
  * @brief AbstractTtlDriver::syncRead
  * @param address
@@ -248,10 +588,10 @@ int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
  * @param data_list
  * @return
  */
-template<typename T>
+template<typename T, class List>
 int AbstractTtlDriver::syncRead(uint16_t address,
                                 const std::vector<uint8_t> &id_list,
-                                std::vector<T> &data_list)
+                                List &data_list)
 {
     int dxl_comm_result = COMM_TX_FAIL;
 
@@ -259,37 +599,15 @@ int AbstractTtlDriver::syncRead(uint16_t address,
     uint8_t data_len = sizeof(T);
     if(data_len <= 4)
     {
-        dynamixel::GroupSyncRead groupSyncRead(_dxlPortHandler.get(), _dxlPacketHandler.get(), address, data_len);
-
-        for (auto const& id : id_list)
+        dxl_comm_result = syncReadRange(address, data_len, id_list,
+                                        [&](auto& group_read, uint8_t id)
         {
-            if (!groupSyncRead.addParam(id))
-            {
-                groupSyncRead.clearParam();
-                return GROUP_SYNC_REDONDANT_ID;
-            }
-        }
-
-        dxl_comm_result = groupSyncRead.txRxPacket();
-
-        if (COMM_SUCCESS == dxl_comm_result)
-        {
-            for (auto const& id : id_list)
-            {
-                if (groupSyncRead.isAvailable(id, address, data_len))
-                {
-                    T data = static_cast<T>(groupSyncRead.getData(id, address, data_len));
-                    data_list.emplace_back(data);
-                }
-                else
-                {
-                    dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
-                    break;
-                }
-            }
-        }
+            data_list.push_back(static_cast<T>(group_read.getData(id, address, data_len)));
+        });
 
-        groupSyncRead.clearParam();
+        // a fixed capacity list can be too small
+        if (COMM_SUCCESS == dxl_comm_result && data_list.size() != id_list.size())
+            dxl_comm_result = LEN_ID_DATA_NOT_SAME;
     }
     else
     {
@@ -299,25 +617,37 @@ int AbstractTtlDriver::syncRead(uint16_t address,
     return dxl_comm_result;
 }
 
+/**
+ * @brief AbstractTtlDriver::write
+ * @param address
+ * @param id
+ * @param data
+ * @return
+ * The write is only sent when the motor does not answer the writes (see setTxOnlyWrite) : no device error is then reported
+ */
 template<typename T>
 int AbstractTtlDriver::write(uint16_t address, uint8_t id, T data)
 {
     int dxl_comm_result = COMM_TX_FAIL;
     uint8_t error = 0;
+    bool tx_only = isTxOnlyWrite(id);
 
     switch (sizeof(T))
     {
         case DXL_LEN_ONE_BYTE:
-            dxl_comm_result = _dxlPacketHandler->write1ByteTxRx(_dxlPortHandler.get(),
-                                                                  id, address, data, &error);
+            dxl_comm_result = tx_only ? _dxlPacketHandler->write1ByteTxOnly(_dxlPortHandler.get(), id, address, data)
+                                      : _dxlPacketHandler->write1ByteTxRx(_dxlPortHandler.get(),
+                                                                          id, address, data, &error);
         break;
         case DXL_LEN_TWO_BYTES:
-            dxl_comm_result = _dxlPacketHandler->write2ByteTxRx(_dxlPortHandler.get(),
-                                                                  id, address, data, &error);
+            dxl_comm_result = tx_only ? _dxlPacketHandler->write2ByteTxOnly(_dxlPortHandler.get(), id, address, data)
+                                      : _dxlPacketHandler->write2ByteTxRx(_dxlPortHandler.get(),
+                                                                          id, address, data, &error);
         break;
         case DXL_LEN_FOUR_BYTES:
-            dxl_comm_result = _dxlPacketHandler->write4ByteTxRx(_dxlPortHandler.get(),
-                                                                  id, address, data, &error);
+            dxl_comm_result = tx_only ? _dxlPacketHandler->write4ByteTxOnly(_dxlPortHandler.get(), id, address, data)
+                                      : _dxlPacketHandler->write4ByteTxRx(_dxlPortHandler.get(),
+                                                                          id, address, data, &error);
         break;
         default:
             printf("AbstractTtlDriver::write ERROR: Size param must be 1, 2 or 4 bytes\n");
@@ -343,59 +673,37 @@ int AbstractTtlDriver::syncWrite(uint16_t address, const std::vector<uint8_t>& i
     {
         if (id_list.size() == data_list.size())
         {
-            dynamixel::GroupSyncWrite groupSyncWrite(_dxlPortHandler.get(),
-                                                     _dxlPacketHandler.get(),
-                                                     address,
-                                                     data_len);
+            if (DXL_LEN_ONE_BYTE != data_len && DXL_LEN_TWO_BYTES != data_len && DXL_LEN_FOUR_BYTES != data_len)
+            {
+                printf("AbstractTtlDriver::syncWrite ERROR: Size param must be 1, 2 or 4 bytes\n");
+                return GROUP_SYNC_REDONDANT_ID;
+            }
 
-            bool dxl_senddata_result = false;
+            uint8_t params[DXL_LEN_FOUR_BYTES] = {};
 
-            for (size_t i = 0; i < id_list.size(); ++i)
+            dynamixel::GroupSyncWrite* groupSyncWrite = getGroup(_sync_write_cache, address, data_len, id_list,
+                                                                 [&](dynamixel::GroupSyncWrite& group_write)
             {
-                uint8_t id = id_list.at(i);
-                T data = data_list.at(i);
-
-                switch (data_len)
+                for (size_t i = 0; i < id_list.size(); ++i)
                 {
-                    case DXL_LEN_ONE_BYTE:
-                    {
-                        uint8_t params[1] = {static_cast<uint8_t>(data)};
-                        dxl_senddata_result = groupSyncWrite.addParam(id, params);
-                    }
-                    break;
-                    case DXL_LEN_TWO_BYTES:
-                    {
-                        uint8_t params[2] = {DXL_LOBYTE(static_cast<uint16_t>(data)),
-                                             DXL_HIBYTE(static_cast<uint16_t>(data))};
-                        dxl_senddata_result = groupSyncWrite.addParam(id, params);
-                    }
-                    break;
-                    case DXL_LEN_FOUR_BYTES:
-                    {
-                          uint8_t params[4] = {DXL_LOBYTE(DXL_LOWORD(data)),
-                                               DXL_HIBYTE(DXL_LOWORD(data)),
-                                               DXL_LOBYTE(DXL_HIWORD(data)),
-                                               DXL_HIBYTE(DXL_HIWORD(data))};
-                        dxl_senddata_result = groupSyncWrite.addParam(id, params);
-                    }
-                    break;
-                    default:
-                        printf("AbstractTtlDriver::syncWrite ERROR: Size param must be 1, 2 or 4 bytes\n");
-                    break;
+                    encodeParams(data_list.at(i), params);
+                    if (!group_write.addParam(id_list.at(i), params))
+                        return false;
                 }
+                return true;
+            });
 
-                if (!dxl_senddata_result)
-                {
-                    dxl_comm_result = GROUP_SYNC_REDONDANT_ID;
-                    break;
-                }
-            }
+            if (!groupSyncWrite)
+                return GROUP_SYNC_REDONDANT_ID;
 
-            // send group if no error
-            if (GROUP_SYNC_REDONDANT_ID != dxl_comm_result)
-                dxl_comm_result = groupSyncWrite.txPacket();
+            // a reused group still holds the data of its previous write
+            for (size_t i = 0; i < id_list.size(); ++i)
+            {
+                encodeParams(data_list.at(i), params);
+                groupSyncWrite->changeParam(id_list.at(i), params);
+            }
 
-            groupSyncWrite.clearParam();
+            dxl_comm_result = groupSyncWrite->txPacket();
         }
         else
         {
@@ -406,6 +714,116 @@ int AbstractTtlDriver::syncWrite(uint16_t address, const std::vector<uint8_t>& i
     return dxl_comm_result;
 }
 
+/**
+ * @brief AbstractTtlDriver::syncWriteConsecutiveBytes
+ * @param address
+ * @param id_list
+ * @param data_list : N values per id, in the order of the ids
+ * Writes N consecutive blocks of T bytes simultaneously
+ * @return
+ */
+template<typename T, const size_t N>
+int AbstractTtlDriver::syncWriteConsecutiveBytes(uint16_t address, const std::vector<uint8_t>& id_list, const std::vector<T>& data_list)
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4, "Size param must be 1, 2 or 4 bytes");
+
+    if (id_list.empty())
+        return COMM_SUCCESS;
+
+    if (id_list.size() * N != data_list.size())
+        return LEN_ID_DATA_NOT_SAME;
+
+    uint16_t data_size = sizeof(T);
+    uint8_t params[N * sizeof(T)] = {};
+
+    auto encodeBlocks = [&](size_t i)
+    {
+        for (size_t b = 0; b < N; ++b)
+            encodeParams(data_list.at(i * N + b), params + b * data_size);
+    };
+
+    dynamixel::GroupSyncWrite* groupSyncWrite = getGroup(_sync_write_cache, address, data_size * N, id_list,
+                                                         [&](dynamixel::GroupSyncWrite& group_write)
+    {
+        for (size_t i = 0; i < id_list.size(); ++i)
+        {
+            encodeBlocks(i);
+            if (!group_write.addParam(id_list.at(i), params))
+                return false;
+        }
+        return true;
+    });
+
+    if (!groupSyncWrite)
+        return GROUP_SYNC_REDONDANT_ID;
+
+    // a reused group still holds the data of its previous write
+    for (size_t i = 0; i < id_list.size(); ++i)
+    {
+        encodeBlocks(i);
+        groupSyncWrite->changeParam(id_list.at(i), params);
+    }
+
+    return groupSyncWrite->txPacket();
+}
+
+/**
+ * @brief AbstractTtlDriver::encodeParams : little endian bytes of a register value
+ * @param data
+ * @param params : at least sizeof(T) bytes
+ */
+template<typename T>
+void AbstractTtlDriver::encodeParams(T data, uint8_t* params)
+{
+    for (size_t b = 0; b < sizeof(T); ++b)
+        params[b] = static_cast<uint8_t>(static_cast<uint32_t>(data) >> (8 * b));
+}
+
+/**
+ * @brief AbstractTtlDriver::addBulkWrite : add the value of a register of a motor to a bulk write
+ * @param bulk_write
+ * @param address
+ * @param id
+ * @param data
+ * @return
+ */
+template<typename T>
+int AbstractTtlDriver::addBulkWrite(dynamixel::GroupBulkWrite& bulk_write, uint16_t address, uint8_t id, T data)
+{
+    bool dxl_senddata_result = false;
+
+    switch (sizeof(T))
+    {
+        case DXL_LEN_ONE_BYTE:
+        {
+            uint8_t params[1] = {static_cast<uint8_t>(data)};
+            dxl_senddata_result = bulk_write.addParam(id, address, DXL_LEN_ONE_BYTE, params);
+        }
+        break;
+        case DXL_LEN_TWO_BYTES:
+        {
+            uint8_t params[2] = {DXL_LOBYTE(static_cast<uint16_t>(data)),
+                                 DXL_HIBYTE(static_cast<uint16_t>(data))};
+            dxl_senddata_result = bulk_write.addParam(id, address, DXL_LEN_TWO_BYTES, params);
+        }
+        break;
+        case DXL_LEN_FOUR_BYTES:
+        {
+            uint8_t params[4] = {DXL_LOBYTE(DXL_LOWORD(data)),
+                                 DXL_HIBYTE(DXL_LOWORD(data)),
+                                 DXL_LOBYTE(DXL_HIWORD(data)),
+                                 DXL_HIBYTE(DXL_HIWORD(data))};
+            dxl_senddata_result = bulk_write.addParam(id, address, DXL_LEN_FOUR_BYTES, params);
+        }
+        break;
+        default:
+            printf("AbstractTtlDriver::addBulkWrite ERROR: Size param must be 1, 2 or 4 bytes\n");
+            return COMM_TX_FAIL;
+    }
+
+    return dxl_senddata_result ? COMM_SUCCESS : GROUP_SYNC_REDONDANT_ID;
+}
+
 } // ttl_driver
 
 #endif // ABSTRACT_TTL_DRIVER_HPP
@@ -17,6 +17,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef DXL_DRIVER_HPP
 #define DXL_DRIVER_HPP
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <string>
@@ -49,9 +50,16 @@ namespace ttl_driver
         std::string str() const override;
         std::string interpretErrorState(uint32_t hw_state) const override;
 
+        int reboot(uint8_t id) override;
+
     public:
         int checkModelNumber(uint8_t id) override;
         int readFirmwareVersion(uint8_t id, std::string &version) override;
+        int readReturnDelayTime(uint8_t id, uint32_t &return_delay_us) override;
+        int writeReturnDelayTime(uint8_t id, uint32_t return_delay_us) override;
+        int writeStatusReturnLevel(uint8_t id, uint8_t status_return_level) override;
+        int writeBaudRate(uint8_t id, int baudrate) override;
+        bool isBaudRateSupported(int baudrate) const override;
 
         int readTemperature(uint8_t id, uint8_t &temperature) override;
         int readVoltage(uint8_t id, double &voltage) override;
@@ -95,13 +103,18 @@ namespace ttl_driver
 
         // ram read
         int readVelocityProfile(uint8_t id, std::vector<uint32_t> &data_list) override;
+        int readTorqueEnable(uint8_t id, uint8_t &torque_enable) override;
 
         int readPosition(uint8_t id, uint32_t &present_position) override;
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
-        int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list) override;
+        int syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list) override;
+
+        int addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id) override;
+        int getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data) override;
+        int addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position) override;
 
     public:
         // AbstractDxlDriver interface
@@ -129,6 +142,15 @@ namespace ttl_driver
 
         int writeTorqueGoal(uint8_t id, uint16_t torque) override;
         int syncWriteTorqueGoal(const std::vector<uint8_t> &id_list, const std::vector<uint16_t> &torque_list) override;
+
+        int syncWriteVelocityProfile(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &data_list) override;
+
+    private:
+        // registers of the joint status, shared by sync and bulk reads
+        static void jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list);
+        static void decodeJointStatus(std::array<uint32_t, 3> &data);
+
+        static int baudRateValue(int baudrate);
     };
 
     // definition of methods
@@ -180,6 +202,23 @@ namespace ttl_driver
         return version;
     }
 
+    /**
+     * @brief DxlDriver<reg_type>::reboot
+     * @param id
+     * @return
+     * The reboot restores the default status return level, STATUS_RETURN_ALL,
+     * which is set before so that the reboot is answered. The TxOnly flag is dropped
+     * even if this write fails : the reboot may then time out although the device restarts
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::reboot(uint8_t id)
+    {
+        if (isTxOnlyWrite(id))
+            writeStatusReturnLevel(id, STATUS_RETURN_ALL);
+
+        return AbstractDxlDriver::reboot(id);
+    }
+
     /**
      * @brief DxlDriver<reg_type>::changeId
      * @param id
@@ -227,6 +266,122 @@ namespace ttl_driver
         uint8_t data{};
         res = read<typename reg_type::TYPE_FIRMWARE_VERSION>(reg_type::ADDR_FIRMWARE_VERSION, id, data);
         version = interpretFirmwareVersion(data);
+
+        if (COMM_SUCCESS == res)
+            setFastSyncReadAvailable(id, reg_type::MIN_FW_FAST_SYNC_READ >= 0 && data >= reg_type::MIN_FW_FAST_SYNC_READ);
+
+        return res;
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::readReturnDelayTime
+     * @param id
+     * @param return_delay_us : the register counts in units of 2 us
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::readReturnDelayTime(uint8_t id, uint32_t &return_delay_us)
+    {
+        typename reg_type::TYPE_RETURN_DELAY_TIME data{};
+        int res = read<typename reg_type::TYPE_RETURN_DELAY_TIME>(reg_type::ADDR_RETURN_DELAY_TIME, id, data);
+        return_delay_us = static_cast<uint32_t>(data) * 2;
+        return res;
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::writeReturnDelayTime
+     * @param id
+     * @param return_delay_us : rounded down to the unit of the register, 2 us
+     * @return
+     * EEPROM : only accepted with the torque disabled
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::writeReturnDelayTime(uint8_t id, uint32_t return_delay_us)
+    {
+        uint32_t data = std::min<uint32_t>(return_delay_us / 2, 254);
+        return write<typename reg_type::TYPE_RETURN_DELAY_TIME>(reg_type::ADDR_RETURN_DELAY_TIME, id, static_cast<typename reg_type::TYPE_RETURN_DELAY_TIME>(data));
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::writeBaudRate
+     * @param id
+     * @param baudrate
+     * @return
+     * EEPROM : only accepted with the torque disabled. The device answers with its current baud rate, then switches
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::writeBaudRate(uint8_t id, int baudrate)
+    {
+        if (!isBaudRateSupported(baudrate))
+            return COMM_NOT_AVAILABLE;
+
+        return write<typename reg_type::TYPE_BAUDRATE>(reg_type::ADDR_BAUDRATE, id, static_cast<typename reg_type::TYPE_BAUDRATE>(baudRateValue(baudrate)));
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::isBaudRateSupported
+     * @param baudrate
+     * @return
+     */
+    template <typename reg_type>
+    bool DxlDriver<reg_type>::isBaudRateSupported(int baudrate) const
+    {
+        return baudrate <= reg_type::MAX_BAUDRATE && baudRateValue(baudrate) >= 0;
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::baudRateValue
+     * @param baudrate
+     * @return value of ADDR_BAUDRATE, the same for all the protocol 2.0 motors, -1 if the baud rate is not in the table
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::baudRateValue(int baudrate)
+    {
+        switch (baudrate)
+        {
+            case 9600:
+                return 0;
+            case 57600:
+                return 1;
+            case 115200:
+                return 2;
+            case 1000000:
+                return 3;
+            case 2000000:
+                return 4;
+            case 3000000:
+                return 5;
+            case 4000000:
+                return 6;
+            case 4500000:
+                return 7;
+            default:
+                return -1;
+        }
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::writeStatusReturnLevel
+     * @param id
+     * @param status_return_level
+     * @return
+     * The motor may answer this write with either level : the answer is waited but ignored, the level is read back.
+     * The next writes are sent without waiting for a status below STATUS_RETURN_ALL
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::writeStatusReturnLevel(uint8_t id, uint8_t status_return_level)
+    {
+        setTxOnlyWrite(id, false);
+        write<typename reg_type::TYPE_STATUS_RETURN_LEVEL>(reg_type::ADDR_STATUS_RETURN_LEVEL, id, status_return_level);
+
+        typename reg_type::TYPE_STATUS_RETURN_LEVEL data{};
+        int res = read<typename reg_type::TYPE_STATUS_RETURN_LEVEL>(reg_type::ADDR_STATUS_RETURN_LEVEL, id, data);
+        if (COMM_SUCCESS == res && data != status_return_level)
+            res = COMM_TX_FAIL;
+
+        // the level is unknown if it could not be read : the writes keep waiting for a status, at worst until their timeout
+        setTxOnlyWrite(id, COMM_SUCCESS == res && status_return_level < STATUS_RETURN_ALL);
+
         return res;
     }
 
@@ -341,6 +496,31 @@ namespace ttl_driver
         return res;
     }
 
+    /**
+     * @brief DxlDriver<reg_type>::syncWriteVelocityProfile
+     * @param id_list
+     * @param data_list [ velocity, acceleration] of each id
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::syncWriteVelocityProfile(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &data_list)
+    {
+        using TYPE_PROFILE = typename reg_type::TYPE_PROFILE;
+        static_assert(reg_type::ADDR_PROFILE_VELOCITY == reg_type::ADDR_PROFILE_ACCELERATION + sizeof(TYPE_PROFILE),
+                      "the velocity profile follows the acceleration profile");
+
+        // both registers in one packet, the acceleration comes first. An incomplete list is rejected by the sync write
+        std::vector<TYPE_PROFILE> profile_list;
+        profile_list.reserve(data_list.size());
+        for (size_t i = 0; i + 1 < data_list.size(); i += 2)
+        {
+            profile_list.emplace_back(data_list.at(i + 1));
+            profile_list.emplace_back(data_list.at(i));
+        }
+
+        return syncWriteConsecutiveBytes<TYPE_PROFILE, 2>(reg_type::ADDR_PROFILE_ACCELERATION, id_list, profile_list);
+    }
+
     /**
      * @brief DxlDriver<reg_type>::writeTorqueEnable
      * @param id
@@ -433,6 +613,18 @@ namespace ttl_driver
         return res;
     }
 
+    /**
+     * @brief DxlDriver<reg_type>::readTorqueEnable
+     * @param id
+     * @param torque_enable
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::readTorqueEnable(uint8_t id, uint8_t &torque_enable)
+    {
+        return read<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id, torque_enable);
+    }
+
     /**
      * @brief DxlDriver<reg_type>::readPosition
      * @param id
@@ -863,43 +1055,106 @@ namespace ttl_driver
     /**
      * @brief DxlDriver::syncReadJointStatus
      * @param id_list
-     * @param data_array_list
+     * @param data_array_list : {position, velocity, load} of each motor
      * @return
+     * present load, velocity and position are consecutive registers, read with a single sync read
      */
     template <typename reg_type>
-    int DxlDriver<reg_type>::syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list)
+    int DxlDriver<reg_type>::syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list)
     {
-        int res = COMM_TX_FAIL;
-
         if (id_list.empty())
-            return res;
+            return COMM_TX_FAIL;
 
-        data_array_list.clear();
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
 
-        // read torque enable on first id
-        typename reg_type::TYPE_TORQUE_ENABLE torque{1};
-        res = read<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id_list.at(0), torque);
-        if (COMM_SUCCESS != res)
-            std::cout << "#############"
-                         " ERROR reading dxl torque in syncReadJointStatus (error "
-                      << res << ")" << std::endl;
+        int res = syncReadFields<3>(address_list, length_list, id_list, data_array_list);
 
-        // if torque on, read position and velocity
-        if (torque)
-        {
-            res = syncReadConsecutiveBytes<uint32_t, 2>(reg_type::ADDR_PRESENT_VELOCITY, id_list, data_array_list);
-        }
-        else // else read position only
-        {
-            std::vector<uint32_t> position_list;
-            res = syncReadPosition(id_list, position_list);
-            for (auto p : position_list)
-                data_array_list.emplace_back(std::array<uint32_t, 2>{0, p});
-        }
+        for (auto &data : data_array_list)
+            decodeJointStatus(data);
+
+        return res;
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::addJointStatusToBulkRead
+     * @param bulk_read
+     * @param id
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id)
+    {
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
+
+        return addBulkReadFields<3>(bulk_read, id, address_list, length_list);
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::getJointStatusFromBulkRead
+     * @param bulk_read
+     * @param id
+     * @param data : {position, velocity, load} of the motor
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data)
+    {
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
+
+        int res = getBulkReadFields<3>(bulk_read, id, address_list, length_list, data);
+        if (COMM_SUCCESS == res)
+            decodeJointStatus(data);
 
         return res;
     }
 
+    /**
+     * @brief DxlDriver<reg_type>::addPositionGoalToBulkWrite
+     * @param bulk_write
+     * @param id
+     * @param position
+     * @return
+     */
+    template <typename reg_type>
+    int DxlDriver<reg_type>::addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position)
+    {
+        return addBulkWrite<typename reg_type::TYPE_GOAL_POSITION>(bulk_write, reg_type::ADDR_GOAL_POSITION, id,
+                                                                   static_cast<typename reg_type::TYPE_GOAL_POSITION>(position));
+    }
+
+    // private
+
+    /**
+     * @brief DxlDriver<reg_type>::jointStatusFields
+     * @param address_list : {position, velocity, load}
+     * @param length_list
+     * present position, velocity and load are consecutive registers, read in a single transaction
+     */
+    template <typename reg_type>
+    void DxlDriver<reg_type>::jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list)
+    {
+        address_list = {reg_type::ADDR_PRESENT_POSITION, reg_type::ADDR_PRESENT_VELOCITY, reg_type::ADDR_PRESENT_LOAD};
+        length_list = {sizeof(typename reg_type::TYPE_PRESENT_POSITION), sizeof(typename reg_type::TYPE_PRESENT_VELOCITY),
+                       sizeof(typename reg_type::TYPE_PRESENT_LOAD)};
+    }
+
+    /**
+     * @brief DxlDriver<reg_type>::decodeJointStatus
+     * @param data : {position, velocity, load}
+     */
+    template <typename reg_type>
+    void DxlDriver<reg_type>::decodeJointStatus(std::array<uint32_t, 3> &data)
+    {
+        // load is a signed 16 bits register
+        data.at(2) = static_cast<uint32_t>(static_cast<int16_t>(data.at(2)));
+    }
+
     /*
      *  -----------------   specializations   --------------------
      */
@@ -974,6 +1229,13 @@ namespace ttl_driver
         return COMM_SUCCESS;
     }
 
+    template <>
+    inline int DxlDriver<XL320Reg>::syncWriteVelocityProfile(const std::vector<uint8_t> & /*id_list*/, const std::vector<uint32_t> & /*data_list*/)
+    {
+        std::cout << "syncWriteVelocityProfile not available for XL320" << std::endl;
+        return COMM_SUCCESS;
+    }
+
     template <>
     inline int DxlDriver<XL320Reg>::readPosition(uint8_t id, uint32_t &present_position)
     {
@@ -1017,30 +1279,18 @@ namespace ttl_driver
     }
 
     /**
-     * @brief DxlDriver::syncReadJointStatus
-     * @param id_list
-     * @param data_array_list
-     * @return
+     * @brief DxlDriver<XL320Reg>::decodeJointStatus
+     * @param data : {position, velocity, load}
      */
     template <>
-    inline int DxlDriver<XL320Reg>::syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list)
+    inline void DxlDriver<XL320Reg>::decodeJointStatus(std::array<uint32_t, 3> &data)
     {
-        int res = COMM_TX_FAIL;
-
-        if (id_list.empty())
-            return res;
-
-        data_array_list.clear();
-
-        std::vector<uint32_t> position_list;
-        res = syncReadPosition(id_list, position_list);
-        if (res == COMM_SUCCESS)
+        // velocity and load are 10 bits magnitudes, the 11th bit gives the direction (clockwise if set)
+        for (size_t i = 1; i < 3; ++i)
         {
-            for (auto p : position_list)
-                data_array_list.emplace_back(std::array<uint32_t, 2>{0, p});
+            auto magnitude = static_cast<int32_t>(data.at(i) & 0x3FF);
+            data.at(i) = static_cast<uint32_t>((data.at(i) & 0x400) ? -magnitude : magnitude);
         }
-
-        return res;
     }
 
     /**
@@ -1402,6 +1652,15 @@ namespace ttl_driver
         return syncRead<typename XM430Reg::TYPE_PRESENT_CURRENT>(XM430Reg::ADDR_PRESENT_CURRENT, id_list, load_list);
     }
 
+    template <>
+    inline void DxlDriver<XM430Reg>::jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list)
+    {
+        // no load register, present current (signed 16 bits too) is read instead
+        address_list = {XM430Reg::ADDR_PRESENT_POSITION, XM430Reg::ADDR_PRESENT_VELOCITY, XM430Reg::ADDR_PRESENT_CURRENT};
+        length_list = {sizeof(typename XM430Reg::TYPE_PRESENT_POSITION), sizeof(typename XM430Reg::TYPE_PRESENT_VELOCITY),
+                       sizeof(typename XM430Reg::TYPE_PRESENT_CURRENT)};
+    }
+
     // XL330
 
     template <>
@@ -1475,6 +1734,15 @@ namespace ttl_driver
         return syncRead<typename XL330Reg::TYPE_PRESENT_CURRENT>(XL330Reg::ADDR_PRESENT_CURRENT, id_list, load_list);
     }
 
+    template <>
+    inline void DxlDriver<XL330Reg>::jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list)
+    {
+        // no load register, present current (signed 16 bits too) is read instead
+        address_list = {XL330Reg::ADDR_PRESENT_POSITION, XL330Reg::ADDR_PRESENT_VELOCITY, XL330Reg::ADDR_PRESENT_CURRENT};
+        length_list = {sizeof(typename XL330Reg::TYPE_PRESENT_POSITION), sizeof(typename XL330Reg::TYPE_PRESENT_VELOCITY),
+                       sizeof(typename XL330Reg::TYPE_PRESENT_CURRENT)};
+    }
+
     template <>
     inline int DxlDriver<XL330Reg>::writeTemperatureLimit(uint8_t id, uint8_t temperature_limit)
     {
@@ -81,6 +81,7 @@ namespace ttl_driver
 
         // ram read
         int readVelocityProfile(uint8_t id, std::vector<uint32_t> &data_list) override;
+        int readTorqueEnable(uint8_t id, uint8_t &torque_enable) override;
 
         int readPosition(uint8_t id, uint32_t &present_position) override;
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
@@ -90,7 +91,11 @@ namespace ttl_driver
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
-        int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list) override;
+        int syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list) override;
+
+        int addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id) override;
+        int getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data) override;
+        int addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position) override;
 
         int syncReadFirmwareVersion(const std::vector<uint8_t> &id_list, std::vector<std::string> &firmware_list) override;
         int syncReadTemperature(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &temperature_list) override;
@@ -112,6 +117,7 @@ namespace ttl_driver
         int syncWriteLed(const std::vector<uint8_t> &id_list, const std::vector<uint8_t> &led_list) override;
         int writeTorqueGoal(uint8_t id, uint16_t torque) override;
         int syncWriteTorqueGoal(const std::vector<uint8_t> &id_list, const std::vector<uint16_t> &torque_list) override;
+        int syncWriteVelocityProfile(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &data_list) override;
 
         int readLoad(uint8_t id, uint16_t &present_load) override;
         int syncReadLoad(const std::vector<uint8_t> &id_list, std::vector<uint16_t> &load_list) override;
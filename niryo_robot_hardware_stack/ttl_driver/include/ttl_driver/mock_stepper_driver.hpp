@@ -74,12 +74,17 @@ class MockStepperDriver : public AbstractStepperDriver
         int readVoltage(uint8_t id, double &voltage) override;
         int readHwErrorStatus(uint8_t id, uint8_t& hardware_error_status) override;
 
+        int readTorqueEnable(uint8_t id, uint8_t &torque_enable) override;
         int readPosition(uint8_t id, uint32_t &present_position) override;
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
-        int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2> >& data_array) override;
+        int syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList& data_array) override;
+
+        int addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id) override;
+        int getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data) override;
+        int addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position) override;
 
         int syncReadFirmwareVersion(const std::vector<uint8_t> &id_list, std::vector<std::string> &firmware_list) override;
         int syncReadTemperature(const std::vector<uint8_t> &id_list, std::vector<uint8_t>& temperature_list) override;
@@ -18,6 +18,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #define STEPPER_DRIVER_HPP
 
 #include <memory>
+#include <set>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -47,6 +48,7 @@ namespace ttl_driver
 
         int checkModelNumber(uint8_t id) override;
         int readFirmwareVersion(uint8_t id, std::string &version) override;
+        int reboot(uint8_t id) override;
 
         int readTemperature(uint8_t id, uint8_t &temperature) override;
         int readVoltage(uint8_t id, double &voltage) override;
@@ -79,12 +81,17 @@ namespace ttl_driver
         int syncWriteVelocityGoal(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &velocity_list) override;
 
         // ram read
+        int readTorqueEnable(uint8_t id, uint8_t &torque_enable) override;
         int readPosition(uint8_t id, uint32_t &present_position) override;
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
-        int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list) override;
+        int syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list) override;
+
+        int addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id) override;
+        int getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data) override;
+        int addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position) override;
 
         // AbstractStepperDriver interface
     public:
@@ -103,6 +110,10 @@ namespace ttl_driver
         int syncWriteHomingAbsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &abs_position) override;
 
     private:
+        // registers of the joint status, shared by sync and bulk reads
+        static void jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list);
+        void setTorqueState(uint8_t id, uint8_t torque_enable);
+
         int writeVStart(uint8_t id, uint32_t v_start);
         int writeA1(uint8_t id, uint32_t a_1);
         int writeV1(uint8_t id, uint32_t v_1);
@@ -111,6 +122,11 @@ namespace ttl_driver
         int writeDMax(uint8_t id, uint32_t d_max);
         int writeD1(uint8_t id, uint32_t d_1);
         int writeVStop(uint8_t id, uint32_t v_stop);
+
+    private:
+        // steppers whose torque is known to be disabled, given by the torque writes and reads of the driver :
+        // their present velocity is not measured, it is reported as 0 in the joint status
+        std::set<uint8_t> _torque_off_ids;
     };
 
     // definition of methods
@@ -194,6 +210,22 @@ namespace ttl_driver
         return res;
     }
 
+    /**
+     * @brief StepperDriver<reg_type>::reboot
+     * @param id
+     * @return
+     * The RAM registers restart at their default values : the torque is disabled
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::reboot(uint8_t id)
+    {
+        int res = AbstractStepperDriver::reboot(id);
+        if (COMM_SUCCESS == res)
+            setTorqueState(id, 0);
+
+        return res;
+    }
+
     /**
      * @brief StepperDriver<reg_type>::readMinPosition
      * @param id
@@ -229,7 +261,11 @@ namespace ttl_driver
     template <typename reg_type>
     int StepperDriver<reg_type>::writeTorqueEnable(uint8_t id, uint8_t torque_enable)
     {
-        return write<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id, torque_enable);
+        int res = write<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id, torque_enable);
+        if (COMM_SUCCESS == res)
+            setTorqueState(id, torque_enable);
+
+        return res;
     }
 
     /**
@@ -266,7 +302,14 @@ namespace ttl_driver
     template <typename reg_type>
     int StepperDriver<reg_type>::syncWriteTorqueEnable(const std::vector<uint8_t> &id_list, const std::vector<uint8_t> &torque_enable_list)
     {
-        return syncWrite<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id_list, torque_enable_list);
+        int res = syncWrite<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id_list, torque_enable_list);
+        if (COMM_SUCCESS == res)
+        {
+            for (size_t i = 0; i < id_list.size() && i < torque_enable_list.size(); ++i)
+                setTorqueState(id_list.at(i), torque_enable_list.at(i));
+        }
+
+        return res;
     }
 
     /**
@@ -295,6 +338,22 @@ namespace ttl_driver
 
     // ram read
 
+    /**
+     * @brief StepperDriver<reg_type>::readTorqueEnable
+     * @param id
+     * @param torque_enable
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::readTorqueEnable(uint8_t id, uint8_t &torque_enable)
+    {
+        int res = read<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id, torque_enable);
+        if (COMM_SUCCESS == res)
+            setTorqueState(id, torque_enable);
+
+        return res;
+    }
+
     /**
      * @brief StepperDriver<reg_type>::readPosition
      * @param id
@@ -385,45 +444,87 @@ namespace ttl_driver
     /**
      * @brief StepperDriver<reg_type>::syncReadJointStatus
      * @param id_list
-     * @param data_array_list
+     * @param data_array_list : {position, velocity, load} of each motor
      * @return
-     * reads both position and velocity if torque is enabled. Reads only position otherwise
+     * the velocity of a motor with the torque disabled is 0
      */
     template <typename reg_type>
     int StepperDriver<reg_type>::syncReadJointStatus(const std::vector<uint8_t> &id_list,
-                                                     std::vector<std::array<uint32_t, 2>> &data_array_list)
+                                                     JointStatusList &data_array_list)
     {
-        int res = COMM_TX_FAIL;
-
         if (id_list.empty())
-            return res;
-
-        data_array_list.clear();
+            return COMM_TX_FAIL;
 
-        // read torque enable on first id
-        typename reg_type::TYPE_TORQUE_ENABLE torque{1};
-        res = read<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id_list.at(0), torque);
-        if (COMM_SUCCESS != res)
-            std::cout << "#############"
-                         " ERROR reading stepper torque in syncReadJointStatus (error "
-                      << res << ")" << std::endl;
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
 
-        // if torque on, read position and velocity
-        if (torque)
-        {
-            res = syncReadConsecutiveBytes<uint32_t, 2>(reg_type::ADDR_PRESENT_VELOCITY, id_list, data_array_list);
-        }
-        else // else read position only
+        int res = syncReadFields<3>(address_list, length_list, id_list, data_array_list);
+        if (COMM_SUCCESS == res && !_torque_off_ids.empty())
         {
-            std::vector<uint32_t> position_list;
-            res = syncReadPosition(id_list, position_list);
-            for (auto p : position_list)
-                data_array_list.emplace_back(std::array<uint32_t, 2>{1, p});
+            auto data = data_array_list.begin();
+            for (auto const id : id_list)
+            {
+                if (_torque_off_ids.count(id))
+                    data->at(1) = 0;
+                ++data;
+            }
         }
 
         return res;
     }
 
+    /**
+     * @brief StepperDriver<reg_type>::addJointStatusToBulkRead
+     * @param bulk_read
+     * @param id
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::addJointStatusToBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id)
+    {
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
+
+        return addBulkReadFields<3>(bulk_read, id, address_list, length_list);
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::getJointStatusFromBulkRead
+     * @param bulk_read
+     * @param id
+     * @param data : {position, velocity, load} of the motor
+     * @return
+     * the velocity of a motor with the torque disabled is 0
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::getJointStatusFromBulkRead(dynamixel::GroupBulkRead &bulk_read, uint8_t id, std::array<uint32_t, 3> &data)
+    {
+        std::array<uint16_t, 3> address_list{};
+        std::array<uint8_t, 3> length_list{};
+        jointStatusFields(address_list, length_list);
+
+        int res = getBulkReadFields<3>(bulk_read, id, address_list, length_list, data);
+        if (COMM_SUCCESS == res && _torque_off_ids.count(id))
+            data.at(1) = 0;
+
+        return res;
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::addPositionGoalToBulkWrite
+     * @param bulk_write
+     * @param id
+     * @param position
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &bulk_write, uint8_t id, uint32_t position)
+    {
+        return addBulkWrite<typename reg_type::TYPE_GOAL_POSITION>(bulk_write, reg_type::ADDR_GOAL_POSITION, id, position);
+    }
+
     /**
      * @brief StepperDriver<reg_type>::syncReadFirmwareVersion
      * @param id_list
@@ -791,6 +892,34 @@ namespace ttl_driver
 
     // private
 
+    /**
+     * @brief StepperDriver<reg_type>::jointStatusFields
+     * @param address_list : {position, velocity, load}
+     * @param length_list
+     * present velocity and position are consecutive registers, read in a single transaction. There is no load register,
+     * the load is an absent field, always 0
+     */
+    template <typename reg_type>
+    void StepperDriver<reg_type>::jointStatusFields(std::array<uint16_t, 3> &address_list, std::array<uint8_t, 3> &length_list)
+    {
+        address_list = {reg_type::ADDR_PRESENT_POSITION, reg_type::ADDR_PRESENT_VELOCITY, ABSENT_FIELD_ADDRESS};
+        length_list = {sizeof(typename reg_type::TYPE_PRESENT_POSITION), sizeof(typename reg_type::TYPE_PRESENT_VELOCITY), ABSENT_FIELD_LENGTH};
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::setTorqueState
+     * @param id
+     * @param torque_enable : value written to or read from the torque enable register
+     */
+    template <typename reg_type>
+    void StepperDriver<reg_type>::setTorqueState(uint8_t id, uint8_t torque_enable)
+    {
+        if (torque_enable)
+            _torque_off_ids.erase(id);
+        else
+            _torque_off_ids.insert(id);
+    }
+
     /**
      * @brief StepperDriver<reg_type>::writeVStart
      * @param id
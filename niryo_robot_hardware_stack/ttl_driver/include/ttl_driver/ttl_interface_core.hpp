@@ -21,11 +21,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #define TTL_INTERFACE_CORE_HPP
 
 // std
+#include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
-#include <queue>
 #include <functional>
 #include <vector>
 #include <mutex>
@@ -36,8 +37,14 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 
 #include "common/util/i_driver_core.hpp"
 #include "common/util/i_interface_core.hpp"
+#include "common/util/loop_metrics.hpp"
+#include "common/util/loop_timer.hpp"
+#include "common/util/rt_thread_config.hpp"
+#include "common/util/mpsc_priority_queue.hpp"
+#include "common/util/triple_buffer.hpp"
 
 #include "ttl_driver/ttl_manager.hpp"
+#include "ttl_driver/ttl_transaction_scheduler.hpp"
 #include "ttl_driver/ArrayMotorHardwareStatus.h"
 #include "ttl_driver/WriteCustomValue.h"
 #include "ttl_driver/ReadCustomValue.h"
@@ -45,8 +52,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "ttl_driver/ReadPIDValue.h"
 #include "ttl_driver/WriteVelocityProfile.h"
 #include "ttl_driver/ReadVelocityProfile.h"
+#include "ttl_driver/SetFrequencies.h"
+#include "ttl_driver/GetFrequencies.h"
 
+#include "niryo_robot_msgs/BusMetrics.h"
 #include "niryo_robot_msgs/BusState.h"
+#include "niryo_robot_msgs/LoopMetrics.h"
 #include "niryo_robot_msgs/SetInt.h"
 #include "niryo_robot_msgs/CommandStatus.h"
 
@@ -56,6 +67,8 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "common/model/tool_state.hpp"
 
 #include "common/model/hardware_type_enum.hpp"
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/model/joint_trajectory_cmd.hpp"
 
 #include "ttl_driver/abstract_motor_driver.hpp"
 
@@ -85,11 +98,9 @@ namespace ttl_driver
 
         bool init(ros::NodeHandle &nh) override;
 
-        void clearSingleCommandQueue();
-        void clearConveyorCommandQueue();
-        void clearSyncCommandQueue();
+        void clearCommandQueue();
 
-        void setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, uint32_t>> &&cmd);
+        void setTrajectoryControllerCommands(const common::model::TtlJointTrajectoryCmd &cmd);
 
         void addSyncCommandToQueue(std::unique_ptr<common::model::ISynchronizeMotorCmd> &&cmd) override;
 
@@ -117,6 +128,9 @@ namespace ttl_driver
 
         // direct commands
         bool rebootHardware(const std::shared_ptr<common::model::AbstractHardwareState> &hw_state) override;
+        bool isBaudRateNegotiable() const;
+        int negotiateBaudRate();
+        bool calibrateBusRates();
 
         // getters
         std::vector<uint8_t> getRemovedMotorList() const override;
@@ -146,6 +160,8 @@ namespace ttl_driver
 
         // read Collision Status from motors
         bool getCollisionStatus() const;
+        uint32_t getOverwrittenTrajectoryCmdCount() const;
+        const common::model::JointStatesSnapshot& getJointStatesSnapshot();
         void waitSyncQueueFree();
         void waitSingleQueueFree();
 
@@ -161,6 +177,11 @@ namespace ttl_driver
         void controlLoop() override;
         void _executeCommand() override;
 
+        void updateTransactionCosts();
+        bool pushCommand(size_t priority, std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &&single_cmd,
+                         std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &&sync_cmd);
+        double commitTransaction(ETtlTransaction transaction, double start_time);
+
         int motorScanReport(uint8_t motor_id);
         int motorCmdReport(const common::model::JointState &jState, common::model::EHardwareType motor_type);
 
@@ -175,13 +196,29 @@ namespace ttl_driver
         bool _callbackWriteVelocityProfile(ttl_driver::WriteVelocityProfile::Request &req, ttl_driver::WriteVelocityProfile::Response &res);
         bool _callbackReadVelocityProfile(ttl_driver::ReadVelocityProfile::Request &req, ttl_driver::ReadVelocityProfile::Response &res);
 
+        bool _callbackSetFrequencies(ttl_driver::SetFrequencies::Request &req, ttl_driver::SetFrequencies::Response &res);
+        bool _callbackGetFrequencies(ttl_driver::GetFrequencies::Request &req, ttl_driver::GetFrequencies::Response &res);
+
         void _publishCollisionStatus(const ros::TimerEvent &);
+        void _publishBusMetrics(const ros::TimerEvent &);
+        void _publishLoopMetrics(const ros::TimerEvent &);
 
     private:
         ros::Publisher _collision_status_publisher;
         ros::Timer _collision_status_publisher_timer;
         ros::Duration _collision_status_publisher_duration{0.01};
 
+        ros::Publisher _bus_metrics_publisher;
+        ros::Timer _bus_metrics_publisher_timer;
+        ros::Duration _bus_metrics_publisher_duration{1.0};
+
+        ros::Publisher _loop_metrics_publisher;
+        ros::Timer _loop_metrics_publisher_timer;
+        ros::Duration _loop_metrics_publisher_duration{1.0};
+
+        // stages of the control loop: UPDATE is the wait for the loop mutex and the planning of the cycle, WRITE the trajectory and the queued commands
+        common::util::LoopMetrics _loop_metrics{"ttl_control_loop"};
+
         std::string _hardware_version;
 
         bool _control_loop_flag{false};
@@ -190,40 +227,59 @@ namespace ttl_driver
         bool _collision_detected{false};
 
         mutable std::mutex _control_loop_mutex;
-        mutable std::mutex _single_cmd_queue_mutex;
-        mutable std::mutex _conveyor_cmd_queue_mutex;
-        mutable std::mutex _sync_cmd_queue_mutex;
 
         std::thread _control_loop_thread;
 
         double _control_loop_frequency{0.0};
-
-        double _delta_time_data_read{0.0};
-        double _delta_time_end_effector_read{0.0};
-        double _delta_time_write{0.0};
-
-        double _time_hw_data_last_read{0.0};
-        double _time_hw_end_effector_last_read{0.0};
-        double _time_hw_data_last_write{0.0};
-
-        double _time_check_connection_last_read{0.0};
-
-        // specific to dxl
-        double _delta_time_status_read{0.0};
-        double _time_hw_status_last_read{0.0};
-
-        double _time_check_end_effector_last_read{0.0};
+        // set when the control loop frequency is changed, taken into account by the control loop at its next cycle
+        bool _control_loop_frequency_changed{false};
+        common::util::RtThreadConfig _control_loop_rt_config;
+
+        // startup selection of the rates from the measured costs of the transactions
+        bool _rates_calibration_enabled{false};
+        int _rates_calibration_nb_samples{20};
+        double _min_control_loop_frequency{0.0};
+        double _max_control_loop_frequency{0.0};
+        double _max_bus_occupancy{1.0};
+        // frequencies kept as configured by the calibration, by name
+        std::map<std::string, double> _rates_overrides;
+
+        // plan of the bus transactions (write, read, status, end effector) of each cycle
+        TtlTransactionScheduler _transaction_scheduler;
 
         std::unique_ptr<TtlManager> _ttl_manager;
 
-        std::vector<std::pair<uint8_t, uint32_t>> _joint_trajectory_cmd;
-
-        // ttl cmds
-        // TODO(CC) it seems like having two queues can lead to pbs if a sync is launched before the sincle queue is finished
-        // and vice versa. So having a unique queue would be preferable (see calibration)
-        std::queue<std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd>> _sync_cmds_queue;
-        std::queue<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> _single_cmds_queue;
-        std::queue<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> _conveyor_cmds_queue;
+        // latest setpoints written by ros_control, taken by the control loop
+        common::util::TripleBuffer<common::model::TtlJointTrajectoryCmd> _joint_trajectory_cmd;
+
+        // joints states published by the control loop at the end of each joints read, taken by ros_control
+        common::util::TripleBuffer<common::model::JointStatesSnapshot> _joint_states_snapshot;
+
+        // ttl cmds : element of the commands queue, holds either a single or a synchronized command
+        struct TtlCommand
+        {
+            size_t priority{0};
+            std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> single_cmd;
+            std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> sync_cmd;
+        };
+
+        // priorities of the commands queue. Single and sync commands for motors share the same priority
+        // to be executed in the order they have been added (see calibration)
+        static constexpr size_t MOTOR_CMD_PRIORITY = 0;
+        static constexpr size_t CONVEYOR_CMD_PRIORITY = 1;
+        static constexpr size_t NB_CMD_PRIORITIES = 2;
+        static constexpr size_t CMD_QUEUE_CAPACITY = 64;
+        // max number of consecutive single commands given at once to the ttl manager to be merged into sync writes
+        static constexpr size_t MAX_MERGED_SINGLE_CMDS = 16;
+
+        // commands are pushed by services threads and executed by the control loop thread (only consumer)
+        common::util::MpscPriorityQueue<TtlCommand, CMD_QUEUE_CAPACITY, NB_CMD_PRIORITIES> _cmd_queue;
+        // number of motors commands added and not executed yet
+        std::atomic<int> _nb_pending_motor_cmds{0};
+        // end of the bus budget of the current cycle for the queued commands
+        double _cmd_queue_deadline{0.0};
+        // consecutive single commands popped from the queue, reused at each cycle
+        std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> > _single_cmds_batch;
 
         ros::ServiceServer _activate_leds_server;
 
@@ -238,8 +294,6 @@ namespace ttl_driver
 
         ros::ServiceServer _frequencies_setter;
         ros::ServiceServer _frequencies_getter;
-
-        static constexpr int QUEUE_OVERFLOW = 20;
     };
 
     /**
@@ -280,6 +334,27 @@ namespace ttl_driver
         return _ttl_manager->getCollisionStatus();
     }
 
+    /**
+     * @brief TtlInterfaceCore::getOverwrittenTrajectoryCmdCount
+     * @return number of setpoints replaced by a newer one before being sent to the motors
+     */
+    inline uint32_t TtlInterfaceCore::getOverwrittenTrajectoryCmdCount() const
+    {
+        return _joint_trajectory_cmd.getOverwrittenCount();
+    }
+
+    /**
+     * @brief TtlInterfaceCore::getJointStatesSnapshot : newest joints states published by the control loop
+     * Never blocks the control loop. Only one reader thread is allowed (ros_control),
+     * the reference stays valid until its next call
+     * @return states of all joints at the end of the same read cycle, never mixed between cycles
+     */
+    inline const common::model::JointStatesSnapshot& TtlInterfaceCore::getJointStatesSnapshot()
+    {
+        _joint_states_snapshot.consume();
+        return _joint_states_snapshot.getReadBuffer();
+    }
+
     /**
      * @brief TtlInterfaceCore::setCalibrationStatus
      */
@@ -22,8 +22,13 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 
 #include "common/util/util_defs.hpp"
 #include "common/util/i_bus_manager.hpp"
+#include "common/util/bus_metrics.hpp"
+#include "common/util/goal_delta_filter.hpp"
 
 // cpp
+#include <array>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <ros/ros.h>
 #include <string>
@@ -33,12 +38,14 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include <algorithm>
 #include <set>
 #include <utility>
+#include <vector>
 
 // ros
 #include "ros/node_handle.h"
 
 // niryo
 #include "dynamixel_sdk/dynamixel_sdk.h"
+#include "niryo_robot_msgs/BusMetrics.h"
 #include "niryo_robot_msgs/MotorHeader.h"
 #include "niryo_robot_msgs/SetInt.h"
 #include "niryo_robot_msgs/CommandStatus.h"
@@ -46,9 +53,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "ttl_driver/abstract_motor_driver.hpp"
 #include "ttl_driver/abstract_stepper_driver.hpp"
 #include "ttl_driver/fake_ttl_data.hpp"
+#include "ttl_driver/ttl_transaction_scheduler.hpp"
 #include "ttl_driver/MotorCommand.h"
 
 #include "common/model/dxl_motor_state.hpp"
+#include "common/model/joint_states_snapshot.hpp"
+#include "common/model/joint_trajectory_cmd.hpp"
 #include "common/model/synchronize_motor_cmd.hpp"
 #include "common/model/single_motor_cmd.hpp"
 #include "common/model/stepper_calibration_status_enum.hpp"
@@ -106,18 +116,27 @@ public:
     size_t getNbMotors() const override;
     void getBusState(bool& connection_state, std::vector<uint8_t>& motor_id, std::string& debug_msg) const override;
     std::string getErrorMessage() const override;
+    niryo_robot_msgs::BusMetrics getBusMetrics();
 
     // commands
 
     int changeId(common::model::EHardwareType motor_type, uint8_t old_id, uint8_t new_id);
 
     int writeSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd >&& cmd);
+    int startSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd >&& cmd);
+    int processSynchronizeCommand();
+    void cancelSynchronizeCommand();
+    bool hasPendingSynchronizeCommand() const;
     int writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >&& cmd);
+    int writeSingleCommands(std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> >&& cmds);
 
-    void executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, uint32_t> > cmd_vec);
+    void executeJointTrajectoryCmd(const common::model::TtlJointTrajectoryCmd &cmd_vec);
 
     int rebootHardware(uint8_t id);
 
+    bool isBaudRateNegotiable() const;
+    int negotiateBaudRate();
+
     int setLeds(int led);
 
     int sendCustomCommand(uint8_t id, int reg_address, int value, int byte_number);
@@ -162,6 +181,7 @@ public:
 
     std::vector<std::shared_ptr<common::model::JointState> > getMotorsStates() const;
     std::shared_ptr<common::model::AbstractHardwareState> getHardwareState(uint8_t motor_id) const;
+    const common::model::JointStatesSnapshot& getJointStatesSnapshot() const;
 
     std::vector<uint8_t> getRemovedMotorList() const override;
 
@@ -169,6 +189,15 @@ public:
 
     bool hasEndEffector() const;
 
+    uint32_t getLastSyncCmdCycles() const;
+    uint32_t getMaxSyncCmdCycles() const;
+
+    bool isBulkTransactionsEnabled() const;
+
+    // bus scheduling
+    double estimateTransactionCost(ETtlTransaction transaction) const;
+    double measureTransactionCost(ETtlTransaction transaction, unsigned int nb_samples);
+
 private:
     // IBusManager Interface
     int setupCommunication() override;
@@ -181,19 +210,50 @@ private:
 
     // check if hardware is a motor or not
     // this helps get only one driver to use for all motors to get/set on the same address
-    bool isMotorType(common::model::EHardwareType type);
+    bool isMotorType(common::model::EHardwareType type) const;
 
     bool checkCollision();
 
+    // joints status transactions
+    uint8_t syncReadJointsStatus();
+    bool bulkReadJointsStatus();
+    bool bulkWritePositionGoals(const common::model::TtlJointTrajectoryCmd &cmd_vec);
+    void setJointStatus(uint8_t id, const std::array<uint32_t, 3> &joint_status, double read_stamp);
+
+    // timing registers of a component, and its timing in the port handler
+    void setupComponentTiming(uint8_t id, common::model::EHardwareType hardware_type);
+
+    // baud rate of the bus
+    bool probeBaudRate(int baudrate);
+    int switchBaudRate(const std::vector<uint8_t> &id_list, int baudrate);
+    int disableTorque(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_ids);
+    void restoreTorque(const std::vector<uint8_t> &torque_ids);
+    int readSavedBaudRate() const;
+    void saveBaudRate(int baudrate) const;
+
+    static common::util::EBusResult toBusResult(int comm_result);
+
+    class SyncCmdRetryMachineState;
+    int stepSynchronizeCommand(const common::model::AbstractTtlSynchronizeMotorCmd &cmd, SyncCmdRetryMachineState &retry_state);
+
 private:
     ros::NodeHandle _nh;
     std::shared_ptr<dynamixel::PortHandler> _portHandler;
     std::shared_ptr<dynamixel::PacketHandler> _packetHandler;
+    // records the bytes of the bus when bus_params/trace_file is set
+    std::unique_ptr<dynamixel::PacketTracer> _packet_tracer;
 
     mutable std::mutex _sync_mutex;
 
     std::string _device_name;
     int _baudrate{1000000};
+    // the negotiated baud rate is saved, to be probed first at the next start
+    int _max_baudrate{1000000};
+    int _bus_baudrate{1000000};
+    std::string _baudrate_file;
+
+    // durations and results of the transactions, read by the publisher of TtlInterfaceCore
+    common::util::BusMetrics _bus_metrics{"ttl"};
 
     std::vector<uint8_t> _all_ids_connected; // with all ttl motors connected (including the tool)
     std::vector<uint8_t> _removed_motor_id_list;
@@ -220,12 +280,36 @@ private:
     uint32_t _hw_fail_counter_read{0};
     uint32_t _end_effector_fail_counter_read{0};
 
+    // joints states of the last read cycle, only accessed under the control loop mutex of TtlInterfaceCore
+    common::model::JointStatesSnapshot _joint_states;
+
     int _led_state = 0;
     std::string _led_motor_type_cfg;
 
     static constexpr uint32_t MAX_HW_FAILURE = 150;
     static constexpr uint32_t MAX_READ_EE_FAILURE = 150;
 
+    // bulk transactions address the motors of all types in a single packet, each one with its own registers
+    bool _use_bulk_transactions{false};
+    std::unique_ptr<dynamixel::GroupBulkRead> _bulk_read;
+    std::unique_ptr<dynamixel::GroupBulkWrite> _bulk_write;
+    // motors of the bulk read, rebuilt only when the motors of the bus change
+    std::vector<std::pair<uint8_t, std::shared_ptr<ttl_driver::AbstractMotorDriver> > > _bulk_read_motors;
+    // joint status decoded from the bulk read, one per motor, committed to the states once all of them are decoded
+    std::vector<std::array<uint32_t, 3> > _bulk_read_status;
+    bool _bulk_read_outdated{true};
+    // consecutive bulk reads failing while sync reads succeed
+    uint32_t _bulk_fail_counter{0};
+
+    static constexpr uint32_t MAX_BULK_FAILURE = 10;
+
+    // goals of the trajectory already written to the motors are not written again (opt-in)
+    common::util::GoalDeltaFilter<uint32_t> _goal_delta_filter;
+
+    // bus performance profile : minimal return delay time, and no status packet for the writes
+    bool _use_bus_performance_profile{false};
+    uint32_t _profile_return_delay_us{0};
+
     // at init, no hw, so no calib needed
     common::model::EStepperCalibrationStatus _calibration_status{common::model::EStepperCalibrationStatus::OK};
 
@@ -293,6 +377,106 @@ private:
 
     CalibrationMachineState _calib_machine_state;
 
+    /**
+     * @brief The SyncCmdRetryMachineState class tracks the drivers of a sync command not written yet
+     * A failing driver is retried at a later cycle, the delay between two attempts is doubled after each failure
+     */
+    class SyncCmdRetryMachineState
+    {
+
+    public:
+        void start(const std::set<common::model::EHardwareType> &types)
+        {
+            _retry_map.clear();
+            for (auto const type : types)
+                _retry_map.insert(std::make_pair(type, DriverRetry()));
+
+            _nb_cycles = 0;
+            _result = COMM_SUCCESS;
+        }
+
+        /**
+         * @brief nextCycle : to be called once per attempt cycle, gives the pending drivers to write
+         * @param now
+         * @return types of the drivers whose backoff delay is over
+         */
+        std::vector<common::model::EHardwareType> nextCycle(double now)
+        {
+            std::vector<common::model::EHardwareType> due_types;
+            for (auto const &it : _retry_map)
+            {
+                if (now >= it.second.next_attempt_time)
+                    due_types.emplace_back(it.first);
+            }
+
+            _nb_cycles++;
+            return due_types;
+        }
+
+        void success(common::model::EHardwareType type)
+        {
+            _retry_map.erase(type);
+        }
+
+        /**
+         * @brief failure : delay the next attempt of this driver, or give it up after too many attempts
+         * @return false if the driver is given up
+         */
+        bool failure(common::model::EHardwareType type, int result, double now)
+        {
+            DriverRetry &retry = _retry_map.at(type);
+            retry.nb_attempts++;
+
+            if (retry.nb_attempts >= MAX_ATTEMPTS)
+            {
+                _retry_map.erase(type);
+                _result = result;
+                return false;
+            }
+
+            double backoff = BACKOFF_MIN * static_cast<double>(1u << (retry.nb_attempts - 1));
+            retry.next_attempt_time = now + (backoff < BACKOFF_MAX ? backoff : BACKOFF_MAX);
+            return true;
+        }
+
+        bool isPending() const
+        {
+            return !_retry_map.empty();
+        }
+
+        uint32_t getNbCycles() const
+        {
+            return _nb_cycles;
+        }
+
+        int getResult() const
+        {
+            return _result;
+        }
+
+    private:
+        struct DriverRetry
+        {
+            uint32_t nb_attempts{0};
+            double next_attempt_time{0.0};
+        };
+
+        std::map<common::model::EHardwareType, DriverRetry> _retry_map;
+        uint32_t _nb_cycles{0};
+        int _result{COMM_SUCCESS};
+
+        static constexpr uint32_t MAX_ATTEMPTS = 10;
+        static constexpr double BACKOFF_MIN = 0.002;
+        static constexpr double BACKOFF_MAX = 0.1;
+    };
+
+    // sync command written by the control loop, retried over several cycles
+    std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> _pending_sync_cmd;
+    SyncCmdRetryMachineState _sync_cmd_retry;
+
+    // number of cycles needed by sync commands to be fully written, written by the control loop, read by the bus metrics
+    std::atomic<uint32_t> _last_sync_cmd_cycles{0};
+    std::atomic<uint32_t> _max_sync_cmd_cycles{0};
 };
 
 // inline getters
@@ -327,6 +511,46 @@ std::vector<uint8_t> TtlManager::getRemovedMotorList() const
     return _removed_motor_id_list;
 }
 
+/**
+ * @brief TtlManager::hasPendingSynchronizeCommand
+ * @return true if a sync command is waiting for its drivers to be retried
+ */
+inline
+bool TtlManager::hasPendingSynchronizeCommand() const
+{
+    return _pending_sync_cmd != nullptr;
+}
+
+/**
+ * @brief TtlManager::getLastSyncCmdCycles
+ * @return number of cycles needed by the last sync command to be written
+ */
+inline
+uint32_t TtlManager::getLastSyncCmdCycles() const
+{
+    return _last_sync_cmd_cycles.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief TtlManager::getMaxSyncCmdCycles
+ * @return max number of cycles needed by a sync command to be written
+ */
+inline
+uint32_t TtlManager::getMaxSyncCmdCycles() const
+{
+    return _max_sync_cmd_cycles.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief TtlManager::isBulkTransactionsEnabled
+ * @return false in simulation, when disabled by config or when the motors do not answer to bulk reads
+ */
+inline
+bool TtlManager::isBulkTransactionsEnabled() const
+{
+    return _use_bulk_transactions;
+}
+
 /**
  * @brief TtlManager::getErrorMessage
  * @return
@@ -447,6 +671,17 @@ bool TtlManager::getCollisionStatus() const
     return _collision_status;
 }
 
+/**
+ * @brief TtlManager::getJointStatesSnapshot : joints states of the last read cycle
+ * Not thread safe, use TtlInterfaceCore::getJointStatesSnapshot from other threads
+ * @return
+ */
+inline
+const common::model::JointStatesSnapshot& TtlManager::getJointStatesSnapshot() const
+{
+    return _joint_states;
+}
+
 } // ttl_driver
 
 #endif // TTLDRIVER_HPP
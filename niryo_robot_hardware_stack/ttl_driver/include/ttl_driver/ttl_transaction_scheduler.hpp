@@ -0,0 +1,272 @@
+/*
+ttl_transaction_scheduler.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef TTL_TRANSACTION_SCHEDULER_HPP
+#define TTL_TRANSACTION_SCHEDULER_HPP
+
+// std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ttl_driver
+{
+
+/**
+ * @brief The ETtlTransaction enum lists the bus transactions done by the ttl control loop
+ * They are sorted by decreasing priority
+ */
+enum class ETtlTransaction
+{
+    TRAJECTORY_WRITE = 0,
+    JOINTS_READ,
+    END_EFFECTOR_READ,
+    HW_STATUS_READ,
+    NB_TRANSACTIONS
+};
+
+/**
+ * @brief The TtlTransactionScheduler class turns each cycle of the ttl control loop into a time-slotted plan of bus transactions
+ * Each transaction has its own period and deadline. At each cycle, due transactions are planned by priority order
+ * as long as their cost fits in the bus budget of the cycle. The others are deferred to the next cycles
+ * (and forced after MAX_DEFERRED_CYCLES to avoid starvation).
+ * The cost of a transaction is estimated from the baudrate and the payload size, then refined with the measured durations.
+ * The periods can be changed at runtime : admitPeriods checks that a set of periods fits in the bus budget before it is applied.
+ * planRates is the capacity model used at startup : it selects the highest rates the bus can sustain with the measured costs.
+ */
+class TtlTransactionScheduler
+{
+public:
+    static constexpr size_t NB_TRANSACTIONS = static_cast<size_t>(ETtlTransaction::NB_TRANSACTIONS);
+
+    // periods of all the transactions, indexed by ETtlTransaction
+    using Periods = std::array<double, NB_TRANSACTIONS>;
+
+    // rates of the control loop and of its transactions
+    struct RatePlan
+    {
+        double cycle_period{0.0};
+        Periods periods{};
+        // periods kept as given by planRates (manual overrides)
+        bool fixed_cycle_period{false};
+        std::array<bool, NB_TRANSACTIONS> fixed_periods{};
+    };
+
+public:
+    TtlTransactionScheduler() = default;
+
+    // setters
+    void setCyclePeriod(double period);
+    void setPeriod(ETtlTransaction transaction, double period);
+    void setEstimatedCost(ETtlTransaction transaction, double cost);
+    void setMeasuredCost(ETtlTransaction transaction, double cost);
+    void setEnabled(ETtlTransaction transaction, bool enabled);
+
+    // scheduling
+    void reset(double now);
+    void planCycle(double now);
+    void commit(ETtlTransaction transaction, double start_time, double end_time);
+
+    // admission control
+    Periods getPeriods() const;
+    double getOccupancy(const Periods &periods) const;
+    bool admitPeriods(Periods &periods, bool scale_down) const;
+
+    // capacity model
+    bool planRates(RatePlan &plan, double min_cycle_period, double max_cycle_period, double max_occupancy) const;
+
+    // getters
+    bool isPlanned(ETtlTransaction transaction) const;
+    bool hasDeferred() const;
+    double getPeriod(ETtlTransaction transaction) const;
+    double getFrequency(ETtlTransaction transaction) const;
+    double getCost(ETtlTransaction transaction) const;
+    uint32_t getDeferredCount(ETtlTransaction transaction) const;
+    double getCyclePeriod() const;
+    double getCycleBudget() const;
+    double getPlannedOccupancy() const;
+
+    // cost model
+    static double estimateReadCost(int baudrate, size_t data_length);
+    static double estimateSyncReadCost(int baudrate, size_t nb_ids, size_t data_length);
+    static double estimateSyncWriteCost(int baudrate, size_t nb_ids, size_t data_length);
+    static double estimateBulkReadCost(int baudrate, size_t nb_ids, size_t data_length);
+    static double estimateBulkWriteCost(int baudrate, size_t nb_ids, size_t data_length);
+
+private:
+    struct Slot
+    {
+        double period{0.0};
+        double deadline{0.0};
+        double estimated_cost{0.0};
+        double measured_cost{0.0};
+        uint32_t deferred_cycles{0};
+        uint32_t deferred_count{0};
+        bool enabled{true};
+        bool planned{false};
+    };
+
+    Slot& slot(ETtlTransaction transaction);
+    const Slot& slot(ETtlTransaction transaction) const;
+
+private:
+    std::array<Slot, NB_TRANSACTIONS> _slots{};
+
+    double _cycle_period{0.0};
+    double _cycle_budget{0.0};
+    double _planned_occupancy{0.0};
+    bool _has_deferred{false};
+
+    // part of the cycle given to the planned transactions, the rest is kept for os latency
+    static constexpr double BUS_BUDGET_RATIO = 0.8;
+    // a transaction is due if its deadline is reached within this part of a cycle (absorbs wake up jitter)
+    static constexpr double DEADLINE_TOLERANCE_RATIO = 0.25;
+    static constexpr double COST_FILTER_GAIN = 0.1;
+    static constexpr uint32_t MAX_DEFERRED_CYCLES = 10;
+
+    // protocol 2.0 framing : header (4) + id (1) + length (2) + instruction (1) + crc (2)
+    static constexpr size_t PACKET_OVERHEAD = 10;
+    // status packet has an additional error byte
+    static constexpr size_t STATUS_PACKET_OVERHEAD = 11;
+    // 1 start bit, 8 data bits, 1 stop bit
+    static constexpr double BITS_PER_BYTE = 10.0;
+    // turnaround between a packet and its status (return delay time and host latency)
+    static constexpr double RESPONSE_DELAY = 0.0001;
+};
+
+/**
+ * @brief TtlTransactionScheduler::isPlanned
+ * @param transaction
+ * @return true if the transaction has to be executed during the current cycle
+ */
+inline
+bool TtlTransactionScheduler::isPlanned(ETtlTransaction transaction) const
+{
+    return slot(transaction).planned;
+}
+
+/**
+ * @brief TtlTransactionScheduler::hasDeferred
+ * @return true if at least one due transaction has been deferred during the current cycle
+ */
+inline
+bool TtlTransactionScheduler::hasDeferred() const
+{
+    return _has_deferred;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getPeriod
+ * @param transaction
+ * @return
+ */
+inline
+double TtlTransactionScheduler::getPeriod(ETtlTransaction transaction) const
+{
+    return slot(transaction).period;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getFrequency
+ * @param transaction
+ * @return 0 if the transaction has no period
+ */
+inline
+double TtlTransactionScheduler::getFrequency(ETtlTransaction transaction) const
+{
+    return slot(transaction).period > 0.0 ? 1.0 / slot(transaction).period : 0.0;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getCost
+ * @param transaction
+ * @return measured cost if the transaction has already been executed, estimated cost otherwise
+ */
+inline
+double TtlTransactionScheduler::getCost(ETtlTransaction transaction) const
+{
+    return slot(transaction).measured_cost > 0.0 ? slot(transaction).measured_cost : slot(transaction).estimated_cost;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getDeferredCount
+ * @param transaction
+ * @return
+ */
+inline
+uint32_t TtlTransactionScheduler::getDeferredCount(ETtlTransaction transaction) const
+{
+    return slot(transaction).deferred_count;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getCyclePeriod
+ * @return
+ */
+inline
+double TtlTransactionScheduler::getCyclePeriod() const
+{
+    return _cycle_period;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getCycleBudget
+ * @return
+ */
+inline
+double TtlTransactionScheduler::getCycleBudget() const
+{
+    return _cycle_budget;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getPlannedOccupancy
+ * @return
+ */
+inline
+double TtlTransactionScheduler::getPlannedOccupancy() const
+{
+    return _planned_occupancy;
+}
+
+/**
+ * @brief TtlTransactionScheduler::slot
+ * @param transaction
+ * @return
+ */
+inline
+TtlTransactionScheduler::Slot& TtlTransactionScheduler::slot(ETtlTransaction transaction)
+{
+    return _slots.at(static_cast<size_t>(transaction));
+}
+
+/**
+ * @brief TtlTransactionScheduler::slot
+ * @param transaction
+ * @return
+ */
+inline
+const TtlTransactionScheduler::Slot& TtlTransactionScheduler::slot(ETtlTransaction transaction) const
+{
+    return _slots.at(static_cast<size_t>(transaction));
+}
+
+} // ttl_driver
+
+#endif // TTL_TRANSACTION_SCHEDULER_HPP
@@ -29,6 +29,10 @@ struct XL320Reg
     static constexpr float PROTOCOL_VERSION                = 2.0;
     static constexpr int MODEL_NUMBER                      = 350;
     static constexpr int VOLTAGE_CONVERSION                = 10;
+    // fast sync read is not supported by the firmware
+    static constexpr int MIN_FW_FAST_SYNC_READ             = -1;
+    // highest baud rate of ADDR_BAUDRATE
+    static constexpr int MAX_BAUDRATE                      = 1000000;
 
     // see table here : http:// support.robotis.com/en/product/actuator/dynamixel_x/xl_series/xl-320.htm
     // EEPROM
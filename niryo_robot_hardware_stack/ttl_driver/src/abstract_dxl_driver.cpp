@@ -140,6 +140,18 @@ int AbstractDxlDriver::writeSyncCmd(int type, const std::vector<uint8_t> &ids, c
         }
         return syncWriteTorqueEnable(ids, params_inv);
     }
+    case EDxlCommandType::CMD_TYPE_LED_STATE:
+    {
+        std::vector<uint8_t> params_conv;
+        params_conv.reserve(params.size());
+        for (auto const &p : params)
+        {
+            params_conv.emplace_back(static_cast<uint8_t>(p));
+        }
+        return syncWriteLed(ids, params_conv);
+    }
+    case EDxlCommandType::CMD_TYPE_PROFILE:
+        return syncWriteVelocityProfile(ids, params);
     default:
         std::cout << "Command not implemented " << type << std::endl;
     }
@@ -148,4 +160,31 @@ int AbstractDxlDriver::writeSyncCmd(int type, const std::vector<uint8_t> &ids, c
     return -1;
 }
 
+/**
+ * @brief AbstractDxlDriver::canSyncWriteCmd
+ * @param cmd
+ * @return true if this single command can be merged with others of the same type into one writeSyncCmd
+ */
+bool AbstractDxlDriver::canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) const
+{
+    if (!cmd || !cmd->isValid() || !cmd->isDxlCmd())
+        return false;
+
+    switch (EDxlCommandType(cmd->getCmdType()))
+    {
+    case EDxlCommandType::CMD_TYPE_POSITION:
+    case EDxlCommandType::CMD_TYPE_VELOCITY:
+    case EDxlCommandType::CMD_TYPE_EFFORT:
+    case EDxlCommandType::CMD_TYPE_TORQUE:
+    case EDxlCommandType::CMD_TYPE_LEARNING_MODE:
+    case EDxlCommandType::CMD_TYPE_LED_STATE:
+        return 1 == cmd->getParams().size();
+    case EDxlCommandType::CMD_TYPE_PROFILE:
+        // velocity and acceleration are consecutive registers, written together
+        return 2 == cmd->getParams().size();
+    default:
+        return false;
+    }
+}
+
 }  // namespace ttl_driver
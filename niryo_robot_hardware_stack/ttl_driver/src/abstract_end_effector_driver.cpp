@@ -163,4 +163,13 @@ int AbstractEndEffectorDriver::writeSyncCmd(int /*type*/, const std::vector<uint
     return 0;
 }
 
+/**
+ * @brief AbstractEndEffectorDriver::canSyncWriteCmd
+ * @return always false, end effector commands are never merged
+ */
+bool AbstractEndEffectorDriver::canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> & /*cmd*/) const
+{
+    return false;
+}
+
 }  // namespace ttl_driver
@@ -142,6 +142,30 @@ int AbstractStepperDriver::writeSyncCmd(int type, const std::vector<uint8_t> &id
     return -1;
 }
 
+/**
+ * @brief AbstractStepperDriver::canSyncWriteCmd
+ * @param cmd
+ * @return true if this single command can be merged with others of the same type into one writeSyncCmd
+ */
+bool AbstractStepperDriver::canSyncWriteCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd) const
+{
+    if (!cmd || !cmd->isValid() || !cmd->isStepperCmd() || 1 != cmd->getParams().size())
+        return false;
+
+    switch (EStepperCommandType(cmd->getCmdType()))
+    {
+    case EStepperCommandType::CMD_TYPE_POSITION:
+    case EStepperCommandType::CMD_TYPE_VELOCITY:
+    case EStepperCommandType::CMD_TYPE_TORQUE:
+    case EStepperCommandType::CMD_TYPE_LEARNING_MODE:
+        return true;
+    // the firmware needs the torque on and a delay between the registers of a velocity profile (see writeVelocityProfile)
+    case EStepperCommandType::CMD_TYPE_VELOCITY_PROFILE:
+    default:
+        return false;
+    }
+}
+
 /**
  * @brief AbstractStepperDriver::interpretFirmwareVersion
  * @param fw_version
@@ -16,6 +16,7 @@
 
 #include "ttl_driver/abstract_ttl_driver.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -69,6 +70,60 @@ int AbstractTtlDriver::getModelNumber(uint8_t id, uint16_t &model_number)
     return result;
 }
 
+/**
+ * @brief AbstractTtlDriver::readReturnDelayTime : only for the devices with a Return Delay Time register
+ * @param id
+ * @param return_delay_us
+ * @return COMM_NOT_AVAILABLE by default
+ */
+int AbstractTtlDriver::readReturnDelayTime(uint8_t /*id*/, uint32_t &/*return_delay_us*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief AbstractTtlDriver::writeReturnDelayTime : only for the devices with a Return Delay Time register
+ * @param id
+ * @param return_delay_us
+ * @return COMM_NOT_AVAILABLE by default
+ */
+int AbstractTtlDriver::writeReturnDelayTime(uint8_t /*id*/, uint32_t /*return_delay_us*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief AbstractTtlDriver::writeBaudRate : only for the devices whose baud rate registers are known
+ * @param id
+ * @param baudrate
+ * @return COMM_NOT_AVAILABLE by default
+ */
+int AbstractTtlDriver::writeBaudRate(uint8_t /*id*/, int /*baudrate*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief AbstractTtlDriver::isBaudRateSupported
+ * @param baudrate
+ * @return true for DEFAULT_BAUDRATE only by default
+ */
+bool AbstractTtlDriver::isBaudRateSupported(int baudrate) const
+{
+    return DEFAULT_BAUDRATE == baudrate;
+}
+
+/**
+ * @brief AbstractTtlDriver::writeStatusReturnLevel : only for the devices with a Status Return Level register
+ * @param id
+ * @param status_return_level
+ * @return COMM_NOT_AVAILABLE by default
+ */
+int AbstractTtlDriver::writeStatusReturnLevel(uint8_t /*id*/, uint8_t /*status_return_level*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
 /**
  * @brief AbstractTtlDriver::scan
  * @param id_list
@@ -106,6 +161,56 @@ std::string AbstractTtlDriver::str() const
     return ss.str();
 }
 
+/**
+ * @brief AbstractTtlDriver::setFastSyncReadAvailable : to be set when the firmware version of a motor is known
+ * @param id
+ * @param available
+ */
+void AbstractTtlDriver::setFastSyncReadAvailable(uint8_t id, bool available)
+{
+    if (available)
+        _fast_sync_read_ids.insert(id);
+    else
+        _fast_sync_read_ids.erase(id);
+}
+
+/**
+ * @brief AbstractTtlDriver::isFastSyncReadAvailable
+ * @param id_list
+ * @return true if the firmware of all the motors of id_list supports fast sync read
+ */
+bool AbstractTtlDriver::isFastSyncReadAvailable(const std::vector<uint8_t>& id_list) const
+{
+    if (id_list.empty())
+        return false;
+
+    return std::all_of(id_list.begin(), id_list.end(),
+                       [this](uint8_t id) { return _fast_sync_read_ids.count(id) != 0; });
+}
+
+/**
+ * @brief AbstractTtlDriver::setTxOnlyWrite : to be set when the status return level of a motor is known
+ * @param id
+ * @param tx_only
+ */
+void AbstractTtlDriver::setTxOnlyWrite(uint8_t id, bool tx_only)
+{
+    if (tx_only)
+        _tx_only_write_ids.insert(id);
+    else
+        _tx_only_write_ids.erase(id);
+}
+
+/**
+ * @brief AbstractTtlDriver::isTxOnlyWrite
+ * @param id
+ * @return true if the writes to the motor are sent without waiting for a status
+ */
+bool AbstractTtlDriver::isTxOnlyWrite(uint8_t id) const
+{
+    return _tx_only_write_ids.count(id) != 0;
+}
+
 /*
  *  -----------------   Read Write operations   --------------------
  */
@@ -326,6 +326,29 @@ int MockDxlDriver::writeVelocityProfile(uint8_t id, const std::vector<uint32_t>
     return res;
 }
 
+/**
+ * @brief MockDxlDriver::syncWriteVelocityProfile
+ * @param id_list
+ * @param data_list
+ * @return
+ */
+int MockDxlDriver::syncWriteVelocityProfile(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &data_list)
+{
+    if (2 * id_list.size() != data_list.size())
+        return LEN_ID_DATA_NOT_SAME;
+
+    std::set<uint8_t> countSet;
+    for (auto &id : id_list)
+    {
+        if (!_fake_data->dxl_registers.count(id))
+            return COMM_TX_ERROR;
+        auto result = countSet.insert(id);
+        if (!result.second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+    }
+    return COMM_SUCCESS;
+}
+
 /**
  * @brief MockDxlDriver::syncWriteTorqueEnable
  * @param id_list
@@ -418,6 +441,23 @@ int MockDxlDriver::readVelocityProfile(uint8_t id, std::vector<uint32_t> &data_l
 
 // ram read
 
+/**
+ * @brief MockDxlDriver::readTorqueEnable
+ * @param id
+ * @param torque_enable
+ * @return
+ */
+int MockDxlDriver::readTorqueEnable(uint8_t id, uint8_t &torque_enable)
+{
+    if (_fake_data->dxl_registers.count(id))
+        torque_enable = _fake_data->dxl_registers.at(id).torque;
+    else if (_fake_data->stepper_registers.count(id))
+        torque_enable = _fake_data->stepper_registers.at(id).torque;
+    else
+        return COMM_RX_FAIL;
+    return COMM_SUCCESS;
+}
+
 /**
  * @brief MockDxlDriver::readPosition
  * @param id
@@ -544,10 +584,10 @@ int MockDxlDriver::syncReadVelocity(const std::vector<uint8_t> &id_list, std::ve
 /**
  * @brief MockDxlDriver::syncReadJointStatus
  * @param id_list
- * @param data_array_list
+ * @param data_array_list : {position, velocity, load} of each motor, no load in fake data
  * @return
  */
-int MockDxlDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list)
+int MockDxlDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list)
 {
     std::set<uint8_t> countSet;
     data_array_list.clear();
@@ -555,21 +595,23 @@ int MockDxlDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, std:
     {
         if (_fake_data->dxl_registers.count(id))
         {
-            std::array<uint32_t, 2> blocks{};
+            std::array<uint32_t, 3> blocks{};
 
-            blocks.at(0) = _fake_data->dxl_registers.at(id).velocity;
-            blocks.at(1) = _fake_data->dxl_registers.at(id).position;
+            blocks.at(0) = _fake_data->dxl_registers.at(id).position;
+            blocks.at(1) = _fake_data->dxl_registers.at(id).velocity;
 
-            data_array_list.emplace_back(blocks);
+            if (!data_array_list.push_back(blocks))
+                return LEN_ID_DATA_NOT_SAME;
         }
         else if (_fake_data->stepper_registers.count(id))
         {
-            std::array<uint32_t, 2> blocks{};
+            std::array<uint32_t, 3> blocks{};
 
-            blocks.at(0) = _fake_data->stepper_registers.at(id).velocity;
-            blocks.at(1) = _fake_data->stepper_registers.at(id).position;
+            blocks.at(0) = _fake_data->stepper_registers.at(id).position;
+            blocks.at(1) = _fake_data->stepper_registers.at(id).velocity;
 
-            data_array_list.emplace_back(blocks);
+            if (!data_array_list.push_back(blocks))
+                return LEN_ID_DATA_NOT_SAME;
         }
         else
             return COMM_RX_FAIL;
@@ -580,6 +622,42 @@ int MockDxlDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, std:
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockDxlDriver::addJointStatusToBulkRead
+ * @param bulk_read
+ * @param id
+ * @return
+ * Bulk transactions need a real bus, the fake bus only supports sync reads
+ */
+int MockDxlDriver::addJointStatusToBulkRead(dynamixel::GroupBulkRead &/*bulk_read*/, uint8_t /*id*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief MockDxlDriver::getJointStatusFromBulkRead
+ * @param bulk_read
+ * @param id
+ * @param data
+ * @return
+ */
+int MockDxlDriver::getJointStatusFromBulkRead(dynamixel::GroupBulkRead &/*bulk_read*/, uint8_t /*id*/, std::array<uint32_t, 3> &/*data*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief MockDxlDriver::addPositionGoalToBulkWrite
+ * @param bulk_write
+ * @param id
+ * @param position
+ * @return
+ */
+int MockDxlDriver::addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &/*bulk_write*/, uint8_t /*id*/, uint32_t /*position*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
 /**
  * @brief MockDxlDriver::syncReadFirmwareVersion
  * @param id_list
@@ -333,6 +333,21 @@ int MockStepperDriver::syncWriteVelocityGoal(const std::vector<uint8_t> &id_list
 
 // ram read
 
+/**
+ * @brief MockStepperDriver::readTorqueEnable
+ * @param id
+ * @param torque_enable
+ * @return
+ */
+int MockStepperDriver::readTorqueEnable(uint8_t id, uint8_t &torque_enable)
+{
+    if (_fake_data->stepper_registers.count(id))
+        torque_enable = _fake_data->stepper_registers.at(id).torque;
+    else
+        return COMM_RX_FAIL;
+    return COMM_SUCCESS;
+}
+
 /**
  * @brief MockStepperDriver::readPosition
  * @param id
@@ -460,10 +475,10 @@ int MockStepperDriver::syncReadVelocity(const std::vector<uint8_t> &id_list, std
 /**
  * @brief StepperDriver::syncReadJointStatus
  * @param id_list
- * @param data_array_list
+ * @param data_array_list : {position, velocity, load} of each motor, no load in fake data
  * @return
  */
-int MockStepperDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list)
+int MockStepperDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list, JointStatusList &data_array_list)
 {
     std::set<uint8_t> countSet;
 
@@ -472,21 +487,23 @@ int MockStepperDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list,
     {
         if (_fake_data->stepper_registers.count(id))
         {
-            std::array<uint32_t, 2> blocks{};
+            std::array<uint32_t, 3> blocks{};
 
-            blocks.at(0) = _fake_data->stepper_registers.at(id).velocity;
-            blocks.at(1) = _fake_data->stepper_registers.at(id).position;
+            blocks.at(0) = _fake_data->stepper_registers.at(id).position;
+            blocks.at(1) = _fake_data->stepper_registers.at(id).velocity;
 
-            data_array_list.emplace_back(blocks);
+            if (!data_array_list.push_back(blocks))
+                return LEN_ID_DATA_NOT_SAME;
         }
         else if (_fake_data->dxl_registers.count(id))
         {
-            std::array<uint32_t, 2> blocks{};
+            std::array<uint32_t, 3> blocks{};
 
-            blocks.at(0) = _fake_data->dxl_registers.at(id).velocity;
-            blocks.at(1) = _fake_data->dxl_registers.at(id).position;
+            blocks.at(0) = _fake_data->dxl_registers.at(id).position;
+            blocks.at(1) = _fake_data->dxl_registers.at(id).velocity;
 
-            data_array_list.emplace_back(blocks);
+            if (!data_array_list.push_back(blocks))
+                return LEN_ID_DATA_NOT_SAME;
         }
         else
             return COMM_RX_FAIL;
@@ -498,6 +515,42 @@ int MockStepperDriver::syncReadJointStatus(const std::vector<uint8_t> &id_list,
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockStepperDriver::addJointStatusToBulkRead
+ * @param bulk_read
+ * @param id
+ * @return
+ * Bulk transactions need a real bus, the fake bus only supports sync reads
+ */
+int MockStepperDriver::addJointStatusToBulkRead(dynamixel::GroupBulkRead &/*bulk_read*/, uint8_t /*id*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief MockStepperDriver::getJointStatusFromBulkRead
+ * @param bulk_read
+ * @param id
+ * @param data
+ * @return
+ */
+int MockStepperDriver::getJointStatusFromBulkRead(dynamixel::GroupBulkRead &/*bulk_read*/, uint8_t /*id*/, std::array<uint32_t, 3> &/*data*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
+/**
+ * @brief MockStepperDriver::addPositionGoalToBulkWrite
+ * @param bulk_write
+ * @param id
+ * @param position
+ * @return
+ */
+int MockStepperDriver::addPositionGoalToBulkWrite(dynamixel::GroupBulkWrite &/*bulk_write*/, uint8_t /*id*/, uint32_t /*position*/)
+{
+    return COMM_NOT_AVAILABLE;
+}
+
 /**
  * @brief MockStepperDriver::syncReadFirmwareVersion
  * @param id_list
@@ -28,6 +28,7 @@
 #include "std_msgs/Bool.h"
 
 // c++
+#include <array>
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
@@ -59,6 +60,9 @@ using ::common::model::HardwareTypeEnum;
 using ::common::model::JointState;
 using ::common::model::StepperTtlSingleCmd;
 
+using ::common::util::ELoopStage;
+using ::common::util::LoopTimer;
+
 namespace ttl_driver
 {
 /**
@@ -127,17 +131,29 @@ void TtlInterfaceCore::initParameters(ros::NodeHandle &nh)
 
     nh.getParam("hardware_version", _hardware_version);
 
+    _control_loop_rt_config.readParameters(nh, "ttl_control_loop_rt");
+
+    nh.getParam("ttl_hardware_rates_calibration/enabled", _rates_calibration_enabled);
+    nh.getParam("ttl_hardware_rates_calibration/nb_samples", _rates_calibration_nb_samples);
+    nh.getParam("ttl_hardware_rates_calibration/min_control_loop_frequency", _min_control_loop_frequency);
+    nh.getParam("ttl_hardware_rates_calibration/max_control_loop_frequency", _max_control_loop_frequency);
+    nh.getParam("ttl_hardware_rates_calibration/max_bus_occupancy", _max_bus_occupancy);
+    nh.getParam("ttl_hardware_rates_calibration/overrides", _rates_overrides);
+
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_control_loop_frequency : %f", _control_loop_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_write_frequency : %f", write_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_data_frequency : %f", read_data_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_end_effector_frequency : %f", read_end_effector_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_status_frequency : %f", read_status_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - hardware_version : %s", _hardware_version.c_str());
-
-    _delta_time_data_read = 1.0 / read_data_frequency;
-    _delta_time_end_effector_read = 1.0 / read_end_effector_frequency;
-    _delta_time_status_read = 1.0 / read_status_frequency;
-    _delta_time_write = 1.0 / write_frequency;
+    ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_rates_calibration : %d, control loop between %f and %f Hz, %d overrides", _rates_calibration_enabled,
+              _min_control_loop_frequency, _max_control_loop_frequency, static_cast<int>(_rates_overrides.size()));
+
+    _transaction_scheduler.setCyclePeriod(1.0 / _control_loop_frequency);
+    _transaction_scheduler.setPeriod(ETtlTransaction::TRAJECTORY_WRITE, 1.0 / write_frequency);
+    _transaction_scheduler.setPeriod(ETtlTransaction::JOINTS_READ, 1.0 / read_data_frequency);
+    _transaction_scheduler.setPeriod(ETtlTransaction::END_EFFECTOR_READ, 1.0 / read_end_effector_frequency);
+    _transaction_scheduler.setPeriod(ETtlTransaction::HW_STATUS_READ, 1.0 / read_status_frequency);
 }
 
 /**
@@ -160,6 +176,10 @@ void TtlInterfaceCore::startServices(ros::NodeHandle &nh)
     _velocity_profile_server = nh.advertiseService("/niryo_robot/ttl_driver/read_velocity_profile", &TtlInterfaceCore::_callbackReadVelocityProfile, this);
 
     _velocity_profile_getter = nh.advertiseService("/niryo_robot/ttl_driver/write_velocity_profile", &TtlInterfaceCore::_callbackWriteVelocityProfile, this);
+
+    _frequencies_setter = nh.advertiseService("/niryo_robot/ttl_driver/set_frequencies", &TtlInterfaceCore::_callbackSetFrequencies, this);
+
+    _frequencies_getter = nh.advertiseService("/niryo_robot/ttl_driver/get_frequencies", &TtlInterfaceCore::_callbackGetFrequencies, this);
 }
 
 /**
@@ -170,6 +190,12 @@ void TtlInterfaceCore::startPublishers(ros::NodeHandle &nh)
 {
     _collision_status_publisher = nh.advertise<std_msgs::Bool>("/niryo_robot/end_effector_interface/collision_detected", 1, true);
     _collision_status_publisher_timer = nh.createTimer(_collision_status_publisher_duration, &TtlInterfaceCore::_publishCollisionStatus, this);
+
+    _bus_metrics_publisher = nh.advertise<niryo_robot_msgs::BusMetrics>("bus_metrics", 1);
+    _bus_metrics_publisher_timer = nh.createTimer(_bus_metrics_publisher_duration, &TtlInterfaceCore::_publishBusMetrics, this);
+
+    _loop_metrics_publisher = nh.advertise<niryo_robot_msgs::LoopMetrics>("loop_metrics", 1);
+    _loop_metrics_publisher_timer = nh.createTimer(_loop_metrics_publisher_duration, &TtlInterfaceCore::_publishLoopMetrics, this);
 }
 
 /**
@@ -232,6 +258,106 @@ vector<uint8_t> TtlInterfaceCore::scanTools()
     return motor_list;
 }
 
+/**
+ * @brief TtlInterfaceCore::isBaudRateNegotiable
+ * @return false if the bus stays at its configured baud rate
+ */
+bool TtlInterfaceCore::isBaudRateNegotiable() const
+{
+    return _ttl_manager->isBaudRateNegotiable();
+}
+
+/**
+ * @brief TtlInterfaceCore::negotiateBaudRate : switches the bus to the highest baud rate supported by all the devices found
+ * @return
+ */
+int TtlInterfaceCore::negotiateBaudRate()
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+    int result = _ttl_manager->negotiateBaudRate();
+    ROS_INFO_COND(COMM_NOT_AVAILABLE != result, "TtlInterfaceCore::negotiateBaudRate - Result : %d", result);
+
+    return result;
+}
+
+/**
+ * @brief TtlInterfaceCore::calibrateBusRates : measures the cost of each transaction of the control loop on the connected hardware,
+ * then selects the highest rates the bus can sustain
+ * @return true if new rates have been applied
+ * The configured frequencies give the ratios between the rates. The frequencies set in ttl_hardware_rates_calibration/overrides are kept as is
+ */
+bool TtlInterfaceCore::calibrateBusRates()
+{
+    if (!_rates_calibration_enabled)
+        return false;
+
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    // costs of the transactions in a short burst, the control loop is stopped meanwhile
+    updateTransactionCosts();
+    _transaction_scheduler.setEnabled(ETtlTransaction::END_EFFECTOR_READ, _ttl_manager->hasEndEffector());
+
+    std::ostringstream costs;
+    bool joints_read_measured = false;
+    for (size_t i = 0; i < TtlTransactionScheduler::NB_TRANSACTIONS; ++i)
+    {
+        auto transaction = static_cast<ETtlTransaction>(i);
+        double cost = _ttl_manager->measureTransactionCost(transaction, static_cast<unsigned int>(std::max(_rates_calibration_nb_samples, 1)));
+        if (cost > 0.0)
+        {
+            _transaction_scheduler.setMeasuredCost(transaction, cost);
+            joints_read_measured |= ETtlTransaction::JOINTS_READ == transaction;
+        }
+
+        costs << " " << _transaction_scheduler.getCost(transaction) * 1e6;
+    }
+
+    if (!joints_read_measured)
+    {
+        ROS_WARN("TtlInterfaceCore::calibrateBusRates - joints read could not be measured, configured rates kept");
+        return false;
+    }
+
+    TtlTransactionScheduler::RatePlan plan;
+    plan.cycle_period = _transaction_scheduler.getCyclePeriod();
+    plan.periods = _transaction_scheduler.getPeriods();
+
+    const std::array<std::string, TtlTransactionScheduler::NB_TRANSACTIONS> override_names = {"write_frequency", "read_data_frequency",
+                                                                                             "read_end_effector_frequency", "read_status_frequency"};
+    for (size_t i = 0; i < override_names.size(); ++i)
+    {
+        if (_rates_overrides.count(override_names.at(i)) && _rates_overrides.at(override_names.at(i)) > 0.0)
+        {
+            plan.periods.at(i) = 1.0 / _rates_overrides.at(override_names.at(i));
+            plan.fixed_periods.at(i) = true;
+        }
+    }
+    if (_rates_overrides.count("control_loop_frequency") && _rates_overrides.at("control_loop_frequency") > 0.0)
+    {
+        plan.cycle_period = 1.0 / _rates_overrides.at("control_loop_frequency");
+        plan.fixed_cycle_period = true;
+    }
+
+    bool sustainable = _transaction_scheduler.planRates(plan, _max_control_loop_frequency > 0.0 ? 1.0 / _max_control_loop_frequency : 0.0,
+                                                        _min_control_loop_frequency > 0.0 ? 1.0 / _min_control_loop_frequency : 0.0, _max_bus_occupancy);
+
+    _control_loop_frequency = 1.0 / plan.cycle_period;
+    _control_loop_frequency_changed = true;
+    _transaction_scheduler.setCyclePeriod(plan.cycle_period);
+    for (size_t i = 0; i < plan.periods.size(); ++i)
+        _transaction_scheduler.setPeriod(static_cast<ETtlTransaction>(i), plan.periods.at(i));
+
+    ROS_INFO("TtlInterfaceCore::calibrateBusRates - costs (write, joints, end effector, status) :%s us", costs.str().c_str());
+    ROS_INFO("TtlInterfaceCore::calibrateBusRates - control loop %.1f Hz, write %.1f Hz, joints read %.1f Hz, end effector read %.1f Hz, status read %.2f Hz, "
+             "bus occupancy %.2f",
+             _control_loop_frequency, _transaction_scheduler.getFrequency(ETtlTransaction::TRAJECTORY_WRITE),
+             _transaction_scheduler.getFrequency(ETtlTransaction::JOINTS_READ), _transaction_scheduler.getFrequency(ETtlTransaction::END_EFFECTOR_READ),
+             _transaction_scheduler.getFrequency(ETtlTransaction::HW_STATUS_READ), _transaction_scheduler.getOccupancy(_transaction_scheduler.getPeriods()));
+    ROS_WARN_COND(!sustainable, "TtlInterfaceCore::calibrateBusRates - the bus can not sustain these rates, transactions will be deferred");
+
+    return true;
+}
+
 /**
  * @brief TtlInterfaceCore::motorScanReport
  * @param motor_id
@@ -486,12 +612,34 @@ inline common::model::EStepperCalibrationStatus TtlInterfaceCore::getCalibration
 void TtlInterfaceCore::resetHardwareControlLoopRates()
 {
     ROS_DEBUG("TtlInterfaceCore::resetHardwareControlLoopRates - Reset control loop rates");
-    double now = ros::Time::now().toSec();
-    _time_hw_data_last_write = now;
-    _time_hw_data_last_read = now;
-    _time_hw_status_last_read = now;
-    _time_check_connection_last_read = now;
-    _time_check_end_effector_last_read = now;
+    lock_guard<mutex> lck(_control_loop_mutex);
+    if (_ttl_manager)
+        updateTransactionCosts();
+    _transaction_scheduler.reset(LoopTimer::now());
+}
+
+/**
+ * @brief TtlInterfaceCore::updateTransactionCosts : update the estimated cost of each transaction given the hardware connected on the bus
+ */
+void TtlInterfaceCore::updateTransactionCosts()
+{
+    _transaction_scheduler.setEstimatedCost(ETtlTransaction::TRAJECTORY_WRITE, _ttl_manager->estimateTransactionCost(ETtlTransaction::TRAJECTORY_WRITE));
+    _transaction_scheduler.setEstimatedCost(ETtlTransaction::JOINTS_READ, _ttl_manager->estimateTransactionCost(ETtlTransaction::JOINTS_READ));
+    _transaction_scheduler.setEstimatedCost(ETtlTransaction::END_EFFECTOR_READ, _ttl_manager->estimateTransactionCost(ETtlTransaction::END_EFFECTOR_READ));
+    _transaction_scheduler.setEstimatedCost(ETtlTransaction::HW_STATUS_READ, _ttl_manager->estimateTransactionCost(ETtlTransaction::HW_STATUS_READ));
+}
+
+/**
+ * @brief TtlInterfaceCore::commitTransaction : notify the scheduler that a planned transaction has been executed
+ * @param transaction
+ * @param start_time
+ * @return end time of the transaction, which is the start time of the next one
+ */
+double TtlInterfaceCore::commitTransaction(ETtlTransaction transaction, double start_time)
+{
+    double end_time = LoopTimer::now();
+    _transaction_scheduler.commit(transaction, start_time, end_time);
+    return end_time;
 }
 
 /**
@@ -519,8 +667,13 @@ void TtlInterfaceCore::activeDebugMode(bool mode)
  */
 void TtlInterfaceCore::controlLoop()
 {
-    ros::Rate control_loop_rate = ros::Rate(_control_loop_frequency);
+    std::string thread_settings = _control_loop_rt_config.apply();
+    ROS_INFO("TtlInterfaceCore::controlLoop - thread settings : %s", thread_settings.c_str());
+    _loop_metrics.setThreadSettings(thread_settings);
+
+    LoopTimer control_loop_timer(1.0 / _control_loop_frequency);
     resetHardwareControlLoopRates();
+    _loop_metrics.setExpectedPeriod(control_loop_timer.getPeriod());
 
     while (ros::ok())
     {
@@ -529,8 +682,10 @@ void TtlInterfaceCore::controlLoop()
             // 1. check connection status of motors
             if (!_ttl_manager->isConnectionOk())
             {
+                _loop_metrics.pause();
+
                 // clear all commands concerned move joints to avoid when a motor reconnected, it moves a little bit because of command unsent yet
-                _joint_trajectory_cmd.clear();
+                _joint_trajectory_cmd.consume();
 
                 // scan motors again
                 ROS_WARN_THROTTLE(1.0, "TtlInterfaceCore::controlLoop - motor connection error");
@@ -568,43 +723,85 @@ void TtlInterfaceCore::controlLoop()
                 }
 
                 ROS_INFO("TtlInterfaceCore::controlLoop - Bus is ok");
+
+                // connected hardware may have changed
+                lock_guard<mutex> lck(_control_loop_mutex);
+                updateTransactionCosts();
+                control_loop_timer.reset();
             }
 
             if (_control_loop_flag)
             {
+                _loop_metrics.startCycle();
+
                 lock_guard<mutex> lck(_control_loop_mutex);
-                if (ros::Time::now().toSec() - _time_hw_data_last_read >= _delta_time_data_read)
+
+                // plan the transactions of this cycle by priority: trajectory write, joints read, end effector read, hw status read
+                // lower priority transactions are deferred to the next cycles if the bus budget is spent
+                // the plan uses the deadline of the cycle, so the transaction rates are phase-locked on the loop
+                double cycle_start = control_loop_timer.getCycleTime();
+                if (_control_loop_frequency_changed)
                 {
-                    _ttl_manager->readJointsStatus();
-                    _time_hw_data_last_read = ros::Time::now().toSec();
+                    control_loop_timer.setPeriod(1.0 / _control_loop_frequency);
+                    _loop_metrics.setExpectedPeriod(control_loop_timer.getPeriod());
+                    _control_loop_frequency_changed = false;
                 }
-                if (ros::Time::now().toSec() - _time_hw_data_last_write >= _delta_time_write)
+                _transaction_scheduler.setEnabled(ETtlTransaction::END_EFFECTOR_READ, _ttl_manager->hasEndEffector());
+                _transaction_scheduler.planCycle(cycle_start);
+                double now = LoopTimer::now();
+
+                ROS_DEBUG_COND(_transaction_scheduler.hasDeferred(), "TtlInterfaceCore::controlLoop - bus budget spent (%f / %f s), transactions deferred",
+                               _transaction_scheduler.getPlannedOccupancy(), _transaction_scheduler.getCycleBudget());
+                _loop_metrics.endStage(ELoopStage::UPDATE);
+
+                if (_transaction_scheduler.isPlanned(ETtlTransaction::TRAJECTORY_WRITE))
                 {
-                    _executeCommand();
-                    _time_hw_data_last_write = ros::Time::now().toSec();
+                    if (_joint_trajectory_cmd.consume() && !_joint_trajectory_cmd.getReadBuffer().empty())
+                        _ttl_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd.getReadBuffer());
+                    now = commitTransaction(ETtlTransaction::TRAJECTORY_WRITE, now);
+                    _loop_metrics.endStage(ELoopStage::WRITE);
                 }
-                if (ros::Time::now().toSec() - _time_hw_status_last_read >= _delta_time_status_read)
+                if (_transaction_scheduler.isPlanned(ETtlTransaction::JOINTS_READ))
                 {
-                    _ttl_manager->readHardwareStatus();
-                    _time_hw_status_last_read = ros::Time::now().toSec();
+                    _ttl_manager->readJointsStatus();
+                    _joint_states_snapshot.getWriteBuffer() = _ttl_manager->getJointStatesSnapshot();
+                    _joint_states_snapshot.publish();
+                    now = commitTransaction(ETtlTransaction::JOINTS_READ, now);
+                    _loop_metrics.endStage(ELoopStage::READ);
                 }
-                if (_ttl_manager->hasEndEffector() && ros::Time::now().toSec() - _time_hw_end_effector_last_read >= _delta_time_end_effector_read)
+                if (_transaction_scheduler.isPlanned(ETtlTransaction::END_EFFECTOR_READ))
                 {
                     _ttl_manager->readEndEffectorStatus();
-                    _time_hw_end_effector_last_read = ros::Time::now().toSec();
+                    now = commitTransaction(ETtlTransaction::END_EFFECTOR_READ, now);
+                }
+                if (_transaction_scheduler.isPlanned(ETtlTransaction::HW_STATUS_READ))
+                {
+                    _ttl_manager->readHardwareStatus();
+                    commitTransaction(ETtlTransaction::HW_STATUS_READ, now);
                 }
+                _loop_metrics.endStage(ELoopStage::STATUS);
+
+                // the bus time left in this cycle is used to execute the queued commands
+                _cmd_queue_deadline = cycle_start + _transaction_scheduler.getCycleBudget();
+                _executeCommand();
+                _loop_metrics.endStage(ELoopStage::WRITE);
+                _loop_metrics.endCycle();
 
-                control_loop_rate.sleep();
+                control_loop_timer.sleep();
             }
             else
             {
+                _loop_metrics.pause();
                 ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
                 resetHardwareControlLoopRates();
+                control_loop_timer.reset();
             }
         }
         else
         {
+            _loop_metrics.pause();
             ros::Duration(0.5).sleep();
+            control_loop_timer.reset();
         }
 
         // essential to allow publishers and subscribers to do their job
@@ -616,47 +813,62 @@ void TtlInterfaceCore::controlLoop()
 }
 
 /**
- * @brief TtlInterfaceCore::_executeCommand : execute all the cmd in the current queue
+ * @brief TtlInterfaceCore::_executeCommand : execute the queued commands, by priority, until the bus budget of the cycle is spent
+ * At least one command is executed per cycle to ensure the queue is always progressing
+ * Consecutive single commands are given together to the ttl manager to be merged into sync writes
+ * A sync command failing for some drivers is retried in the next cycles, the next motor commands wait for it to keep their order
  */
-// create a unique queue using polymorphism
 void TtlInterfaceCore::_executeCommand()
 {
-    bool _need_sleep = false;
-    if (!_joint_trajectory_cmd.empty())
-    {
-        _ttl_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd);
-        _joint_trajectory_cmd.clear();
-        _need_sleep = true;
-    }
-    if (!_single_cmds_queue.empty())
-    {
-        std::lock_guard<std::mutex> lock(_single_cmd_queue_mutex);
-        if (_need_sleep)
-            ros::Duration(0.001).sleep();
-        _ttl_manager->writeSingleCommand(std::move(_single_cmds_queue.front()));
-        _single_cmds_queue.pop();
-        _need_sleep = true;
-    }
-    if (!_conveyor_cmds_queue.empty())
+    if (_ttl_manager->hasPendingSynchronizeCommand())
     {
-        std::lock_guard<std::mutex> lock(_conveyor_cmd_queue_mutex);
-        if (_need_sleep)
-            ros::Duration(0.001).sleep();
-        _ttl_manager->writeSingleCommand(std::move(_conveyor_cmds_queue.front()));
-        _conveyor_cmds_queue.pop();
+        _ttl_manager->processSynchronizeCommand();
+
+        if (!_ttl_manager->hasPendingSynchronizeCommand())
+            _nb_pending_motor_cmds--;
     }
-    if (!_sync_cmds_queue.empty())
+
+    TtlCommand cmd;
+    bool first_cmd = true;
+
+    while ((first_cmd || LoopTimer::now() < _cmd_queue_deadline) &&
+           (_ttl_manager->hasPendingSynchronizeCommand() ? _cmd_queue.pop(cmd, CONVEYOR_CMD_PRIORITY) : _cmd_queue.pop(cmd)))
     {
-        std::lock_guard<std::mutex> lock(_sync_cmd_queue_mutex);
+        int nb_cmds = 1;
 
-        if (_need_sleep)
-            ros::Duration(0.001).sleep();
-        _ttl_manager->writeSynchronizeCommand(std::move(_sync_cmds_queue.front()));
-        _sync_cmds_queue.pop();
-        _need_sleep = true;
+        if (cmd.sync_cmd)
+        {
+            if (COMM_SUCCESS == _ttl_manager->startSynchronizeCommand(std::move(cmd.sync_cmd)))
+                _ttl_manager->processSynchronizeCommand();
+
+            // still pending : counted as executed once all its drivers are written
+            if (_ttl_manager->hasPendingSynchronizeCommand())
+                nb_cmds = 0;
+        }
+        else if (cmd.single_cmd)
+        {
+            _single_cmds_batch.clear();
+            _single_cmds_batch.emplace_back(std::move(cmd.single_cmd));
+
+            // take the following single commands of the same priority, stop at the first sync command to keep the order
+            TtlCommand next_cmd;
+            const TtlCommand *next = _cmd_queue.front(cmd.priority);
+            while (next && next->single_cmd && _single_cmds_batch.size() < MAX_MERGED_SINGLE_CMDS && _cmd_queue.pop(next_cmd, cmd.priority))
+            {
+                _single_cmds_batch.emplace_back(std::move(next_cmd.single_cmd));
+                next = _cmd_queue.front(cmd.priority);
+            }
+
+            nb_cmds = static_cast<int>(_single_cmds_batch.size());
+            _ttl_manager->writeSingleCommands(std::move(_single_cmds_batch));
+            _single_cmds_batch.clear();
+        }
+
+        if (MOTOR_CMD_PRIORITY == cmd.priority)
+            _nb_pending_motor_cmds -= nb_cmds;
+
+        first_cmd = false;
     }
-    if (_need_sleep)
-        ros::Duration(0.001).sleep();
 }
 
 // *************
@@ -672,7 +884,9 @@ int TtlInterfaceCore::addJoint(const std::shared_ptr<common::model::JointState>
 {
     // protect bus with mutex because of readFirmware version in addHardwareComponent
     lock_guard<mutex> lck(_control_loop_mutex);
-    return _ttl_manager->addHardwareComponent(jointState);
+    int result = _ttl_manager->addHardwareComponent(jointState);
+    updateTransactionCosts();
+    return result;
 }
 
 /**
@@ -795,43 +1009,36 @@ int TtlInterfaceCore::changeId(common::model::EHardwareType motor_type, uint8_t
 }
 
 /**
- * @brief TtlInterfaceCore::clearSingleCommandQueue
+ * @brief TtlInterfaceCore::clearCommandQueue
  */
-void TtlInterfaceCore::clearSingleCommandQueue()
+void TtlInterfaceCore::clearCommandQueue()
 {
-    std::lock_guard<std::mutex> lock(_single_cmd_queue_mutex);
-
-    while (!_single_cmds_queue.empty())
-        _single_cmds_queue.pop();
-}
-
-/**
- * @brief TtlInterfaceCore::clearConveyorCommandQueue
- */
-void TtlInterfaceCore::clearConveyorCommandQueue()
-{
-    std::lock_guard<std::mutex> lock(_conveyor_cmd_queue_mutex);
-
-    while (!_conveyor_cmds_queue.empty())
-        _conveyor_cmds_queue.pop();
-}
+    // the control loop is the only consumer of the queue, we take its place for the time of the clear
+    lock_guard<mutex> lck(_control_loop_mutex);
 
-/**
- * @brief TtlInterfaceCore::clearSyncCommandQueue
- */
-void TtlInterfaceCore::clearSyncCommandQueue()
-{
-    std::lock_guard<std::mutex> lock(_sync_cmd_queue_mutex);
+    TtlCommand cmd;
+    while (_cmd_queue.pop(cmd))
+    {
+        if (MOTOR_CMD_PRIORITY == cmd.priority)
+            _nb_pending_motor_cmds--;
+    }
 
-    while (!_sync_cmds_queue.empty())
-        _sync_cmds_queue.pop();
+    if (_ttl_manager->hasPendingSynchronizeCommand())
+    {
+        _ttl_manager->cancelSynchronizeCommand();
+        _nb_pending_motor_cmds--;
+    }
 }
 
 /**
  * @brief TtlInterfaceCore::setTrajectoryControllerCommands
  * @param cmd
  */
-void TtlInterfaceCore::setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, uint32_t>> &&cmd) { _joint_trajectory_cmd = cmd; }  // NOLINT
+void TtlInterfaceCore::setTrajectoryControllerCommands(const common::model::TtlJointTrajectoryCmd &cmd)
+{
+    _joint_trajectory_cmd.getWriteBuffer() = cmd;
+    _joint_trajectory_cmd.publish();
+}
 
 /**
  * @brief TtlInterfaceCore::setSyncCommand
@@ -839,11 +1046,9 @@ void TtlInterfaceCore::setTrajectoryControllerCommands(std::vector<std::pair<uin
  */
 void TtlInterfaceCore::addSyncCommandToQueue(std::unique_ptr<common::model::ISynchronizeMotorCmd> &&cmd)  // NOLINT
 {
-    std::lock_guard<std::mutex> lock(_sync_cmd_queue_mutex);
-
     if (cmd->isValid())
     {
-        _sync_cmds_queue.push(common::util::static_unique_ptr_cast<common::model::AbstractTtlSynchronizeMotorCmd>(std::move(cmd)));
+        pushCommand(MOTOR_CMD_PRIORITY, nullptr, common::util::static_unique_ptr_cast<common::model::AbstractTtlSynchronizeMotorCmd>(std::move(cmd)));
     }
     else
         ROS_WARN("TtlInterfaceCore::setSyncCommand : Invalid command %s", cmd->str().c_str());
@@ -860,26 +1065,12 @@ void TtlInterfaceCore::addSingleCommandToQueue(std::unique_ptr<common::model::IS
 
     if (cmd->isValid())
     {
+        // conveyors commands have a lower priority to not delay motors commands
+        size_t priority = MOTOR_CMD_PRIORITY;
         if (cmd->getCmdType() == static_cast<int>(EStepperCommandType::CMD_TYPE_CONVEYOR))
-        {
-            if (_conveyor_cmds_queue.size() > QUEUE_OVERFLOW)
-                ROS_WARN("TtlInterfaceCore::addCommandToQueue: Cmd queue overflow ! %d", static_cast<int>(_conveyor_cmds_queue.size()));
-            else
-            {
-                std::lock_guard<std::mutex> lock(_conveyor_cmd_queue_mutex);
-                _conveyor_cmds_queue.push(common::util::static_unique_ptr_cast<common::model::AbstractTtlSingleMotorCmd>(std::move(cmd)));
-            }
-        }
-        else
-        {
-            if (_single_cmds_queue.size() > QUEUE_OVERFLOW)
-                ROS_WARN("TtlInterfaceCore::addSingleCommandToQueue: dxl cmd queue overflow ! %d", static_cast<int>(_single_cmds_queue.size()));
-            else
-            {
-                std::lock_guard<std::mutex> lock(_single_cmd_queue_mutex);
-                _single_cmds_queue.push(common::util::static_unique_ptr_cast<common::model::AbstractTtlSingleMotorCmd>(std::move(cmd)));
-            }
-        }
+            priority = CONVEYOR_CMD_PRIORITY;
+
+        pushCommand(priority, common::util::static_unique_ptr_cast<common::model::AbstractTtlSingleMotorCmd>(std::move(cmd)), nullptr);
     }
     else
     {
@@ -887,6 +1078,39 @@ void TtlInterfaceCore::addSingleCommandToQueue(std::unique_ptr<common::model::IS
     }
 }
 
+/**
+ * @brief TtlInterfaceCore::pushCommand : push a single or a sync command in the commands queue, without blocking the control loop
+ * @param priority
+ * @param single_cmd
+ * @param sync_cmd
+ * @return false if the queue is full for this priority
+ */
+bool TtlInterfaceCore::pushCommand(size_t priority, std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &&single_cmd,
+                                   std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &&sync_cmd)
+{
+    TtlCommand cmd;
+    cmd.priority = priority;
+    cmd.single_cmd = std::move(single_cmd);
+    cmd.sync_cmd = std::move(sync_cmd);
+
+    // count the command before pushing it to be sure it is counted when executed
+    if (MOTOR_CMD_PRIORITY == priority)
+        _nb_pending_motor_cmds++;
+
+    if (!_cmd_queue.push(std::move(cmd), priority))
+    {
+        if (MOTOR_CMD_PRIORITY == priority)
+            _nb_pending_motor_cmds--;
+
+        // push does not consume the command if it fails
+        ROS_WARN("TtlInterfaceCore::pushCommand: Cmd queue overflow ! %d - %s", static_cast<int>(_cmd_queue.size(priority)),
+                 cmd.sync_cmd ? cmd.sync_cmd->str().c_str() : cmd.single_cmd->str().c_str());
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief TtlInterfaceCore::addSingleCommandToQueue
  * @param cmd
@@ -958,7 +1182,8 @@ niryo_robot_msgs::BusState TtlInterfaceCore::getBusState() const
  */
 void TtlInterfaceCore::waitSyncQueueFree()
 {
-    while (!_sync_cmds_queue.empty())
+    // single and sync commands share the same queue
+    while (_nb_pending_motor_cmds > 0)
     {
         ros::Duration(0.2).sleep();
     }
@@ -969,7 +1194,7 @@ void TtlInterfaceCore::waitSyncQueueFree()
  */
 void TtlInterfaceCore::waitSingleQueueFree()
 {
-    while (!_single_cmds_queue.empty())
+    while (_nb_pending_motor_cmds > 0)
     {
         ros::Duration(0.2).sleep();
     }
@@ -1216,6 +1441,92 @@ bool TtlInterfaceCore::_callbackWriteVelocityProfile(ttl_driver::WriteVelocityPr
     return true;
 }
 
+/**
+ * @brief TtlInterfaceCore::_callbackSetFrequencies : changes the frequencies of the transactions of the control loop
+ * @param req
+ * @param res
+ * @return
+ * The new frequencies are applied only if their estimated bus occupancy, computed with the measured costs of the transactions,
+ * fits in the bus budget. Otherwise they are rejected, or scaled down if asked
+ */
+bool TtlInterfaceCore::_callbackSetFrequencies(ttl_driver::SetFrequencies::Request &req, ttl_driver::SetFrequencies::Response &res)
+{
+    int result = niryo_robot_msgs::CommandStatus::FAILURE;
+
+    std::array<double, TtlTransactionScheduler::NB_TRANSACTIONS> frequencies = {req.write_frequency, req.read_data_frequency,
+                                                                                req.read_end_effector_frequency, req.read_status_frequency};
+
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    TtlTransactionScheduler::Periods periods = _transaction_scheduler.getPeriods();
+    bool valid = true;
+    for (size_t i = 0; i < periods.size(); ++i)
+    {
+        if (frequencies.at(i) < 0.0)
+            valid = false;
+        else if (frequencies.at(i) > 0.0)
+            periods.at(i) = 1.0 / frequencies.at(i);
+    }
+
+    double requested_occupancy = _transaction_scheduler.getOccupancy(periods);
+
+    if (!valid)
+    {
+        res.message = "TtlInterfaceCore - Set frequencies failed : frequencies must be positive";
+        result = niryo_robot_msgs::CommandStatus::INVALID_PARAMETERS;
+    }
+    else if (_transaction_scheduler.admitPeriods(periods, req.scale_down))
+    {
+        for (size_t i = 0; i < periods.size(); ++i)
+            _transaction_scheduler.setPeriod(static_cast<ETtlTransaction>(i), periods.at(i));
+
+        res.message = "TtlInterfaceCore - Set frequencies successful";
+        if (requested_occupancy > 1.0)
+            res.message += ", scaled down by " + std::to_string(requested_occupancy) + " to fit in the bus budget";
+        result = niryo_robot_msgs::CommandStatus::SUCCESS;
+
+        ROS_INFO("TtlInterfaceCore::_callbackSetFrequencies - %s", res.message.c_str());
+    }
+    else
+    {
+        res.message = "TtlInterfaceCore - Set frequencies rejected : estimated bus occupancy " + std::to_string(requested_occupancy) + " is above the bus budget";
+        result = niryo_robot_msgs::CommandStatus::REJECTED;
+    }
+
+    res.write_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::TRAJECTORY_WRITE);
+    res.read_data_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::JOINTS_READ);
+    res.read_end_effector_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::END_EFFECTOR_READ);
+    res.read_status_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::HW_STATUS_READ);
+    res.bus_occupancy = _transaction_scheduler.getOccupancy(_transaction_scheduler.getPeriods());
+
+    res.status = result;
+
+    return true;
+}
+
+/**
+ * @brief TtlInterfaceCore::_callbackGetFrequencies
+ * @param req
+ * @param res
+ * @return
+ */
+bool TtlInterfaceCore::_callbackGetFrequencies(ttl_driver::GetFrequencies::Request & /*req*/, ttl_driver::GetFrequencies::Response &res)
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    res.control_loop_frequency = _control_loop_frequency;
+    res.write_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::TRAJECTORY_WRITE);
+    res.read_data_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::JOINTS_READ);
+    res.read_end_effector_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::END_EFFECTOR_READ);
+    res.read_status_frequency = _transaction_scheduler.getFrequency(ETtlTransaction::HW_STATUS_READ);
+    res.bus_occupancy = _transaction_scheduler.getOccupancy(_transaction_scheduler.getPeriods());
+
+    res.message = "TtlInterfaceCore - Get frequencies successful";
+    res.status = niryo_robot_msgs::CommandStatus::SUCCESS;
+
+    return true;
+}
+
 void TtlInterfaceCore::_publishCollisionStatus(const ros::TimerEvent &)
 {
     std_msgs::Bool msg;
@@ -1223,4 +1534,27 @@ void TtlInterfaceCore::_publishCollisionStatus(const ros::TimerEvent &)
     _collision_status_publisher.publish(msg);
 }
 
+/**
+ * @brief TtlInterfaceCore::_publishBusMetrics : latencies and results of the bus transactions, busy fraction of the bus,
+ * setpoints overwritten before being written
+ */
+void TtlInterfaceCore::_publishBusMetrics(const ros::TimerEvent &)
+{
+    // BusMetrics has its own lock, the control loop is not blocked
+    niryo_robot_msgs::BusMetrics msg = _ttl_manager->getBusMetrics();
+    msg.overwritten_trajectory_cmd_count = getOverwrittenTrajectoryCmdCount();
+    msg.header.stamp = ros::Time::now();
+    _bus_metrics_publisher.publish(msg);
+}
+
+/**
+ * @brief TtlInterfaceCore::_publishLoopMetrics : period, execution time and wake-up latency of the control loop
+ */
+void TtlInterfaceCore::_publishLoopMetrics(const ros::TimerEvent &)
+{
+    niryo_robot_msgs::LoopMetrics msg = _loop_metrics.getMsg();
+    msg.header.stamp = ros::Time::now();
+    _loop_metrics_publisher.publish(msg);
+}
+
 }  // namespace ttl_driver
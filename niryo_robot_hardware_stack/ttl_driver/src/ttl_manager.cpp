@@ -19,8 +19,10 @@
 // cpp
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -41,6 +43,7 @@
 #include "common/model/stepper_calibration_status_enum.hpp"
 #include "common/model/stepper_motor_state.hpp"
 #include "common/model/tool_state.hpp"
+#include "common/util/loop_timer.hpp"
 
 #include "dynamixel_sdk/packet_handler.h"
 #include "ttl_driver/end_effector_reg.hpp"
@@ -68,6 +71,11 @@ using ::common::model::HardwareTypeEnum;
 using ::common::model::JointState;
 using ::common::model::StepperMotorState;
 
+using ::common::util::BusMetrics;
+using ::common::util::EBusResult;
+using ::common::util::EBusTransaction;
+using ::common::util::LoopTimer;
+
 namespace ttl_driver
 {
 /**
@@ -90,9 +98,16 @@ TtlManager::~TtlManager()
 {
     if (_portHandler)
     {
+        _portHandler->setPacketTracer(nullptr);
         _portHandler->clearPort();
         _portHandler->closePort();
     }
+
+    if (_packet_tracer)
+    {
+        _packet_tracer->stop();
+        ROS_INFO_COND(_packet_tracer->getDroppedCount() > 0, "TtlManager - Packet tracer dropped %lu records", static_cast<unsigned long>(_packet_tracer->getDroppedCount()));
+    }
 }
 
 /**
@@ -108,8 +123,27 @@ bool TtlManager::init(ros::NodeHandle &nh)
 
     nh.getParam("bus_params/uart_device_name", _device_name);
     nh.getParam("bus_params/baudrate", _baudrate);
+    nh.getParam("bus_params/max_baudrate", _max_baudrate);
+    nh.getParam("bus_params/baudrate_file", _baudrate_file);
+    _bus_baudrate = _baudrate;
+    nh.getParam("bus_params/use_bulk_transactions", _use_bulk_transactions);
+    nh.getParam("bus_params/bus_performance_profile/enabled", _use_bus_performance_profile);
+    int profile_return_delay_us{0};
+    nh.getParam("bus_params/bus_performance_profile/return_delay_time_us", profile_return_delay_us);
+    // the register counts in units of 2 us, an odd value would be written again at each start
+    _profile_return_delay_us = static_cast<uint32_t>(std::max(profile_return_delay_us, 0) / 2 * 2);
     nh.getParam("led_motor", _led_motor_type_cfg);
 
+    bool use_goal_delta_suppression{false};
+    int goal_delta_deadband{0};
+    double goal_delta_refresh_period{0.5};
+    nh.getParam("bus_params/goal_delta_suppression/enabled", use_goal_delta_suppression);
+    nh.getParam("bus_params/goal_delta_suppression/deadband", goal_delta_deadband);
+    nh.getParam("bus_params/goal_delta_suppression/refresh_period", goal_delta_refresh_period);
+    _goal_delta_filter.setDeadband(static_cast<uint32_t>(std::max(goal_delta_deadband, 0)));
+    _goal_delta_filter.setRefreshPeriod(goal_delta_refresh_period);
+    _goal_delta_filter.setEnabled(use_goal_delta_suppression);
+
     nh.getParam("simulation_mode", _simulation_mode);
     nh.getParam("simu_gripper", use_simu_gripper);
     nh.getParam("simu_conveyor", use_simu_conveyor);
@@ -127,13 +161,42 @@ bool TtlManager::init(ros::NodeHandle &nh)
 
         // init default ttl driver for common operations between drivers
         _default_ttl_driver = std::make_shared<StepperDriver<StepperReg>>(_portHandler, _packetHandler);
+
+        _bulk_read = std::make_unique<dynamixel::GroupBulkRead>(_portHandler.get(), _packetHandler.get());
+        _bulk_write = std::make_unique<dynamixel::GroupBulkWrite>(_portHandler.get(), _packetHandler.get());
+
+        std::string trace_file;
+        nh.getParam("bus_params/trace_file", trace_file);
+        if (!trace_file.empty())
+        {
+            _packet_tracer = std::make_unique<dynamixel::PacketTracer>();
+            if (_packet_tracer->start(trace_file.c_str()))
+            {
+                _portHandler->setPacketTracer(_packet_tracer.get());
+                ROS_INFO("TtlManager::init - Tracing the bus into %s", trace_file.c_str());
+            }
+            else
+            {
+                ROS_WARN("TtlManager::init - Unable to open the trace file %s", trace_file.c_str());
+                _packet_tracer.reset();
+            }
+        }
     }
     else
     {
         readFakeConfig(use_simu_gripper, use_simu_conveyor);
         _default_ttl_driver = std::make_shared<MockStepperDriver>(_fake_data);
+
+        // the fake bus only knows sync transactions
+        _use_bulk_transactions = false;
     }
 
+    ROS_DEBUG("TtlManager::init - bulk transactions: %s", _use_bulk_transactions ? "True" : "False");
+    ROS_DEBUG("TtlManager::init - bus performance profile: %s, return delay time %d us", _use_bus_performance_profile ? "True" : "False",
+              static_cast<int>(_profile_return_delay_us));
+    ROS_DEBUG("TtlManager::init - goal delta suppression: %s, deadband %d ticks, refresh period %f s", use_goal_delta_suppression ? "True" : "False",
+              goal_delta_deadband, goal_delta_refresh_period);
+
     return true;
 }
 
@@ -171,6 +234,19 @@ int TtlManager::setupCommunication()
                     // clear port
                     _portHandler->clearPort();
 
+                    // the devices keep the baud rate negotiated at the previous start
+                    int saved_baudrate = readSavedBaudRate();
+                    if (saved_baudrate > 0 && saved_baudrate != _baudrate && !probeBaudRate(saved_baudrate))
+                    {
+                        ROS_WARN("TtlManager::setupCommunication - No device found at the saved baud rate %d, back to %d", saved_baudrate, _baudrate);
+                        _portHandler->setBaudRate(_baudrate);
+                        _portHandler->clearPort();
+                    }
+                    _bus_baudrate = _portHandler->getBaudRate();
+
+                    ROS_INFO("TtlManager::setupCommunication - Dxl port %s : low latency %s, latency timer %d ms", _device_name.c_str(),
+                             _portHandler->isLowLatency() ? "on" : "off", _portHandler->getLatencyTimer());
+
                     ret = COMM_SUCCESS;
                 }
                 else
@@ -209,6 +285,7 @@ int TtlManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
 
         // add state to state map
         _state_map[id] = state;
+        _goal_delta_filter.invalidate(id);
 
         // add id to ids_map
         _ids_map[hardware_type].emplace_back(id);
@@ -221,6 +298,7 @@ int TtlManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
         }
 
         addHardwareDriver(hardware_type);
+        _bulk_read_outdated = true;
 
         // update firmware version
         if (_driver_map.at(hardware_type))
@@ -244,6 +322,8 @@ int TtlManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
                          "hardware id %d : result = %d",
                          id, res);
             }
+
+            setupComponentTiming(id, hardware_type);
         }
 
         setLeds(_led_state);
@@ -275,8 +355,21 @@ void TtlManager::removeHardwareComponent(uint8_t id)
             }
         }
 
+        // the next motor with this id can have another firmware and another timing
+        if (_driver_map.count(type) && _driver_map.at(type))
+        {
+            _driver_map.at(type)->setFastSyncReadAvailable(id, false);
+            _driver_map.at(type)->setTxOnlyWrite(id, false);
+        }
+        if (_portHandler)
+            _portHandler->clearDeviceTiming(id);
+
         _state_map.erase(id);
     }
+    // samples are added back by the next read
+    _joint_states.clear();
+    _bulk_read_outdated = true;
+
     // remove id from conveyor list if they contains id
     _conveyor_list.erase(std::remove(_conveyor_list.begin(), _conveyor_list.end(), id), _conveyor_list.end());
 
@@ -289,7 +382,7 @@ void TtlManager::removeHardwareComponent(uint8_t id)
  * @return true
  * @return false
  */
-bool TtlManager::isMotorType(EHardwareType type)
+bool TtlManager::isMotorType(EHardwareType type) const
 {
     // All motors have value under 7 (check in EHardwareType)
     return (static_cast<int>(type) <= 7);
@@ -369,6 +462,8 @@ int TtlManager::scanAndCheck()
     int result = COMM_PORT_BUSY;
 
     _is_connection_ok = false;
+    // the motors may have been restarted, their goals are unknown
+    _goal_delta_filter.reset();
 
     // 1. retrieve list of connected motors
     _all_ids_connected.clear();
@@ -445,6 +540,285 @@ bool TtlManager::ping(uint8_t id)
     return result;
 }
 
+/**
+ * @brief TtlManager::setupComponentTiming
+ * @param id
+ * @param hardware_type
+ * Applies the bus performance profile if it is enabled, then gives the return delay time of the component to the port handler
+ */
+void TtlManager::setupComponentTiming(uint8_t id, EHardwareType hardware_type)
+{
+    auto driver = _driver_map.at(hardware_type);
+    uint32_t return_delay_us = 0;
+    int res = driver->readReturnDelayTime(id, return_delay_us);
+
+    if (_use_bus_performance_profile)
+    {
+        // EEPROM : only written when it changes, and only accepted with the torque disabled
+        if (COMM_SUCCESS == res && return_delay_us != _profile_return_delay_us)
+        {
+            std::vector<uint8_t> torque_ids;
+            int write_res = disableTorque({id}, torque_ids);
+            if (COMM_SUCCESS == write_res)
+                write_res = driver->writeReturnDelayTime(id, _profile_return_delay_us);
+            restoreTorque(torque_ids);
+
+            ROS_WARN_COND(COMM_SUCCESS != write_res, "TtlManager::setupComponentTiming - Unable to set the return delay time of hardware id %d : result = %d", id, write_res);
+            res = driver->readReturnDelayTime(id, return_delay_us);
+        }
+
+        // the reads are still answered
+        int level_res = driver->writeStatusReturnLevel(id, AbstractTtlDriver::STATUS_RETURN_PING_READ);
+        ROS_WARN_COND(COMM_SUCCESS != level_res && COMM_NOT_AVAILABLE != level_res,
+                      "TtlManager::setupComponentTiming - Unable to set the status return level of hardware id %d : result = %d", id, level_res);
+    }
+
+    // the status packets of this component are waited for its return delay time
+    if (_portHandler && COMM_SUCCESS == res)
+        _portHandler->setReturnDelayTime(id, return_delay_us);
+}
+
+/**
+ * @brief TtlManager::isBaudRateNegotiable
+ * @return true if the bus can be switched above the configured baud rate (max_baudrate),
+ * or runs at a baud rate kept from a previous negotiation
+ */
+bool TtlManager::isBaudRateNegotiable() const
+{
+    return !_simulation_mode && _portHandler && (_max_baudrate > _baudrate || _bus_baudrate != _baudrate);
+}
+
+/**
+ * @brief TtlManager::negotiateBaudRate : switches the bus to the highest baud rate supported by all its devices, up to max_baudrate
+ * @return COMM_SUCCESS if the bus runs at the negotiated baud rate.
+ * Otherwise all the devices are put back at DEFAULT_BAUDRATE, and the negotiated baud rate is not saved
+ */
+int TtlManager::negotiateBaudRate()
+{
+    if (!isBaudRateNegotiable() || !_default_ttl_driver)
+        return COMM_NOT_AVAILABLE;
+
+    // every device of the bus has to be switched, its driver has to be known
+    vector<uint8_t> id_list;
+    int result = getAllIdsOnBus(id_list);
+    if (COMM_SUCCESS != result)
+        return result;
+
+    vector<shared_ptr<AbstractTtlDriver>> drivers;
+    for (auto const id : id_list)
+    {
+        EHardwareType type = _state_map.count(id) && _state_map.at(id) ? _state_map.at(id)->getHardwareType() : EHardwareType::UNKNOWN;
+        if (!_driver_map.count(type) || !_driver_map.at(type))
+        {
+            ROS_WARN("TtlManager::negotiateBaudRate - Unknown device %d on the bus, the baud rate is kept", id);
+            return COMM_NOT_AVAILABLE;
+        }
+        drivers.emplace_back(_driver_map.at(type));
+    }
+
+    int baudrate = AbstractTtlDriver::DEFAULT_BAUDRATE;
+    for (int candidate : {4000000, 3000000, 2000000})
+    {
+        if (candidate <= _max_baudrate &&
+            std::all_of(drivers.begin(), drivers.end(), [candidate](const shared_ptr<AbstractTtlDriver> &driver) { return driver->isBaudRateSupported(candidate); }))
+        {
+            baudrate = candidate;
+            break;
+        }
+    }
+
+    int current_baudrate = _portHandler->getBaudRate();
+    if (baudrate == current_baudrate)
+        return COMM_SUCCESS;
+
+    // the baud rate is in EEPROM : the torque of the motors is disabled while it is written, then restored
+    vector<uint8_t> torque_ids;
+    result = disableTorque(id_list, torque_ids);
+
+    if (COMM_SUCCESS == result)
+    {
+        ROS_INFO("TtlManager::negotiateBaudRate - Switch the bus from %d to %d bauds", current_baudrate, baudrate);
+        result = switchBaudRate(id_list, baudrate);
+        if (COMM_SUCCESS != result)
+        {
+            ROS_WARN("TtlManager::negotiateBaudRate - Failed to switch the bus to %d bauds (result : %d), back to %d bauds", baudrate, result,
+                     AbstractTtlDriver::DEFAULT_BAUDRATE);
+
+            // some devices can have switched, some not : they are written at both baud rates, until they all answer at DEFAULT_BAUDRATE
+            _portHandler->setBaudRate(baudrate);
+            int rollback_result = switchBaudRate(id_list, AbstractTtlDriver::DEFAULT_BAUDRATE);
+            if (COMM_SUCCESS != rollback_result)
+            {
+                _portHandler->setBaudRate(current_baudrate);
+                rollback_result = switchBaudRate(id_list, AbstractTtlDriver::DEFAULT_BAUDRATE);
+            }
+
+            if (COMM_SUCCESS != rollback_result)
+            {
+                ROS_ERROR("TtlManager::negotiateBaudRate - Devices missing after the switch back to %d bauds (result : %d)",
+                          AbstractTtlDriver::DEFAULT_BAUDRATE, rollback_result);
+                _debug_error_message = "TtlManager - Failed to switch the bus back to its default baud rate";
+            }
+        }
+    }
+    else
+    {
+        ROS_WARN("TtlManager::negotiateBaudRate - Unable to disable the torque of the motors (result : %d), the baud rate is kept", result);
+    }
+
+    _bus_baudrate = _portHandler->getBaudRate();
+
+    // at the baud rate the devices answer now
+    restoreTorque(torque_ids);
+
+    // a fallback is not saved : the next start probes the configured baud rate first
+    if (COMM_SUCCESS == result)
+        saveBaudRate(baudrate);
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::disableTorque : disables the torque of the motors before an EEPROM write
+ * @param id_list : devices of the bus, the ones without torque are skipped
+ * @param torque_ids : motors whose torque was enabled, to be restored with restoreTorque
+ * @return
+ */
+int TtlManager::disableTorque(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_ids)
+{
+    for (auto const id : id_list)
+    {
+        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(_state_map.at(id)->getHardwareType()));
+        if (!driver)
+            continue;
+
+        uint8_t torque_enable{0};
+        int res = driver->readTorqueEnable(id, torque_enable);
+        if (COMM_SUCCESS == res && torque_enable)
+        {
+            res = driver->writeTorqueEnable(id, 0);
+            if (COMM_SUCCESS == res)
+                torque_ids.emplace_back(id);
+        }
+
+        if (COMM_SUCCESS != res)
+        {
+            ROS_WARN("TtlManager::disableTorque - Failed to disable the torque of device %d : result = %d", id, res);
+            return res;
+        }
+    }
+
+    return COMM_SUCCESS;
+}
+
+/**
+ * @brief TtlManager::restoreTorque : enables the torque of the motors disabled by disableTorque
+ * @param torque_ids
+ */
+void TtlManager::restoreTorque(const std::vector<uint8_t> &torque_ids)
+{
+    for (auto const id : torque_ids)
+    {
+        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(_state_map.at(id)->getHardwareType()));
+        if (driver && COMM_SUCCESS != driver->writeTorqueEnable(id, 1))
+        {
+            ROS_ERROR("TtlManager::restoreTorque - Failed to enable the torque of device %d", id);
+            _debug_error_message = "TtlManager - Failed to enable the torque after an EEPROM write";
+        }
+    }
+}
+
+/**
+ * @brief TtlManager::switchBaudRate : writes the baud rate of the devices, then switches the port and checks that they all answer
+ * @param id_list
+ * @param baudrate
+ * @return
+ */
+int TtlManager::switchBaudRate(const std::vector<uint8_t> &id_list, int baudrate)
+{
+    int result = COMM_SUCCESS;
+
+    // each device answers at the current baud rate, then switches
+    for (auto const id : id_list)
+    {
+        int res = _driver_map.at(_state_map.at(id)->getHardwareType())->writeBaudRate(id, baudrate);
+        if (COMM_SUCCESS != res)
+        {
+            ROS_WARN("TtlManager::switchBaudRate - Failed to write the baud rate of device %d : result = %d", id, res);
+            result = res;
+        }
+    }
+
+    if (!_portHandler->setBaudRate(baudrate))
+        return TTL_FAIL_PORT_SET_BAUDRATE;
+    _portHandler->clearPort();
+
+    vector<uint8_t> found_ids;
+    int res = _default_ttl_driver->scan(found_ids);
+    if (COMM_SUCCESS == result)
+        result = res;
+
+    for (auto const id : id_list)
+    {
+        if (COMM_SUCCESS == result && std::find(found_ids.begin(), found_ids.end(), id) == found_ids.end())
+        {
+            ROS_WARN("TtlManager::switchBaudRate - Device %d does not answer at %d bauds", id, baudrate);
+            result = COMM_RX_TIMEOUT;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::probeBaudRate : switches the port only
+ * @param baudrate
+ * @return true if at least one device answers at this baud rate
+ */
+bool TtlManager::probeBaudRate(int baudrate)
+{
+    if (!_portHandler->setBaudRate(baudrate))
+        return false;
+    _portHandler->clearPort();
+
+    vector<uint8_t> found_ids;
+    return COMM_SUCCESS == _default_ttl_driver->scan(found_ids) && !found_ids.empty();
+}
+
+/**
+ * @brief TtlManager::readSavedBaudRate
+ * @return the baud rate saved by the last negotiation, -1 if none
+ */
+int TtlManager::readSavedBaudRate() const
+{
+    int baudrate = -1;
+
+    if (!_baudrate_file.empty())
+    {
+        std::ifstream baudrate_file(_baudrate_file.c_str());
+        if (!(baudrate_file >> baudrate))
+            baudrate = -1;
+    }
+
+    return baudrate;
+}
+
+/**
+ * @brief TtlManager::saveBaudRate
+ * @param baudrate
+ */
+void TtlManager::saveBaudRate(int baudrate) const
+{
+    if (_baudrate_file.empty())
+        return;
+
+    std::ofstream baudrate_file(_baudrate_file.c_str());
+    if (baudrate_file.is_open())
+        baudrate_file << baudrate;
+    else
+        ROS_WARN("TtlManager::saveBaudRate - Unable to open file : %s", _baudrate_file.c_str());
+}
+
 /**
  * @brief TtlManager::rebootHardware
  * @param hw_id
@@ -461,27 +835,36 @@ int TtlManager::rebootHardware(uint8_t hw_id)
         if (_driver_map.count(type) && _driver_map.at(type))
         {
             return_value = _driver_map.at(type)->reboot(hw_id);
-            if (COMM_SUCCESS == return_value)
+
+            // the status of the reboot may be lost (status return level, restart before the answer) :
+            // the device is checked by reading its firmware version whatever the result
+            std::string version;
+            int res = COMM_RX_FAIL;
+            for (int tries = 10; tries > 0; tries--)
             {
-                std::string version;
-                int res = COMM_RX_FAIL;
-                for (int tries = 10; tries > 0; tries--)
+                res = _driver_map.at(type)->readFirmwareVersion(hw_id, version);
+                if (COMM_SUCCESS == res)
                 {
-                    res = _driver_map.at(type)->readFirmwareVersion(hw_id, version);
-                    if (COMM_SUCCESS == res)
-                    {
-                        _state_map.at(hw_id)->setFirmwareVersion(version);
-                        break;
-                    }
-                    ros::Duration(0.1).sleep();
+                    _state_map.at(hw_id)->setFirmwareVersion(version);
+                    break;
                 }
+                ros::Duration(0.1).sleep();
+            }
 
-                if (COMM_SUCCESS != res)
-                {
-                    ROS_WARN("TtlManager::addHardwareComponent : Unable to retrieve firmware version for "
-                             "hardware id %d : result = %d",
-                             hw_id, res);
-                }
+            if (COMM_SUCCESS != res)
+            {
+                ROS_WARN("TtlManager::addHardwareComponent : Unable to retrieve firmware version for "
+                         "hardware id %d : result = %d",
+                         hw_id, res);
+            }
+            else
+            {
+                // the reboot restores the status return level
+                setupComponentTiming(hw_id, type);
+
+                // the reboot was sent but not answered, and the device is back
+                if (COMM_RX_TIMEOUT == return_value)
+                    return_value = COMM_SUCCESS;
             }
             ROS_WARN_COND(COMM_SUCCESS != return_value, "TtlManager::rebootHardware - Failed to reboot hardware: %d", return_value);
         }
@@ -506,14 +889,19 @@ void TtlManager::resetTorques()
             // we retrieve all the associated id for the type of the current driver
             vector<uint8_t> ids_list = _ids_map.at(hw_type);
 
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint32_t> position_list;
+            // one sync write for all the motors of this driver, one write per motor if it fails
+            vector<uint8_t> torque_list(ids_list.size(), 1);
 
-            for (size_t i = 0; i < ids_list.size(); ++i)
+            ROS_DEBUG("TtlManager::resetTorques - Torque ON on %d motors of type %s", static_cast<int>(ids_list.size()),
+                      HardwareTypeEnum(hw_type).toString().c_str());
+            if (COMM_SUCCESS != driver->syncWriteTorqueEnable(ids_list, torque_list))
             {
-                ROS_DEBUG("TtlManager::resetTorques - Torque ON on stepper ID: %d", static_cast<int>(ids_list.at(i)));
-                driver->writeTorqueEnable(ids_list.at(i), 1);
-            }  // for ids_list
+                for (size_t i = 0; i < ids_list.size(); ++i)
+                {
+                    ROS_DEBUG("TtlManager::resetTorques - Torque ON on stepper ID: %d", static_cast<int>(ids_list.at(i)));
+                    driver->writeTorqueEnable(ids_list.at(i), 1);
+                }  // for ids_list
+            }
         }
     }  // for _driver_map
 }
@@ -637,7 +1025,78 @@ bool TtlManager::readJointsStatus()
 {
     uint8_t hw_errors_increment = 0;
 
-    // syncread position for all motors.
+    // read position, velocity and load of all motors in a single bulk read, each type of motor with its own registers
+    // fall back on one sync read per driver if the bulk read fails
+    if (_use_bulk_transactions)
+    {
+        if (bulkReadJointsStatus())
+        {
+            _bulk_fail_counter = 0;
+        }
+        else
+        {
+            hw_errors_increment = syncReadJointsStatus();
+
+            // sync reads succeed where the bulk read fails : some motors do not handle bulk transactions
+            if (0 == hw_errors_increment && ++_bulk_fail_counter >= MAX_BULK_FAILURE)
+            {
+                ROS_WARN("TtlManager::readJointsStatus - bulk read keeps failing, bulk transactions disabled");
+                _use_bulk_transactions = false;
+            }
+        }
+    }
+    else
+    {
+        hw_errors_increment = syncReadJointsStatus();
+    }
+
+    // joints of a failed driver keep the stamp of their last successful read
+    _joint_states.cycle++;
+    _joint_states.stamp = ros::Time::now().toSec();
+
+    // check collision by END_EFFECTOR
+    if (_isRealCollision)
+    {
+        readCollisionStatus();
+    }
+    else
+    {
+        _collision_status = false;
+        // check collision by END_EFFECTOR
+        if (_isRealCollision)
+        {
+            checkCollision();
+        }
+        else
+        {
+            _collision_status = false;
+        }
+    }
+
+    ROS_DEBUG_THROTTLE(2, "_hw_fail_counter_read, hw_errors_increment: %d, %d", _hw_fail_counter_read, hw_errors_increment);
+
+    // we reset the global error variable only if no errors
+    if (0 == hw_errors_increment)
+    {
+        _hw_fail_counter_read = 0;
+    }
+    else
+    {
+        _hw_fail_counter_read += hw_errors_increment;
+    }
+
+    return (0 == hw_errors_increment);
+}
+
+/**
+ * @brief TtlManager::syncReadJointsStatus : one sync read per driver
+ * @return number of drivers in error
+ */
+uint8_t TtlManager::syncReadJointsStatus()
+{
+    uint8_t hw_errors_increment = 0;
+
+    // syncread position, velocity and load for all motors, in one sync read per driver
     // for ned and one -> we need at least one xl430 and one xl320 drivers as they are different
 
     for (auto const &it : _driver_map)
@@ -648,38 +1107,32 @@ bool TtlManager::readJointsStatus()
         if (driver && _ids_map.count(hw_type) && !_ids_map.at(hw_type).empty())
         {
             // we retrieve all the associated id for the type of the current driver
-            vector<uint8_t> ids_list = _ids_map.at(hw_type);
+            const vector<uint8_t> &ids_list = _ids_map.at(hw_type);
 
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint32_t> position_list;
+            // {position, velocity, load} of each motor
+            ttl_driver::JointStatusList joint_status_list;
 
             // retrieve joint status
-            int res = driver->syncReadPosition(ids_list, position_list);
+            auto start = BusMetrics::Clock::now();
+            int res = driver->syncReadJointStatus(ids_list, joint_status_list);
+            _bus_metrics.record(EBusTransaction::JOINTS_READ, hw_type, toBusResult(res), start);
+
             if (COMM_SUCCESS == res)
             {
-                if (ids_list.size() == position_list.size())
+                if (ids_list.size() == joint_status_list.size())
                 {
+                    double read_stamp = ros::Time::now().toSec();
+
                     // set motors states accordingly
                     for (size_t i = 0; i < ids_list.size(); ++i)
-                    {
-                        uint8_t id = ids_list.at(i);
-
-                        if (_state_map.count(id))
-                        {
-                            auto state = std::dynamic_pointer_cast<common::model::AbstractMotorState>(_state_map.at(id));
-                            if (state)
-                            {
-                                state->setPosition(static_cast<int>((position_list.at(i))));
-                            }
-                        }
-                    }
+                        setJointStatus(ids_list.at(i), joint_status_list.at(i), read_stamp);
                 }
                 else
                 {
                     // warn to avoid sound and light error on high level (error on ROS_ERROR)
                     ROS_WARN("TtlManager::readJointStatus : Fail to sync read joint state - "
-                             "vector mismatch (id_list size %d, position_list size %d)",
-                             static_cast<int>(ids_list.size()), static_cast<int>(position_list.size()));
+                             "vector mismatch (id_list size %d, joint_status_list size %d)",
+                             static_cast<int>(ids_list.size()), static_cast<int>(joint_status_list.size()));
                     hw_errors_increment++;
                 }
             }
@@ -688,44 +1141,114 @@ bool TtlManager::readJointsStatus()
                 // debug to avoid sound and light error on high level (error on ROS_ERROR)
                 // also for Ned which has much more errors on XL320 motor
                 ROS_DEBUG("TtlManager::readJointStatus : Fail to sync read joint state - "
-                          "driver fail to syncReadPosition");
+                          "driver fail to syncReadJointStatus");
                 hw_errors_increment++;
             }
         }
     }  // for driver_map
 
-    // check collision by END_EFFECTOR
-    if (_isRealCollision)
+    return hw_errors_increment;
+}
+
+/**
+ * @brief TtlManager::bulkReadJointsStatus : a single bulk read for the motors of all drivers
+ * @return false if the bulk read failed or a motor is missing from it, no motor state is updated then
+ */
+bool TtlManager::bulkReadJointsStatus()
+{
+    if (!_bulk_read)
+        return false;
+
+    // the parameters of the bulk read only change with the motors of the bus
+    if (_bulk_read_outdated)
+    {
+        _bulk_read->clearParam();
+        _bulk_read_motors.clear();
+
+        for (auto const &it : _ids_map)
+        {
+            std::shared_ptr<ttl_driver::AbstractMotorDriver> driver;
+            if (_driver_map.count(it.first))
+                driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(_driver_map.at(it.first));
+
+            if (!driver)
+                continue;
+
+            for (auto const id : it.second)
+            {
+                if (COMM_SUCCESS != driver->addJointStatusToBulkRead(*_bulk_read, id))
+                {
+                    ROS_DEBUG("TtlManager::bulkReadJointsStatus - unable to add motor %d to bulk read", id);
+                    _bulk_read->clearParam();
+                    _bulk_read_motors.clear();
+                    return false;
+                }
+
+                _bulk_read_motors.emplace_back(id, driver);
+            }
+        }
+
+        _bulk_read_status.resize(_bulk_read_motors.size());
+        _bulk_read_outdated = false;
+    }
+
+    // nothing to read
+    if (_bulk_read_motors.empty())
+        return true;
+
+    auto start = BusMetrics::Clock::now();
+    int res = _bulk_read->txRxPacket();
+    _bus_metrics.record(EBusTransaction::JOINTS_READ, EHardwareType::UNKNOWN, toBusResult(res), start);
+
+    if (COMM_SUCCESS != res)
     {
-        readCollisionStatus();
+        ROS_DEBUG("TtlManager::bulkReadJointsStatus - Fail to bulk read joint state");
+        return false;
     }
-    else
+
+    double read_stamp = ros::Time::now().toSec();
+
+    // all the motors are decoded before any state is updated : the sync reads of the fallback read them all again
+    for (size_t i = 0; i < _bulk_read_motors.size(); ++i)
     {
-        _collision_status = false;
-        // check collision by END_EFFECTOR
-        if (_isRealCollision)
-        {
-            checkCollision();
-        }
-        else
+        auto const &motor = _bulk_read_motors.at(i);
+        if (COMM_SUCCESS != motor.second->getJointStatusFromBulkRead(*_bulk_read, motor.first, _bulk_read_status.at(i)))
         {
-            _collision_status = false;
+            ROS_DEBUG("TtlManager::bulkReadJointsStatus - no joint state for motor %d", motor.first);
+            return false;
         }
     }
 
-    ROS_DEBUG_THROTTLE(2, "_hw_fail_counter_read, hw_errors_increment: %d, %d", _hw_fail_counter_read, hw_errors_increment);
+    for (size_t i = 0; i < _bulk_read_motors.size(); ++i)
+        setJointStatus(_bulk_read_motors.at(i).first, _bulk_read_status.at(i), read_stamp);
 
-    // we reset the global error variable only if no errors
-    if (0 == hw_errors_increment)
-    {
-        _hw_fail_counter_read = 0;
-    }
-    else
+    return true;
+}
+
+/**
+ * @brief TtlManager::setJointStatus : update the state of a motor and its sample in the joint states snapshot
+ * @param id
+ * @param joint_status : {position, velocity, load}
+ * @param read_stamp
+ */
+void TtlManager::setJointStatus(uint8_t id, const std::array<uint32_t, 3> &joint_status, double read_stamp)
+{
+    if (!_state_map.count(id))
+        return;
+
+    auto state = std::dynamic_pointer_cast<common::model::AbstractMotorState>(_state_map.at(id));
+    if (state)
     {
-        _hw_fail_counter_read += hw_errors_increment;
-    }
+        state->setPosition(static_cast<int>(joint_status.at(0)));
+        state->setVelocity(static_cast<int>(joint_status.at(1)));
+        state->setTorque(static_cast<int>(joint_status.at(2)));
 
-    return (0 == hw_errors_increment);
+        if (common::model::EComponentType::JOINT == state->getComponentType() &&
+            !_joint_states.update(id, state->getPosition(), state->getVelocity(), state->getTorque(), read_stamp))
+        {
+            ROS_WARN_THROTTLE(1.0, "TtlManager::readJointStatus - joint states snapshot full, joint %d ignored", id);
+        }
+    }
 }
 
 /**
@@ -763,7 +1286,11 @@ bool TtlManager::readEndEffectorStatus()
 
                             // **********  buttons
                             // get action of free driver button, save pos button, custom button
-                            if (COMM_SUCCESS == driver->syncReadButtonsStatus(id, action_list))
+                            auto start = BusMetrics::Clock::now();
+                            int read_res = driver->syncReadButtonsStatus(id, action_list);
+                            _bus_metrics.record(EBusTransaction::END_EFFECTOR_READ, ee_type, toBusResult(read_res), start);
+
+                            if (COMM_SUCCESS == read_res)
                             {
                                 for (uint8_t i = 0; i < action_list.size(); i++)
                                 {
@@ -791,7 +1318,11 @@ bool TtlManager::readEndEffectorStatus()
 
                             // **********  digital data
                             bool digital_data{};
-                            if (COMM_SUCCESS == driver->readDigitalInput(id, digital_data))
+                            start = BusMetrics::Clock::now();
+                            read_res = driver->readDigitalInput(id, digital_data);
+                            _bus_metrics.record(EBusTransaction::END_EFFECTOR_READ, ee_type, toBusResult(read_res), start);
+
+                            if (COMM_SUCCESS == read_res)
                             {
                                 state->setDigitalIn(digital_data);
                             }
@@ -990,7 +1521,11 @@ bool TtlManager::readHardwareStatus()
             // **********  voltage and Temperature
             vector<std::pair<double, uint8_t>> hw_data_list;
 
-            if (COMM_SUCCESS != driver->syncReadHwStatus(ids_list, hw_data_list))
+            auto start = BusMetrics::Clock::now();
+            int read_res = driver->syncReadHwStatus(ids_list, hw_data_list);
+            _bus_metrics.record(EBusTransaction::HW_STATUS_READ, type, toBusResult(read_res), start);
+
+            if (COMM_SUCCESS != read_res)
             {
                 // this operation can fail, it is normal, so no error message
                 hw_errors_increment++;
@@ -1008,7 +1543,11 @@ bool TtlManager::readHardwareStatus()
             // **********  error state
             vector<uint8_t> hw_error_status_list;
 
-            if (COMM_SUCCESS != driver->syncReadHwErrorStatus(ids_list, hw_error_status_list))
+            start = BusMetrics::Clock::now();
+            read_res = driver->syncReadHwErrorStatus(ids_list, hw_error_status_list);
+            _bus_metrics.record(EBusTransaction::HW_STATUS_READ, type, toBusResult(read_res), start);
+
+            if (COMM_SUCCESS != read_res)
             {
                 hw_errors_increment++;
             }
@@ -1403,7 +1942,10 @@ int TtlManager::sendCustomCommand(uint8_t id, int reg_address, int value, int by
         if (_driver_map.count(motor_type) && _driver_map.at(motor_type))
         {
             int32_t value_conv = value;
+            auto start = BusMetrics::Clock::now();
             result = _driver_map.at(motor_type)->writeCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, static_cast<uint32_t>(value_conv));
+            _bus_metrics.record(EBusTransaction::SINGLE_WRITE, motor_type, toBusResult(result), start);
+
             if (result != COMM_SUCCESS)
             {
                 ROS_WARN("TtlManager::sendCustomCommand - Failed to write custom command: %d", result);
@@ -1447,7 +1989,10 @@ int TtlManager::readCustomCommand(uint8_t id, int32_t reg_address, int &value, i
         if (_driver_map.count(motor_type) && _driver_map.at(motor_type))
         {
             uint32_t data = 0;
+            auto start = BusMetrics::Clock::now();
             result = _driver_map.at(motor_type)->readCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, data);
+            _bus_metrics.record(EBusTransaction::SINGLE_READ, motor_type, toBusResult(result), start);
+
             auto data_conv = static_cast<int32_t>(data);
             value = data_conv;
 
@@ -1635,73 +2180,142 @@ int TtlManager::readControlMode(uint8_t id, uint8_t &control_mode)
 }
 
 /**
- * @brief TtlManager::writeSynchronizeCommand
+ * @brief TtlManager::writeSynchronizeCommand : blocking version, retries the failing drivers until the command is done
  * @param cmd
  * @return
  */
 int TtlManager::writeSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &&cmd)  // NOLINT
 {
-    int result = COMM_TX_ERROR;
     ROS_DEBUG_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand:  %s", cmd->str().c_str());
 
-    if (cmd->isValid())
+    if (!cmd->isValid())
     {
-        std::set<EHardwareType> typesToProcess = cmd->getMotorTypes();
+        ROS_ERROR("TtlManager::writeSynchronizeCommand - Invalid command");
+        _debug_error_message = "TtlManager - Failed to write synchronize position";
+        return COMM_TX_ERROR;
+    }
 
-        // process all the motors using each successive drivers
-        for (uint32_t counter = 0; counter < MAX_HW_FAILURE; ++counter)
-        {
-            ROS_DEBUG_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand: try to sync write (counter %d)", counter);
+    SyncCmdRetryMachineState retry_state;
+    retry_state.start(cmd->getMotorTypes());
 
-            for (auto const &it : _driver_map)
-            {
-                if (typesToProcess.count(it.first) != 0)
-                {
-                    result = COMM_TX_ERROR;
+    int result = stepSynchronizeCommand(*cmd, retry_state);
+    while (retry_state.isPending())
+    {
+        ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+        result = stepSynchronizeCommand(*cmd, retry_state);
+    }
 
-                    // syncwrite for this driver. The driver is responsible for sync write only to its associated motors
-                    auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(it.second);
-                    if (driver)
-                    {
-                        result = driver->writeSyncCmd(cmd->getCmdType(), cmd->getMotorsId(it.first), cmd->getParams(it.first));
+    return result;
+}
 
-                        ros::Duration(0.05).sleep();
-                    }
+/**
+ * @brief TtlManager::startSynchronizeCommand : non blocking version, the command is then written by processSynchronizeCommand
+ * @param cmd
+ * @return
+ */
+int TtlManager::startSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &&cmd)  // NOLINT
+{
+    ROS_DEBUG_THROTTLE(0.5, "TtlManager::startSynchronizeCommand:  %s", cmd->str().c_str());
 
-                    // if successful, don't process this driver in the next loop
-                    if (COMM_SUCCESS == result)
-                    {
-                        typesToProcess.erase(typesToProcess.find(it.first));
-                    }
-                    else
-                    {
-                        ROS_ERROR("TtlManager::writeSynchronizeCommand : unable to sync write function : %d", result);
-                    }
-                }
-            }
+    if (!cmd->isValid())
+    {
+        ROS_ERROR("TtlManager::startSynchronizeCommand - Invalid command");
+        _debug_error_message = "TtlManager - Failed to write synchronize position";
+        return COMM_TX_ERROR;
+    }
 
-            // if all drivers are processed, go out of for loop
-            if (typesToProcess.empty())
-            {
-                result = COMM_SUCCESS;
-                break;
-            }
+    _pending_sync_cmd = std::move(cmd);
+    _sync_cmd_retry.start(_pending_sync_cmd->getMotorTypes());
 
-            ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
-        }
-    }
-    else
+    return COMM_SUCCESS;
+}
+
+/**
+ * @brief TtlManager::processSynchronizeCommand : write the pending sync command for the drivers whose retry delay is over
+ * To be called once per cycle, never waits
+ * @return COMM_SUCCESS if the command is written or still pending, the error of a driver given up otherwise
+ */
+int TtlManager::processSynchronizeCommand()
+{
+    if (!_pending_sync_cmd)
+        return COMM_SUCCESS;
+
+    int result = stepSynchronizeCommand(*_pending_sync_cmd, _sync_cmd_retry);
+
+    if (!_sync_cmd_retry.isPending())
+        _pending_sync_cmd.reset();
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::cancelSynchronizeCommand : drop the pending sync command, the drivers not written yet are not retried
+ */
+void TtlManager::cancelSynchronizeCommand()
+{
+    _pending_sync_cmd.reset();
+}
+
+/**
+ * @brief TtlManager::stepSynchronizeCommand : one attempt cycle of a sync command
+ * @param cmd
+ * @param retry_state
+ * @return COMM_SUCCESS while no driver has been given up
+ */
+int TtlManager::stepSynchronizeCommand(const common::model::AbstractTtlSynchronizeMotorCmd &cmd, SyncCmdRetryMachineState &retry_state)
+{
+    double now = ros::Time::now().toSec();
+
+    // the command may move the motors or change their torque, the next trajectory goals are all written.
+    // Done at each attempt cycle : goals transmitted between two cycles of a pending command are overwritten too
+    _goal_delta_filter.reset();
+
+    // sync write for each driver. The driver is responsible for sync write only to its associated motors
+    for (auto const type : retry_state.nextCycle(now))
     {
-        ROS_ERROR("TtlManager::writeSynchronizeCommand - Invalid command");
+        int result = COMM_TX_ERROR;
+
+        if (_driver_map.count(type))
+        {
+            auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(type));
+            if (driver)
+                result = driver->writeSyncCmd(cmd.getCmdType(), cmd.getMotorsId(type), cmd.getParams(type));
+        }
+
+        if (COMM_SUCCESS == result)
+        {
+            retry_state.success(type);
+        }
+        else if (retry_state.failure(type, result, now))
+        {
+            ROS_DEBUG("TtlManager::stepSynchronizeCommand - unable to sync write for %s (%d), retry later",
+                      HardwareTypeEnum(type).toString().c_str(), result);
+        }
+        else
+        {
+            ROS_ERROR("TtlManager::stepSynchronizeCommand - unable to sync write for %s : %d",
+                      HardwareTypeEnum(type).toString().c_str(), result);
+        }
     }
 
-    if (COMM_SUCCESS != result)
+    if (retry_state.isPending())
+        return retry_state.getResult();
+
+    // command done, record the number of cycles it needed
+    uint32_t nb_cycles = retry_state.getNbCycles();
+    _last_sync_cmd_cycles.store(nb_cycles, std::memory_order_relaxed);
+    if (nb_cycles > _max_sync_cmd_cycles.load(std::memory_order_relaxed))
+        _max_sync_cmd_cycles.store(nb_cycles, std::memory_order_relaxed);
+    ROS_DEBUG_COND(nb_cycles > 1, "TtlManager::stepSynchronizeCommand - sync command written in %d cycles",
+                   static_cast<int>(nb_cycles));
+
+    if (COMM_SUCCESS != retry_state.getResult())
     {
-        ROS_ERROR_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand - Failed to write synchronize position");
+        ROS_ERROR_THROTTLE(0.5, "TtlManager::stepSynchronizeCommand - Failed to write synchronize position");
         _debug_error_message = "TtlManager - Failed to write synchronize position";
     }
 
-    return result;
+    return retry_state.getResult();
 }
 
 /**
@@ -1714,6 +2328,7 @@ int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSin
     int result = COMM_TX_ERROR;
 
     uint8_t id = cmd->getId();
+    _goal_delta_filter.invalidate(id);
 
     if (cmd->isValid())
     {
@@ -1731,12 +2346,15 @@ int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSin
                 if (_driver_map.count(hardware_type) && _driver_map.at(hardware_type))
                 {
                     // writeSingleCmd is in a for loop, we cannot infer that this command will succeed. Thus we cannot move cmd in parameter
+                    auto start = BusMetrics::Clock::now();
                     result = _driver_map.at(hardware_type)->writeSingleCmd(cmd);
+                    _bus_metrics.record(EBusTransaction::SINGLE_WRITE, hardware_type, toBusResult(result), start);
                 }
 
                 counter += 1;
 
-                ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+                if (COMM_SUCCESS != result)
+                    ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
             }
         }
         else
@@ -1755,18 +2373,137 @@ int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSin
     return result;
 }
 
+/**
+ * @brief TtlManager::writeSingleCommands : write a list of single commands, merging them into sync writes when possible
+ * @param cmds
+ * @return COMM_SUCCESS if all the commands have been written, the last error otherwise
+ * Commands of the same type handled by the same driver (thus writing the same register with the same data width)
+ * are sent in one sync write. The order of the commands sent to a given id is kept.
+ */
+int TtlManager::writeSingleCommands(std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> > &&cmds)  // NOLINT
+{
+    // a group is either a command written alone, or several commands merged into one sync write
+    struct CmdGroup
+    {
+        EHardwareType hardware_type{EHardwareType::UNKNOWN};
+        int cmd_type{0};
+        bool mergeable{false};
+        std::vector<size_t> cmd_indexes;
+    };
+
+    int result = COMM_SUCCESS;
+    std::vector<CmdGroup> groups;
+    // index of the last group containing a command for a given id
+    std::map<uint8_t, size_t> last_group_map;
+
+    for (size_t i = 0; i < cmds.size(); ++i)
+    {
+        if (!cmds.at(i))
+            continue;
+
+        uint8_t id = cmds.at(i)->getId();
+
+        CmdGroup cmd_group;
+        cmd_group.cmd_type = cmds.at(i)->getCmdType();
+        cmd_group.cmd_indexes.emplace_back(i);
+        if (_state_map.count(id) && _state_map.at(id))
+        {
+            cmd_group.hardware_type = _state_map.at(id)->getHardwareType();
+            cmd_group.mergeable = _driver_map.count(cmd_group.hardware_type) && _driver_map.at(cmd_group.hardware_type) &&
+                                  _driver_map.at(cmd_group.hardware_type)->canSyncWriteCmd(cmds.at(i));
+        }
+
+        // merge with the last compatible group found after the previous command sent to this id
+        size_t first_group = last_group_map.count(id) ? last_group_map.at(id) + 1 : 0;
+        bool merged = false;
+        for (size_t g = groups.size(); cmd_group.mergeable && !merged && g > first_group; --g)
+        {
+            CmdGroup &group = groups.at(g - 1);
+            if (group.mergeable && group.hardware_type == cmd_group.hardware_type && group.cmd_type == cmd_group.cmd_type)
+            {
+                group.cmd_indexes.emplace_back(i);
+                last_group_map[id] = g - 1;
+                merged = true;
+            }
+        }
+
+        if (!merged)
+        {
+            groups.emplace_back(std::move(cmd_group));
+            last_group_map[id] = groups.size() - 1;
+        }
+    }
+
+    for (auto const &group : groups)
+    {
+        int group_result = COMM_TX_ERROR;
+
+        if (group.cmd_indexes.size() > 1)
+        {
+            std::vector<uint8_t> ids;
+            std::vector<uint32_t> params;
+            // all the params of each command, for the commands writing several registers
+            for (auto const index : group.cmd_indexes)
+            {
+                uint8_t id = cmds.at(index)->getId();
+                ids.emplace_back(id);
+                for (auto const param : cmds.at(index)->getParams())
+                    params.emplace_back(param);
+
+                // same as writeSingleCommand : the goal of the motor may change, its next trajectory goal is written
+                _goal_delta_filter.invalidate(id);
+            }
+
+            ROS_DEBUG("TtlManager::writeSingleCommands - %d commands of type %d merged into one sync write",
+                      static_cast<int>(ids.size()), group.cmd_type);
+            auto start = BusMetrics::Clock::now();
+            group_result = _driver_map.at(group.hardware_type)->writeSyncCmd(group.cmd_type, ids, params);
+            _bus_metrics.record(EBusTransaction::SINGLE_WRITE, group.hardware_type, toBusResult(group_result), start);
+
+            ROS_WARN_COND(COMM_SUCCESS != group_result,
+                          "TtlManager::writeSingleCommands - Failed to sync write merged commands (%d), write them one by one", group_result);
+        }
+
+        // not merged or sync write failed
+        if (COMM_SUCCESS != group_result)
+        {
+            for (auto const index : group.cmd_indexes)
+            {
+                int cmd_result = writeSingleCommand(std::move(cmds.at(index)));
+                if (COMM_SUCCESS != cmd_result)
+                    result = cmd_result;
+            }
+        }
+    }
+
+    return result;
+}
+
 /**
  * @brief TtlManager::executeJointTrajectoryCmd
  * @param cmd_vec
  */
-void TtlManager::executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, uint32_t>> cmd_vec)
+void TtlManager::executeJointTrajectoryCmd(const common::model::TtlJointTrajectoryCmd &cmd_vec)
 {
+    // only the goals not yet written to the motors, all of them if the suppression is disabled
+    const common::model::TtlJointTrajectoryCmd &goals = _goal_delta_filter.filter(cmd_vec, LoopTimer::now());
+    if (goals.empty())
+        return;
+
+    // a single bulk write for the motors of all drivers, no wait between drivers
+    if (_use_bulk_transactions && bulkWritePositionGoals(goals))
+    {
+        for (auto const &goal : goals)
+            _goal_delta_filter.setTransmitted(goal.first, goal.second);
+        return;
+    }
+
     for (auto const &it : _driver_map)
     {
         // build list of ids and params for this motor
         std::vector<uint8_t> ids;
         std::vector<uint32_t> params;
-        for (auto const &cmd : cmd_vec)
+        for (auto const &cmd : goals)
         {
             if (_state_map.count(cmd.first) && it.first == _state_map.at(cmd.first)->getHardwareType())
             {
@@ -1775,22 +2512,78 @@ void TtlManager::executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, uint32
             }
         }
 
+        // all the goals of this driver are already written
+        if (ids.empty() && _goal_delta_filter.isEnabled())
+            continue;
+
         // syncwrite for this driver. The driver is responsible for sync write only to its associated motors
         auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(it.second);
 
         if (driver)
         {
+            auto start = BusMetrics::Clock::now();
             int err = driver->syncWritePositionGoal(ids, params);
+            _bus_metrics.record(EBusTransaction::GOAL_WRITE, it.first, toBusResult(err), start);
+
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                if (COMM_SUCCESS == err)
+                    _goal_delta_filter.setTransmitted(ids.at(i), params.at(i));
+                else
+                    _goal_delta_filter.invalidate(ids.at(i));
+            }
+
             if (err != COMM_SUCCESS)
             {
                 ROS_WARN("TtlManager::executeJointTrajectoryCmd - Failed to write position");
                 _debug_error_message = "TtlManager - Failed to write position";
             }
         }
-        ros::Duration(0.001).sleep();
     }
 }
 
+/**
+ * @brief TtlManager::bulkWritePositionGoals : write the goal positions of the motors of all drivers in a single bulk write
+ * @param cmd_vec
+ * @return false if the bulk write failed, nothing is written then
+ */
+bool TtlManager::bulkWritePositionGoals(const common::model::TtlJointTrajectoryCmd &cmd_vec)
+{
+    if (!_bulk_write)
+        return false;
+
+    _bulk_write->clearParam();
+
+    for (auto const &cmd : cmd_vec)
+    {
+        if (!_state_map.count(cmd.first))
+            continue;
+
+        EHardwareType hw_type = _state_map.at(cmd.first)->getHardwareType();
+
+        std::shared_ptr<ttl_driver::AbstractMotorDriver> driver;
+        if (_driver_map.count(hw_type))
+            driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(_driver_map.at(hw_type));
+
+        if (driver && COMM_SUCCESS != driver->addPositionGoalToBulkWrite(*_bulk_write, cmd.first, cmd.second))
+        {
+            ROS_DEBUG("TtlManager::bulkWritePositionGoals - unable to add motor %d to bulk write", cmd.first);
+            _bulk_write->clearParam();
+            return false;
+        }
+    }
+
+    // no motor to write is not an error
+    auto start = BusMetrics::Clock::now();
+    int res = _bulk_write->txPacket();
+    _bulk_write->clearParam();
+
+    if (COMM_NOT_AVAILABLE != res)
+        _bus_metrics.record(EBusTransaction::GOAL_WRITE, EHardwareType::UNKNOWN, toBusResult(res), start);
+
+    return (COMM_SUCCESS == res || COMM_NOT_AVAILABLE == res);
+}
+
 // ******************
 //  Calibration
 // ******************
@@ -1877,10 +2670,52 @@ int32_t TtlManager::getCalibrationResult(uint8_t motor_id) const
 void TtlManager::getBusState(bool &connection_state, std::vector<uint8_t> &motor_id, std::string &debug_msg) const
 {
     debug_msg = _debug_error_message;
+
+    // serial settings of the port, to diagnose the timeouts
+    if (!debug_msg.empty() && _portHandler)
+    {
+        debug_msg += " (port low latency: " + std::string(_portHandler->isLowLatency() ? "on" : "off");
+        debug_msg += ", latency timer: " + std::to_string(_portHandler->getLatencyTimer()) + " ms)";
+    }
+
     motor_id = _all_ids_connected;
     connection_state = isConnectionOk();
 }
 
+/**
+ * @brief TtlManager::getBusMetrics
+ * @return durations and results of the transactions, busy fraction of the bus since the previous call,
+ * cycles needed by the sync commands, goals not written because unchanged
+ */
+niryo_robot_msgs::BusMetrics TtlManager::getBusMetrics()
+{
+    niryo_robot_msgs::BusMetrics msg = _bus_metrics.getMsg();
+    msg.last_sync_cmd_cycles = getLastSyncCmdCycles();
+    msg.max_sync_cmd_cycles = getMaxSyncCmdCycles();
+    msg.suppressed_goal_count = _goal_delta_filter.getSuppressedCount();
+    return msg;
+}
+
+/**
+ * @brief TtlManager::toBusResult
+ * @param comm_result : COMM_* result of the dynamixel sdk
+ * @return
+ */
+common::util::EBusResult TtlManager::toBusResult(int comm_result)
+{
+    switch (comm_result)
+    {
+        case COMM_SUCCESS:
+            return EBusResult::SUCCESS;
+        case COMM_RX_TIMEOUT:
+            return EBusResult::TIMEOUT;
+        case COMM_RX_CORRUPT:
+            return EBusResult::CORRUPT;
+        default:
+            return EBusResult::FAILURE;
+    }
+}
+
 /**
  * @brief TtlManager::getMotorsStates
  * @return only the joints states
@@ -1912,6 +2747,137 @@ std::shared_ptr<common::model::AbstractHardwareState> TtlManager::getHardwareSta
     return _state_map.at(motor_id);
 }
 
+/**
+ * @brief TtlManager::estimateTransactionCost : estimate the time taken on the bus by a transaction of the control loop
+ * @param transaction
+ * @return estimated duration in s, computed from the baudrate and the payload of the connected hardware
+ */
+double TtlManager::estimateTransactionCost(ETtlTransaction transaction) const
+{
+    double cost = 0.0;
+
+    // fake drivers do not use the bus
+    if (_simulation_mode)
+        return cost;
+
+    EHardwareType ee_type = EHardwareType::END_EFFECTOR;
+
+    // motors of all types addressed by the same bulk transaction
+    size_t nb_bulk_ids = 0;
+
+    for (auto const &it : _ids_map)
+    {
+        EHardwareType hw_type = it.first;
+        size_t nb_ids = it.second.size();
+
+        switch (transaction)
+        {
+        case ETtlTransaction::TRAJECTORY_WRITE:
+            // write of the 4 bytes goal position
+            if (isMotorType(hw_type) && _use_bulk_transactions)
+                nb_bulk_ids += nb_ids;
+            else if (isMotorType(hw_type))
+                cost += TtlTransactionScheduler::estimateSyncWriteCost(_bus_baudrate, nb_ids, 4);
+            break;
+        case ETtlTransaction::JOINTS_READ:
+            // read of position, velocity and load (10 bytes), plus collision status of the end effector
+            if (isMotorType(hw_type) && _use_bulk_transactions)
+                nb_bulk_ids += nb_ids;
+            else if (isMotorType(hw_type))
+                cost += TtlTransactionScheduler::estimateSyncReadCost(_bus_baudrate, nb_ids, 10);
+            else if (ee_type == hw_type)
+                cost += TtlTransactionScheduler::estimateReadCost(_bus_baudrate, 1);
+            break;
+        case ETtlTransaction::END_EFFECTOR_READ:
+            // buttons status (3 bytes) and digital input
+            if (ee_type == hw_type)
+                cost += TtlTransactionScheduler::estimateSyncReadCost(_bus_baudrate, 1, 3) + TtlTransactionScheduler::estimateReadCost(_bus_baudrate, 1);
+            break;
+        case ETtlTransaction::HW_STATUS_READ:
+            // voltage and temperature (3 bytes), then hardware error status
+            cost += TtlTransactionScheduler::estimateSyncReadCost(_bus_baudrate, nb_ids, 3) + TtlTransactionScheduler::estimateSyncReadCost(_bus_baudrate, nb_ids, 1);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (ETtlTransaction::TRAJECTORY_WRITE == transaction)
+        cost += TtlTransactionScheduler::estimateBulkWriteCost(_bus_baudrate, nb_bulk_ids, 4);
+    else if (ETtlTransaction::JOINTS_READ == transaction)
+        cost += TtlTransactionScheduler::estimateBulkReadCost(_bus_baudrate, nb_bulk_ids, 10);
+
+    // conveyors velocity is read with the hardware status
+    if (ETtlTransaction::HW_STATUS_READ == transaction)
+        cost += TtlTransactionScheduler::estimateSyncReadCost(_bus_baudrate, _conveyor_list.size(), 4);
+
+    return cost;
+}
+
+/**
+ * @brief TtlManager::measureTransactionCost : runs a transaction of the control loop several times in a row on the connected hardware
+ * @param transaction
+ * @param nb_samples
+ * @return 90th percentile of the durations of the successful runs in s, 0 if the transaction could not be run
+ * Goal writes are not sent as they could move the arm. They get no status packet, so their estimated cost is returned
+ */
+double TtlManager::measureTransactionCost(ETtlTransaction transaction, unsigned int nb_samples)
+{
+    if (_simulation_mode || 0 == nb_samples)
+        return 0.0;
+
+    if (ETtlTransaction::TRAJECTORY_WRITE == transaction)
+        return estimateTransactionCost(transaction);
+
+    vector<double> durations;
+    durations.reserve(nb_samples);
+
+    // the runs of the measurement must not count as failures of the control loop, nor disable the bulk transactions
+    const uint32_t hw_fail_counter_read = _hw_fail_counter_read;
+    const uint32_t end_effector_fail_counter_read = _end_effector_fail_counter_read;
+    const uint32_t bulk_fail_counter = _bulk_fail_counter;
+    const bool use_bulk_transactions = _use_bulk_transactions;
+    const std::string debug_error_message = _debug_error_message;
+
+    for (unsigned int i = 0; i < nb_samples; ++i)
+    {
+        auto start = BusMetrics::Clock::now();
+
+        bool success = false;
+        switch (transaction)
+        {
+        case ETtlTransaction::JOINTS_READ:
+            success = readJointsStatus();
+            break;
+        case ETtlTransaction::END_EFFECTOR_READ:
+            success = hasEndEffector() && readEndEffectorStatus();
+            break;
+        case ETtlTransaction::HW_STATUS_READ:
+            success = readHardwareStatus();
+            break;
+        default:
+            break;
+        }
+
+        if (success)
+            durations.emplace_back(std::chrono::duration<double>(BusMetrics::Clock::now() - start).count());
+    }
+
+    _hw_fail_counter_read = hw_fail_counter_read;
+    _end_effector_fail_counter_read = end_effector_fail_counter_read;
+    _bulk_fail_counter = bulk_fail_counter;
+    _use_bulk_transactions = use_bulk_transactions;
+    _debug_error_message = debug_error_message;
+
+    if (durations.empty())
+        return 0.0;
+
+    auto percentile = durations.begin() + static_cast<std::ptrdiff_t>((durations.size() * 9) / 10);
+    std::nth_element(durations.begin(), percentile, durations.end());
+
+    return *percentile;
+}
+
 // ********************
 //  Private
 // ********************
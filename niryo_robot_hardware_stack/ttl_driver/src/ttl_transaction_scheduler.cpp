@@ -0,0 +1,392 @@
+/*
+    ttl_transaction_scheduler.cpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_driver/ttl_transaction_scheduler.hpp"
+
+// c++
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ttl_driver
+{
+
+/**
+ * @brief TtlTransactionScheduler::setCyclePeriod
+ * @param period : period of the control loop, gives the bus budget of a cycle
+ */
+void TtlTransactionScheduler::setCyclePeriod(double period)
+{
+    _cycle_period = period;
+    _cycle_budget = period * BUS_BUDGET_RATIO;
+}
+
+/**
+ * @brief TtlTransactionScheduler::setPeriod
+ * @param transaction
+ * @param period
+ * The next deadline is moved to one new period after the last execution of the transaction
+ */
+void TtlTransactionScheduler::setPeriod(ETtlTransaction transaction, double period)
+{
+    Slot &s = slot(transaction);
+
+    s.deadline += period - s.period;
+    s.period = period;
+}
+
+/**
+ * @brief TtlTransactionScheduler::setEstimatedCost
+ * @param transaction
+ * @param cost : estimated duration of the transaction on the bus (in s)
+ */
+void TtlTransactionScheduler::setEstimatedCost(ETtlTransaction transaction, double cost)
+{
+    slot(transaction).estimated_cost = cost;
+}
+
+/**
+ * @brief TtlTransactionScheduler::setMeasuredCost : replaces the filtered cost of the transaction, refined afterwards by commit
+ * @param transaction
+ * @param cost : measured duration of the transaction on the bus (in s)
+ */
+void TtlTransactionScheduler::setMeasuredCost(ETtlTransaction transaction, double cost)
+{
+    slot(transaction).measured_cost = cost;
+}
+
+/**
+ * @brief TtlTransactionScheduler::setEnabled
+ * @param transaction
+ * @param enabled : a disabled transaction is never planned
+ */
+void TtlTransactionScheduler::setEnabled(ETtlTransaction transaction, bool enabled)
+{
+    slot(transaction).enabled = enabled;
+}
+
+/**
+ * @brief TtlTransactionScheduler::reset : every transaction will be due one period after now
+ * @param now
+ */
+void TtlTransactionScheduler::reset(double now)
+{
+    for (auto &s : _slots)
+    {
+        s.deadline = now + s.period;
+        s.deferred_cycles = 0;
+        s.planned = false;
+    }
+
+    _planned_occupancy = 0.0;
+    _has_deferred = false;
+}
+
+/**
+ * @brief TtlTransactionScheduler::planCycle : select the transactions to execute during the cycle starting at now
+ * @param now
+ * The most urgent due transaction is always planned. The next ones are planned by priority order only if they fit
+ * in the remaining budget of the cycle, or if they have already been deferred too many times
+ */
+void TtlTransactionScheduler::planCycle(double now)
+{
+    _planned_occupancy = 0.0;
+    _has_deferred = false;
+
+    bool has_planned = false;
+    double due_time = now + _cycle_period * DEADLINE_TOLERANCE_RATIO;
+
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        auto transaction = static_cast<ETtlTransaction>(i);
+        Slot &s = _slots.at(i);
+
+        s.planned = false;
+        if (!s.enabled || due_time < s.deadline)
+            continue;
+
+        double cost = getCost(transaction);
+        if (!has_planned || _planned_occupancy + cost <= _cycle_budget || s.deferred_cycles >= MAX_DEFERRED_CYCLES)
+        {
+            s.planned = true;
+            s.deferred_cycles = 0;
+            _planned_occupancy += cost;
+            has_planned = true;
+        }
+        else
+        {
+            s.deferred_cycles++;
+            s.deferred_count++;
+            _has_deferred = true;
+        }
+    }
+}
+
+/**
+ * @brief TtlTransactionScheduler::commit : to be called once a planned transaction has been executed
+ * @param transaction
+ * @param start_time
+ * @param end_time
+ */
+void TtlTransactionScheduler::commit(ETtlTransaction transaction, double start_time, double end_time)
+{
+    Slot &s = slot(transaction);
+
+    // next deadline is one period later. If we are late by more than one period, we do not try to catch up
+    s.deadline += s.period;
+    if (s.deadline < start_time)
+        s.deadline = start_time + s.period;
+
+    // refine cost with the measured duration
+    double cost = end_time - start_time;
+    if (s.measured_cost > 0.0)
+        s.measured_cost += COST_FILTER_GAIN * (cost - s.measured_cost);
+    else
+        s.measured_cost = cost;
+
+    s.planned = false;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getPeriods
+ * @return
+ */
+TtlTransactionScheduler::Periods TtlTransactionScheduler::getPeriods() const
+{
+    Periods periods{};
+    for (size_t i = 0; i < _slots.size(); ++i)
+        periods.at(i) = _slots.at(i).period;
+
+    return periods;
+}
+
+/**
+ * @brief TtlTransactionScheduler::getOccupancy : part of the bus budget used by the enabled transactions run at the given periods
+ * @param periods : a period shorter than the cycle period is run once per cycle
+ * @return 1.0 when the transactions use the whole budget, computed with the measured costs when available
+ */
+double TtlTransactionScheduler::getOccupancy(const Periods &periods) const
+{
+    if (_cycle_period <= 0.0)
+        return 0.0;
+
+    double busy_ratio = 0.0;
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        if (!_slots.at(i).enabled || periods.at(i) <= 0.0)
+            continue;
+
+        busy_ratio += getCost(static_cast<ETtlTransaction>(i)) / std::max(periods.at(i), _cycle_period);
+    }
+
+    return busy_ratio / BUS_BUDGET_RATIO;
+}
+
+/**
+ * @brief TtlTransactionScheduler::admitPeriods : admission control of a new set of periods
+ * @param periods : capped to the cycle period, scaled up if needed and allowed
+ * @param scale_down : if the bus budget is exceeded, slow down all the transactions by the same ratio instead of rejecting the periods
+ * @return true if the periods fit in the bus budget and can be applied
+ */
+bool TtlTransactionScheduler::admitPeriods(Periods &periods, bool scale_down) const
+{
+    for (auto &period : periods)
+    {
+        if (period > 0.0)
+            period = std::max(period, _cycle_period);
+    }
+
+    double occupancy = getOccupancy(periods);
+    if (occupancy <= 1.0)
+        return true;
+
+    if (!scale_down)
+        return false;
+
+    // the occupancy is linear in the frequencies, and no period is below the cycle period anymore
+    for (auto &period : periods)
+        period *= occupancy;
+
+    return true;
+}
+
+/**
+ * @brief TtlTransactionScheduler::planRates : selects the highest rates the bus can sustain with the current costs of the transactions
+ * @param plan : nominal rates, scaled by the same ratio (except the fixed ones) to use max_occupancy of the bus budget
+ * @param min_cycle_period : highest control loop frequency
+ * @param max_cycle_period : lowest control loop frequency
+ * @param max_occupancy : part of the bus budget given to the transactions, the rest is left to the queued commands
+ * @return false if the bus can not sustain the plan, even at the lowest control loop frequency
+ * The rates are also limited so that a joints read following a trajectory write fits in the budget of one cycle,
+ * the slower transactions are deferred to the next cycles if needed.
+ * Periods of the plan are never below its cycle period
+ */
+bool TtlTransactionScheduler::planRates(RatePlan &plan, double min_cycle_period, double max_cycle_period, double max_occupancy) const
+{
+    double fixed_occupancy = 0.0;
+    double scaled_occupancy = 0.0;
+    double cycle_cost = getCost(ETtlTransaction::TRAJECTORY_WRITE) + getCost(ETtlTransaction::JOINTS_READ);
+
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        if (!_slots.at(i).enabled || plan.periods.at(i) <= 0.0)
+            continue;
+
+        double cost = getCost(static_cast<ETtlTransaction>(i));
+        if (plan.fixed_periods.at(i))
+            fixed_occupancy += cost / plan.periods.at(i) / BUS_BUDGET_RATIO;
+        else
+            scaled_occupancy += cost / plan.periods.at(i) / BUS_BUDGET_RATIO;
+    }
+
+    // highest ratio applied to the nominal rates, limited by the occupancy of the bus
+    double scale = std::numeric_limits<double>::infinity();
+    if (scaled_occupancy > 0.0)
+        scale = std::max(max_occupancy - fixed_occupancy, 0.0) / scaled_occupancy;
+
+    double min_scale = 0.0;
+    if (!plan.fixed_cycle_period && plan.cycle_period > 0.0)
+    {
+        // limited by the budget of a cycle and the control loop frequency bounds
+        if (cycle_cost > 0.0)
+            scale = std::min(scale, plan.cycle_period * BUS_BUDGET_RATIO / cycle_cost);
+        if (min_cycle_period > 0.0)
+            scale = std::min(scale, plan.cycle_period / min_cycle_period);
+        if (max_cycle_period > 0.0)
+            min_scale = plan.cycle_period / max_cycle_period;
+    }
+
+    // nothing limits the rates
+    if (std::isinf(scale))
+        scale = 1.0;
+
+    bool sustainable = fixed_occupancy <= max_occupancy && scale > 0.0 && scale >= min_scale;
+
+    // not sustainable : slowest control loop, or nominal rates if the fixed ones already use the whole budget
+    if (scale < min_scale)
+        scale = min_scale;
+    if (scale <= 0.0)
+        scale = 1.0;
+
+    if (!plan.fixed_cycle_period)
+        plan.cycle_period /= scale;
+
+    for (size_t i = 0; i < plan.periods.size(); ++i)
+    {
+        if (plan.periods.at(i) <= 0.0)
+            continue;
+
+        if (!plan.fixed_periods.at(i))
+            plan.periods.at(i) /= scale;
+
+        plan.periods.at(i) = std::max(plan.periods.at(i), plan.cycle_period);
+    }
+
+    return sustainable;
+}
+
+/**
+ * @brief TtlTransactionScheduler::estimateReadCost : cost of a single read on one device
+ * @param baudrate
+ * @param data_length
+ * @return
+ */
+double TtlTransactionScheduler::estimateReadCost(int baudrate, size_t data_length)
+{
+    if (baudrate <= 0)
+        return 0.0;
+
+    // instruction : address (2) + length (2)
+    size_t nb_bytes = PACKET_OVERHEAD + 4 + STATUS_PACKET_OVERHEAD + data_length;
+
+    return static_cast<double>(nb_bytes) * BITS_PER_BYTE / baudrate + RESPONSE_DELAY;
+}
+
+/**
+ * @brief TtlTransactionScheduler::estimateSyncReadCost : cost of a sync read, each device answering with its own status packet
+ * @param baudrate
+ * @param nb_ids
+ * @param data_length
+ * @return
+ */
+double TtlTransactionScheduler::estimateSyncReadCost(int baudrate, size_t nb_ids, size_t data_length)
+{
+    if (baudrate <= 0 || 0 == nb_ids)
+        return 0.0;
+
+    // instruction : address (2) + length (2) + ids
+    size_t nb_bytes = PACKET_OVERHEAD + 4 + nb_ids + nb_ids * (STATUS_PACKET_OVERHEAD + data_length);
+
+    return static_cast<double>(nb_bytes) * BITS_PER_BYTE / baudrate + static_cast<double>(nb_ids) * RESPONSE_DELAY;
+}
+
+/**
+ * @brief TtlTransactionScheduler::estimateSyncWriteCost : cost of a sync write, no status packet is expected
+ * @param baudrate
+ * @param nb_ids
+ * @param data_length
+ * @return
+ */
+double TtlTransactionScheduler::estimateSyncWriteCost(int baudrate, size_t nb_ids, size_t data_length)
+{
+    if (baudrate <= 0 || 0 == nb_ids)
+        return 0.0;
+
+    // instruction : address (2) + length (2) + (id + data) for each id
+    size_t nb_bytes = PACKET_OVERHEAD + 4 + nb_ids * (1 + data_length);
+
+    return static_cast<double>(nb_bytes) * BITS_PER_BYTE / baudrate;
+}
+
+/**
+ * @brief TtlTransactionScheduler::estimateBulkReadCost : cost of a bulk read, each device answering with its own status packet
+ * @param baudrate
+ * @param nb_ids
+ * @param data_length : largest data length of the devices
+ * @return
+ */
+double TtlTransactionScheduler::estimateBulkReadCost(int baudrate, size_t nb_ids, size_t data_length)
+{
+    if (baudrate <= 0 || 0 == nb_ids)
+        return 0.0;
+
+    // instruction : (id + address (2) + length (2)) for each id
+    size_t nb_bytes = PACKET_OVERHEAD + nb_ids * 5 + nb_ids * (STATUS_PACKET_OVERHEAD + data_length);
+
+    return static_cast<double>(nb_bytes) * BITS_PER_BYTE / baudrate + static_cast<double>(nb_ids) * RESPONSE_DELAY;
+}
+
+/**
+ * @brief TtlTransactionScheduler::estimateBulkWriteCost : cost of a bulk write, no status packet is expected
+ * @param baudrate
+ * @param nb_ids
+ * @param data_length : largest data length of the devices
+ * @return
+ */
+double TtlTransactionScheduler::estimateBulkWriteCost(int baudrate, size_t nb_ids, size_t data_length)
+{
+    if (baudrate <= 0 || 0 == nb_ids)
+        return 0.0;
+
+    // instruction : (id + address (2) + length (2) + data) for each id
+    size_t nb_bytes = PACKET_OVERHEAD + nb_ids * (5 + data_length);
+
+    return static_cast<double>(nb_bytes) * BITS_PER_BYTE / baudrate;
+}
+
+}  // namespace ttl_driver
@@ -0,0 +1,327 @@
+/*
+    fake_dxl_port_handler.hpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef FAKE_DXL_PORT_HANDLER_HPP
+#define FAKE_DXL_PORT_HANDLER_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+namespace ttl_driver_test
+{
+
+/**
+ * @brief The FakeDxlPortHandler class : protocol 2.0 bus answering like real motors, without any serial port
+ * Handles read, write, sync read, fast sync read, bulk read and sync write on the registers of the motors of the bus
+ * The answers are queued when the instruction is written and never time out
+ * The writes are answered with the default status return level only (X series register)
+ * No byte stuffing : the registers must not contain the 0xFF 0xFF 0xFD sequence
+ */
+class FakeDxlPortHandler : public dynamixel::PortHandler
+{
+public:
+    FakeDxlPortHandler() { is_using_ = false; }
+
+    void addMotor(uint8_t id)
+    {
+        _present.at(id) = true;
+        _registers.at(id).at(ADDR_STATUS_RETURN_LEVEL) = STATUS_RETURN_ALL;
+    }
+
+    void setRegister(uint8_t id, uint16_t address, uint8_t length, uint32_t value);
+    uint32_t getRegister(uint8_t id, uint16_t address, uint8_t length) const;
+
+    // dynamixel::PortHandler interface
+    void gpioHigh() override {}
+    void gpioLow() override {}
+    bool openPort() override { return true; }
+    void closePort() override {}
+    void clearPort() override { _rx_size = _rx_pos = 0; }
+    void flushInput() override { clearPort(); }
+    void setPortName(const char *) override {}
+    const char *getPortName() override { return "fake"; }
+    bool setBaudRate(const int baudrate) override { _baudrate = baudrate; return true; }
+    int getBaudRate() override { return _baudrate; }
+    int getBytesAvailable() override { return static_cast<int>(_rx_size - _rx_pos); }
+    int readPort(uint8_t *packet, int length) override;
+    int writePort(uint8_t *packet, int length) override;
+    void setPacketTimeout(uint16_t) override {}
+    void setPacketTimeout(double) override {}
+    bool isPacketTimeout() override { return true; }
+
+private:
+    void beginStatus(uint8_t id);
+    void endStatus();
+    void pushStatusData(uint8_t id, uint16_t address, uint16_t length);
+    void pushByte(uint8_t byte) { _rx.at(_rx_size++) = byte; }
+
+    static uint16_t crc(const uint8_t *data, size_t size);
+
+private:
+    static constexpr uint16_t ADDR_STATUS_RETURN_LEVEL = 68;
+    static constexpr uint8_t STATUS_RETURN_ALL = 2;
+
+    std::array<std::array<uint8_t, 256>, 253> _registers{};
+    std::array<bool, 253> _present{};
+
+    // queued status packets
+    std::array<uint8_t, 2048> _rx{};
+    size_t _rx_size{0};
+    size_t _rx_pos{0};
+    size_t _status_start{0};
+
+    int _baudrate{1000000};
+};
+
+/**
+ * @brief FakeDxlPortHandler::setRegister
+ * @param id
+ * @param address
+ * @param length
+ * @param value : little endian in the registers
+ */
+inline
+void FakeDxlPortHandler::setRegister(uint8_t id, uint16_t address, uint8_t length, uint32_t value)
+{
+    for (uint8_t b = 0; b < length; ++b)
+        _registers.at(id).at(address + b) = static_cast<uint8_t>(value >> (8 * b));
+}
+
+/**
+ * @brief FakeDxlPortHandler::getRegister
+ * @param id
+ * @param address
+ * @param length
+ * @return
+ */
+inline
+uint32_t FakeDxlPortHandler::getRegister(uint8_t id, uint16_t address, uint8_t length) const
+{
+    uint32_t value = 0;
+    for (uint8_t b = 0; b < length; ++b)
+        value |= static_cast<uint32_t>(_registers.at(id).at(address + b)) << (8 * b);
+
+    return value;
+}
+
+/**
+ * @brief FakeDxlPortHandler::readPort
+ * @param packet
+ * @param length
+ * @return number of bytes read
+ */
+inline
+int FakeDxlPortHandler::readPort(uint8_t *packet, int length)
+{
+    int count = 0;
+    while (count < length && _rx_pos < _rx_size)
+        packet[count++] = _rx.at(_rx_pos++);
+
+    return count;
+}
+
+/**
+ * @brief FakeDxlPortHandler::writePort : decode an instruction packet and queue the answer of the motors
+ * @param packet
+ * @param length
+ * @return
+ */
+inline
+int FakeDxlPortHandler::writePort(uint8_t *packet, int length)
+{
+    // HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST PARAM... CRC_L CRC_H
+    if (length < 10)
+        return length;
+
+    uint8_t id = packet[4];
+    uint8_t instruction = packet[7];
+    uint8_t *param = packet + 8;
+    int param_length = length - 10;
+
+    switch (instruction)
+    {
+    case INST_READ:
+        if (id < _present.size() && _present.at(id))
+        {
+            beginStatus(id);
+            pushStatusData(id, DXL_MAKEWORD(param[0], param[1]), DXL_MAKEWORD(param[2], param[3]));
+            endStatus();
+        }
+        break;
+    case INST_WRITE:
+        if (id < _present.size() && _present.at(id))
+        {
+            uint16_t address = DXL_MAKEWORD(param[0], param[1]);
+            for (int i = 2; i < param_length; ++i)
+                _registers.at(id).at(address + i - 2) = param[i];
+
+            if (_registers.at(id).at(ADDR_STATUS_RETURN_LEVEL) >= STATUS_RETURN_ALL)
+            {
+                beginStatus(id);
+                endStatus();
+            }
+        }
+        break;
+    case INST_REBOOT:
+        if (id < _present.size() && _present.at(id))
+        {
+            if (_registers.at(id).at(ADDR_STATUS_RETURN_LEVEL) >= STATUS_RETURN_ALL)
+            {
+                beginStatus(id);
+                endStatus();
+            }
+            _registers.at(id).at(ADDR_STATUS_RETURN_LEVEL) = STATUS_RETURN_ALL;
+        }
+        break;
+    case INST_SYNC_READ:
+        for (int i = 4; i < param_length; ++i)
+        {
+            if (!_present.at(param[i]))
+                continue;
+
+            beginStatus(param[i]);
+            pushStatusData(param[i], DXL_MAKEWORD(param[0], param[1]), DXL_MAKEWORD(param[2], param[3]));
+            endStatus();
+        }
+        break;
+    case INST_FAST_SYNC_READ:
+    {
+        // a single status packet, each motor block ends with the CRC of the bytes sent so far
+        beginStatus(BROADCAST_ID);
+        for (int i = 4; i < param_length; ++i)
+        {
+            pushStatusData(param[i], DXL_MAKEWORD(param[0], param[1]), DXL_MAKEWORD(param[2], param[3]));
+            if (i + 1 < param_length)
+            {
+                uint16_t block_crc = crc(_rx.data() + _status_start, _rx_size - _status_start);
+                pushByte(DXL_LOBYTE(block_crc));
+                pushByte(DXL_HIBYTE(block_crc));
+                // next block : ERR(1) ID(1)
+                pushByte(0);
+                pushByte(param[i + 1]);
+            }
+        }
+        endStatus();
+    }
+        break;
+    case INST_BULK_READ:
+        // ID(1) ADDR(2) LEN(2) for each motor
+        for (int i = 0; i + 4 < param_length; i += 5)
+        {
+            if (!_present.at(param[i]))
+                continue;
+
+            beginStatus(param[i]);
+            pushStatusData(param[i], DXL_MAKEWORD(param[i + 1], param[i + 2]), DXL_MAKEWORD(param[i + 3], param[i + 4]));
+            endStatus();
+        }
+        break;
+    case INST_SYNC_WRITE:
+    {
+        uint16_t address = DXL_MAKEWORD(param[0], param[1]);
+        uint16_t data_length = DXL_MAKEWORD(param[2], param[3]);
+        for (int i = 4; i + data_length < param_length; i += data_length + 1)
+        {
+            for (uint16_t b = 0; b < data_length; ++b)
+                _registers.at(param[i]).at(address + b) = param[i + 1 + b];
+        }
+    }
+        break;
+    default:
+        break;
+    }
+
+    return length;
+}
+
+/**
+ * @brief FakeDxlPortHandler::beginStatus : status header, ERR and ID of the first block for a fast sync read
+ * @param id
+ */
+inline
+void FakeDxlPortHandler::beginStatus(uint8_t id)
+{
+    _status_start = _rx_size;
+
+    pushByte(0xFF);
+    pushByte(0xFF);
+    pushByte(0xFD);
+    pushByte(0x00);
+    pushByte(id);
+    // length, set by endStatus
+    pushByte(0);
+    pushByte(0);
+    pushByte(INST_STATUS);
+    pushByte(0);  // ERR
+}
+
+/**
+ * @brief FakeDxlPortHandler::pushStatusData : registers of a motor, preceded by its id for a fast sync read
+ * @param id
+ * @param address
+ * @param length
+ */
+inline
+void FakeDxlPortHandler::pushStatusData(uint8_t id, uint16_t address, uint16_t length)
+{
+    if (BROADCAST_ID == _rx.at(_status_start + 4) && _rx_size == _status_start + 9)
+        pushByte(id);
+
+    for (uint16_t b = 0; b < length; ++b)
+        pushByte(_registers.at(id).at(address + b));
+}
+
+/**
+ * @brief FakeDxlPortHandler::endStatus : length and CRC of the status packet
+ */
+inline
+void FakeDxlPortHandler::endStatus()
+{
+    // INST ... CRC_L CRC_H
+    size_t packet_length = _rx_size - _status_start - 7 + 2;
+    _rx.at(_status_start + 5) = DXL_LOBYTE(packet_length);
+    _rx.at(_status_start + 6) = DXL_HIBYTE(packet_length);
+
+    uint16_t packet_crc = crc(_rx.data() + _status_start, _rx_size - _status_start);
+    pushByte(DXL_LOBYTE(packet_crc));
+    pushByte(DXL_HIBYTE(packet_crc));
+}
+
+/**
+ * @brief FakeDxlPortHandler::crc : CRC-16 of the protocol 2.0 (polynomial 0x8005)
+ * @param data
+ * @param size
+ * @return
+ */
+inline
+uint16_t FakeDxlPortHandler::crc(const uint8_t *data, size_t size)
+{
+    uint16_t crc_accum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc_accum ^= static_cast<uint16_t>(data[i] << 8);
+        for (int bit = 0; bit < 8; ++bit)
+            crc_accum = (crc_accum & 0x8000) ? static_cast<uint16_t>((crc_accum << 1) ^ 0x8005) : static_cast<uint16_t>(crc_accum << 1);
+    }
+
+    return crc_accum;
+}
+
+}  // namespace ttl_driver_test
+
+#endif  // FAKE_DXL_PORT_HANDLER_HPP
@@ -243,6 +243,55 @@ TEST(TESTSuite, ReadVelocityProfile)
     EXPECT_DOUBLE_EQ(round(srv.response.v_stop), 20.0);
 }
 
+TEST(TESTSuite, GetFrequencies)
+{
+    auto client = nh->serviceClient<ttl_driver::GetFrequencies>("/niryo_robot/ttl_driver/get_frequencies");
+
+    bool exists(client.waitForExistence(ros::Duration(1)));
+    EXPECT_TRUE(exists);
+
+    ttl_driver::GetFrequencies srv;
+    client.call(srv);
+
+    EXPECT_EQ(srv.response.status, niryo_robot_msgs::CommandStatus::SUCCESS);
+    EXPECT_GT(srv.response.control_loop_frequency, 0.0);
+    EXPECT_GT(srv.response.read_data_frequency, 0.0);
+    EXPECT_LE(srv.response.read_data_frequency, srv.response.control_loop_frequency);
+    EXPECT_LE(srv.response.bus_occupancy, 1.0);
+}
+
+TEST(TESTSuite, SetFrequencies)
+{
+    auto client = nh->serviceClient<ttl_driver::SetFrequencies>("/niryo_robot/ttl_driver/set_frequencies");
+
+    bool exists(client.waitForExistence(ros::Duration(1)));
+    EXPECT_TRUE(exists);
+
+    // slower status read, other frequencies unchanged
+    ttl_driver::SetFrequencies srv;
+    srv.request.read_status_frequency = 1.0;
+    client.call(srv);
+
+    EXPECT_EQ(srv.response.status, niryo_robot_msgs::CommandStatus::SUCCESS);
+    EXPECT_DOUBLE_EQ(srv.response.read_status_frequency, 1.0);
+    EXPECT_GT(srv.response.read_data_frequency, 0.0);
+    EXPECT_LE(srv.response.bus_occupancy, 1.0);
+}
+
+TEST(TESTSuite, SetFrequenciesWrongParam)
+{
+    auto client = nh->serviceClient<ttl_driver::SetFrequencies>("/niryo_robot/ttl_driver/set_frequencies");
+
+    bool exists(client.waitForExistence(ros::Duration(1)));
+    EXPECT_TRUE(exists);
+
+    ttl_driver::SetFrequencies srv;
+    srv.request.read_data_frequency = -10.0;
+    client.call(srv);
+
+    EXPECT_EQ(srv.response.status, niryo_robot_msgs::CommandStatus::INVALID_PARAMETERS);
+}
+
 int main(int argc, char **argv)
 {
     ros::init(argc, argv, "ttl_driver_service_client");
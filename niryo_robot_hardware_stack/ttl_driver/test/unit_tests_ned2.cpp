@@ -26,17 +26,36 @@
 #include "common/model/stepper_motor_state.hpp"
 #include "common/model/synchronize_motor_cmd.hpp"
 #include "dynamixel_sdk/dynamixel_sdk.h"
+#include "dynamixel_sdk/port_handler_linux.h"
+#include "dynamixel_sdk/protocol2_packet_handler.h"
 #include "ros/node_handle.h"
+#include "ttl_driver/dxl_driver.hpp"
+#include "ttl_driver/mock_dxl_driver.hpp"
+#include "ttl_driver/stepper_driver.hpp"
+#include "ttl_driver/stepper_reg.hpp"
 #include "ttl_driver/ttl_interface_core.hpp"
 #include "ttl_driver/ttl_manager.hpp"
+#include "ttl_driver/ttl_transaction_scheduler.hpp"
+#include "ttl_driver/xl430_reg.hpp"
+
+#include "fake_dxl_port_handler.hpp"
 
 // Bring in gtest
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
 #include <gtest/gtest.h>
 #include <memory>
 #include <ros/console.h>
 #include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
 #include <utility>
+#include <vector>
 
 using ::common::model::BusProtocolEnum;
 using ::common::model::DxlMotorState;
@@ -47,6 +66,21 @@ using ::common::model::StepperMotorState;
 using ::std::string;
 using ::std::to_string;
 
+// heap allocations of the current thread, counted while a test measures them
+// malloc is interposed to count the packet buffers of the SDK as well as operator new
+static thread_local bool count_allocations = false;
+static thread_local size_t allocation_count = 0;
+
+extern "C" void *__libc_malloc(size_t size);
+
+extern "C" void *malloc(size_t size) noexcept
+{
+    if (count_allocations)
+        ++allocation_count;
+
+    return __libc_malloc(size);
+}
+
 /**
  * @brief addJointToTtlInterface
  * @param ttl_interface
@@ -735,6 +769,182 @@ TEST_F(TtlManagerTestSuite, testSyncCmds)
     EXPECT_NE(ttl_drv->writeSynchronizeCommand(std::move(dynamixel_cmd_4)), COMM_SUCCESS);
 }
 
+TEST_F(TtlManagerTestSuite, testNonBlockingSyncCmds)
+{
+    auto dynamixel_cmd = std::make_unique<common::model::DxlSyncCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE);
+    dynamixel_cmd->addMotorParam(state_motor_5->getHardwareType(), 5, 1);
+    dynamixel_cmd->addMotorParam(state_motor_6->getHardwareType(), 6, 1);
+
+    ASSERT_EQ(ttl_drv->startSynchronizeCommand(std::move(dynamixel_cmd)), COMM_SUCCESS);
+    EXPECT_TRUE(ttl_drv->hasPendingSynchronizeCommand());
+
+    // one call per cycle until all the drivers are written
+    int result = COMM_SUCCESS;
+    for (int cycle = 0; cycle < 100 && ttl_drv->hasPendingSynchronizeCommand(); ++cycle)
+    {
+        result = ttl_drv->processSynchronizeCommand();
+        ros::Duration(0.004).sleep();
+    }
+
+    EXPECT_EQ(result, COMM_SUCCESS);
+    EXPECT_FALSE(ttl_drv->hasPendingSynchronizeCommand());
+    EXPECT_GE(ttl_drv->getLastSyncCmdCycles(), 1u);
+    EXPECT_GE(ttl_drv->getMaxSyncCmdCycles(), ttl_drv->getLastSyncCmdCycles());
+
+    niryo_robot_msgs::BusMetrics bus_metrics = ttl_drv->getBusMetrics();
+    EXPECT_EQ(bus_metrics.last_sync_cmd_cycles, ttl_drv->getLastSyncCmdCycles());
+    EXPECT_EQ(bus_metrics.max_sync_cmd_cycles, ttl_drv->getMaxSyncCmdCycles());
+
+    // invalid cmd is not started
+    auto invalid_cmd = std::make_unique<common::model::DxlSyncCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE);
+    EXPECT_NE(ttl_drv->startSynchronizeCommand(std::move(invalid_cmd)), COMM_SUCCESS);
+    EXPECT_FALSE(ttl_drv->hasPendingSynchronizeCommand());
+}
+
+TEST_F(TtlManagerTestSuite, testMergedSingleCmds)
+{
+    // torque on for all motors, merged into one sync write per driver
+    std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> cmds;
+    for (uint8_t id = 2; id < 5; ++id)
+        cmds.emplace_back(std::make_unique<common::model::StepperTtlSingleCmd>(common::model::EStepperCommandType::CMD_TYPE_TORQUE, id, std::initializer_list<uint32_t>{1}));
+    for (uint8_t id = 5; id < 8; ++id)
+        cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE, id, std::initializer_list<uint32_t>{1}));
+
+    // same id twice : cannot be merged in the same sync write
+    cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE, 5, std::initializer_list<uint32_t>{1}));
+
+    // not mergeable, written alone
+    cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_STARTUP, 6, std::initializer_list<uint32_t>{1}));
+
+    // velocity and acceleration profiles, merged into one sync write of both registers
+    for (uint8_t id : {5, 6, 7})
+        cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_PROFILE, id, std::initializer_list<uint32_t>{200, 50}));
+
+    EXPECT_EQ(ttl_drv->writeSingleCommands(std::move(cmds)), COMM_SUCCESS);
+    ros::Duration(0.1).sleep();
+
+    // wrong id is reported
+    std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> wrong_cmds;
+    wrong_cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE, 5, std::initializer_list<uint32_t>{1}));
+    wrong_cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE, 20, std::initializer_list<uint32_t>{1}));
+
+    EXPECT_NE(ttl_drv->writeSingleCommands(std::move(wrong_cmds)), COMM_SUCCESS);
+}
+
+// Test the trajectory goals are written again after the commands changing the goal or the torque of the motors
+TEST_F(TtlManagerTestSuite, testGoalDeltaSuppressionReset)
+{
+    ros::NodeHandle nh("ttl_driver");
+    bool suppression_enabled{false};
+    double refresh_period{0.5};
+    nh.getParam("bus_params/goal_delta_suppression/enabled", suppression_enabled);
+    nh.getParam("bus_params/goal_delta_suppression/refresh_period", refresh_period);
+
+    // no refresh : only the commands make the goals written again
+    nh.setParam("bus_params/goal_delta_suppression/enabled", true);
+    nh.setParam("bus_params/goal_delta_suppression/refresh_period", 0.0);
+    auto filtered_drv = std::make_shared<ttl_driver::TtlManager>(nh);
+    nh.setParam("bus_params/goal_delta_suppression/enabled", suppression_enabled);
+    nh.setParam("bus_params/goal_delta_suppression/refresh_period", refresh_period);
+
+    addJointToTtlManager(filtered_drv);
+    ASSERT_TRUE(filtered_drv->readJointsStatus());
+
+    auto state = std::dynamic_pointer_cast<common::model::JointState>(filtered_drv->getHardwareState(5));
+    ASSERT_TRUE(state);
+
+    // present position, the motor does not move
+    common::model::TtlJointTrajectoryCmd goal;
+    EXPECT_TRUE(goal.push_back(std::make_pair(state->getId(), static_cast<uint32_t>(state->getPosition()))));
+
+    auto suppressed_count = [&filtered_drv]() { return filtered_drv->getBusMetrics().suppressed_goal_count; };
+
+    filtered_drv->executeJointTrajectoryCmd(goal);
+    filtered_drv->executeJointTrajectoryCmd(goal);
+    EXPECT_EQ(suppressed_count(), 1u);
+
+    // non blocking sync command, as sent by the interface core
+    auto sync_cmd = std::make_unique<common::model::DxlSyncCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE);
+    sync_cmd->addMotorParam(state->getHardwareType(), state->getId(), 1);
+    ASSERT_EQ(filtered_drv->startSynchronizeCommand(std::move(sync_cmd)), COMM_SUCCESS);
+    for (int cycle = 0; cycle < 100 && filtered_drv->hasPendingSynchronizeCommand(); ++cycle)
+    {
+        filtered_drv->processSynchronizeCommand();
+        ros::Duration(0.004).sleep();
+    }
+    EXPECT_FALSE(filtered_drv->hasPendingSynchronizeCommand());
+
+    filtered_drv->executeJointTrajectoryCmd(goal);
+    EXPECT_EQ(suppressed_count(), 1u);
+    filtered_drv->executeJointTrajectoryCmd(goal);
+    EXPECT_EQ(suppressed_count(), 2u);
+
+    // single commands merged into one sync write
+    std::vector<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> cmds;
+    for (uint8_t id : {5, 6})
+        cmds.emplace_back(std::make_unique<common::model::DxlSingleCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE, id, std::initializer_list<uint32_t>{1}));
+    EXPECT_EQ(filtered_drv->writeSingleCommands(std::move(cmds)), COMM_SUCCESS);
+
+    filtered_drv->executeJointTrajectoryCmd(goal);
+    EXPECT_EQ(suppressed_count(), 2u);
+}
+
+TEST_F(TtlManagerTestSuite, testJointStatesSnapshot)
+{
+    uint64_t last_cycle = ttl_drv->getJointStatesSnapshot().cycle;
+
+    ttl_drv->readJointsStatus();
+
+    // one cycle per read, all the joints are in the snapshot with their position, velocity and load of this cycle
+    auto const &snapshot = ttl_drv->getJointStatesSnapshot();
+    EXPECT_EQ(snapshot.cycle, last_cycle + 1);
+    for (auto const &jState : ttl_drv->getMotorsStates())
+    {
+        if (jState && common::model::EComponentType::JOINT == jState->getComponentType())
+        {
+            auto sample = snapshot.find(jState->getId());
+            ASSERT_NE(sample, nullptr);
+            EXPECT_EQ(sample->position, jState->getPosition());
+            EXPECT_EQ(sample->velocity, jState->getVelocity());
+            EXPECT_EQ(sample->load, jState->getTorque());
+            EXPECT_LE(sample->stamp, snapshot.stamp);
+        }
+    }
+}
+
+// Test joints read and written with bulk transactions when the motors handle them, with sync transactions otherwise
+TEST_F(TtlManagerTestSuite, testBulkTransactions)
+{
+    bool bulk_enabled = ttl_drv->isBulkTransactionsEnabled();
+
+    ASSERT_TRUE(ttl_drv->readJointsStatus());
+    EXPECT_EQ(ttl_drv->isBulkTransactionsEnabled(), bulk_enabled);
+
+    // write the present positions back, motors do not move
+    common::model::TtlJointTrajectoryCmd cmd;
+    std::map<uint8_t, int> positions;
+    for (auto const &jState : ttl_drv->getMotorsStates())
+    {
+        if (jState && common::model::EComponentType::JOINT == jState->getComponentType())
+        {
+            EXPECT_TRUE(cmd.push_back(std::make_pair(jState->getId(), static_cast<uint32_t>(jState->getPosition()))));
+            positions[jState->getId()] = jState->getPosition();
+        }
+    }
+
+    ttl_drv->executeJointTrajectoryCmd(cmd);
+    ros::Duration(0.1).sleep();
+
+    ASSERT_TRUE(ttl_drv->readJointsStatus());
+    for (auto const &jState : ttl_drv->getMotorsStates())
+    {
+        if (jState && positions.count(jState->getId()))
+        {
+            EXPECT_NEAR(jState->getPosition(), positions.at(jState->getId()), 2);
+        }
+    }
+}
+
 TEST_F(TtlManagerTestSuite, testSyncControlCmds)
 {
     // sync cmd
@@ -844,6 +1054,731 @@ TEST_F(TtlManagerTestSuite, testSyncControlCmdsReturnHome)
 // Test driver scan motors
 TEST_F(TtlManagerTestSuite, scanTest) { EXPECT_EQ(ttl_drv->scanAndCheck(), COMM_SUCCESS); }
 
+// Test transaction scheduler defers low priority transactions when bus budget is spent
+TEST(TtlTransactionSchedulerTestSuite, deferLowPriorityTransactions)
+{
+    ttl_driver::TtlTransactionScheduler scheduler;
+    scheduler.setCyclePeriod(0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::JOINTS_READ, 0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.01);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.003);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.004);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.001);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.005);
+    scheduler.reset(0.0);
+
+    // status read does not fit in the budget of the first cycle
+    scheduler.planCycle(0.01);
+    EXPECT_TRUE(scheduler.isPlanned(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE));
+    EXPECT_TRUE(scheduler.isPlanned(ttl_driver::ETtlTransaction::JOINTS_READ));
+    EXPECT_TRUE(scheduler.isPlanned(ttl_driver::ETtlTransaction::END_EFFECTOR_READ));
+    EXPECT_FALSE(scheduler.isPlanned(ttl_driver::ETtlTransaction::HW_STATUS_READ));
+    EXPECT_EQ(scheduler.getDeferredCount(ttl_driver::ETtlTransaction::HW_STATUS_READ), 1u);
+
+    scheduler.commit(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.01, 0.013);
+    scheduler.commit(ttl_driver::ETtlTransaction::JOINTS_READ, 0.013, 0.017);
+    scheduler.commit(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.017, 0.018);
+
+    // it is executed in the next cycle
+    scheduler.planCycle(0.015);
+    EXPECT_FALSE(scheduler.isPlanned(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE));
+    EXPECT_TRUE(scheduler.isPlanned(ttl_driver::ETtlTransaction::HW_STATUS_READ));
+}
+
+// Test admission control of new transactions periods
+TEST(TtlTransactionSchedulerTestSuite, admitPeriods)
+{
+    ttl_driver::TtlTransactionScheduler scheduler;
+    scheduler.setCyclePeriod(0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::JOINTS_READ, 0.01);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.1);
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::HW_STATUS_READ, 1.0);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.001);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.002);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.005);
+    scheduler.setEstimatedCost(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.005);
+    scheduler.reset(0.0);
+
+    // 0.1 + 0.2 + 0.05 + 0.005 of the bus, budget is 0.8 of the bus
+    EXPECT_NEAR(scheduler.getOccupancy(scheduler.getPeriods()), 0.355 / 0.8, 1e-9);
+
+    // faster status read : still fits
+    ttl_driver::TtlTransactionScheduler::Periods periods = scheduler.getPeriods();
+    periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::HW_STATUS_READ)) = 0.05;
+    EXPECT_TRUE(scheduler.admitPeriods(periods, false));
+
+    // joints read faster than the loop is capped to the loop, the end effector read does not fit anymore
+    periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::JOINTS_READ)) = 0.001;
+    periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::END_EFFECTOR_READ)) = 0.01;
+    ttl_driver::TtlTransactionScheduler::Periods rejected = periods;
+    EXPECT_FALSE(scheduler.admitPeriods(rejected, false));
+    EXPECT_DOUBLE_EQ(rejected.at(static_cast<size_t>(ttl_driver::ETtlTransaction::JOINTS_READ)), 0.01);
+
+    // scaled down to the whole budget
+    EXPECT_TRUE(scheduler.admitPeriods(periods, true));
+    EXPECT_NEAR(scheduler.getOccupancy(periods), 1.0, 1e-9);
+    EXPECT_GT(periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE)), 0.01);
+
+    // a disabled transaction uses no bus time
+    scheduler.setEnabled(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, false);
+    EXPECT_LT(scheduler.getOccupancy(periods), 1.0);
+
+    // a new period is counted from the last execution
+    scheduler.setPeriod(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.05);
+    scheduler.planCycle(0.05);
+    EXPECT_TRUE(scheduler.isPlanned(ttl_driver::ETtlTransaction::HW_STATUS_READ));
+    EXPECT_DOUBLE_EQ(scheduler.getFrequency(ttl_driver::ETtlTransaction::HW_STATUS_READ), 20.0);
+}
+
+// Test selection of the highest rates sustainable by the bus
+TEST(TtlTransactionSchedulerTestSuite, planRates)
+{
+    ttl_driver::TtlTransactionScheduler scheduler;
+    scheduler.setCyclePeriod(1.0 / 240.0);
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::TRAJECTORY_WRITE, 0.0005);
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.002);
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::END_EFFECTOR_READ, 0.001);
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.01);
+
+    ttl_driver::TtlTransactionScheduler::RatePlan nominal;
+    nominal.cycle_period = 1.0 / 240.0;
+    nominal.periods = {1.0 / 120.0, 1.0 / 120.0, 1.0 / 13.0, 1.0 / 0.7};
+
+    // the budget of a cycle holds the write and the joints read : 0.8 / 0.0025 = 320 Hz
+    ttl_driver::TtlTransactionScheduler::RatePlan plan = nominal;
+    EXPECT_TRUE(scheduler.planRates(plan, 1.0 / 400.0, 1.0 / 60.0, 0.9));
+    EXPECT_NEAR(1.0 / plan.cycle_period, 320.0, 1e-6);
+    EXPECT_NEAR(plan.periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::JOINTS_READ)), 2 * plan.cycle_period, 1e-12);
+    EXPECT_LE(scheduler.getOccupancy(plan.periods), 0.9);
+
+    // a slower joints read lowers the rates
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.0045);
+    plan = nominal;
+    EXPECT_TRUE(scheduler.planRates(plan, 1.0 / 400.0, 1.0 / 60.0, 0.9));
+    EXPECT_NEAR(1.0 / plan.cycle_period, 160.0, 1e-6);
+
+    // an overridden fast status read is kept, the other rates are limited by the occupancy of the bus
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.002);
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::HW_STATUS_READ, 0.002);
+    plan = nominal;
+    plan.periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::HW_STATUS_READ)) = 0.005;
+    plan.fixed_periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::HW_STATUS_READ)) = true;
+    EXPECT_TRUE(scheduler.planRates(plan, 1.0 / 400.0, 1.0 / 60.0, 0.9));
+    EXPECT_NEAR(scheduler.getOccupancy(plan.periods), 0.9, 1e-9);
+    EXPECT_DOUBLE_EQ(plan.periods.at(static_cast<size_t>(ttl_driver::ETtlTransaction::HW_STATUS_READ)), 0.005);
+
+    // not sustainable even at the lowest control loop frequency
+    scheduler.setMeasuredCost(ttl_driver::ETtlTransaction::JOINTS_READ, 0.05);
+    plan = nominal;
+    EXPECT_FALSE(scheduler.planRates(plan, 1.0 / 400.0, 1.0 / 60.0, 0.9));
+    EXPECT_NEAR(1.0 / plan.cycle_period, 60.0, 1e-6);
+}
+
+// Test a bulk read of all the motors takes about the bus time of one sync read per motor type
+// (address and length of each motor against one instruction packet less), in a single round trip
+TEST(TtlTransactionSchedulerTestSuite, bulkTransactionsCost)
+{
+    double sync_read_cost = 2 * ttl_driver::TtlTransactionScheduler::estimateSyncReadCost(1000000, 3, 10);
+    double bulk_read_cost = ttl_driver::TtlTransactionScheduler::estimateBulkReadCost(1000000, 6, 10);
+    EXPECT_GT(bulk_read_cost, 0.0);
+    EXPECT_LT(bulk_read_cost, 1.1 * sync_read_cost);
+
+    // a bulk write is a bit longer than the sync writes (address and length of each motor), but has no wait between drivers
+    EXPECT_GT(ttl_driver::TtlTransactionScheduler::estimateBulkWriteCost(1000000, 6, 4), 0.0);
+    EXPECT_EQ(ttl_driver::TtlTransactionScheduler::estimateBulkReadCost(1000000, 0, 10), 0.0);
+}
+
+// fast sync read is only used when the firmware of all the motors of the sync read supports it
+TEST(TtlDriverTestSuite, fastSyncReadAvailability)
+{
+    ttl_driver::MockDxlDriver driver(std::make_shared<ttl_driver::FakeTtlData>());
+
+    EXPECT_FALSE(driver.isFastSyncReadAvailable({}));
+    EXPECT_FALSE(driver.isFastSyncReadAvailable({5, 6}));
+
+    driver.setFastSyncReadAvailable(5, true);
+    driver.setFastSyncReadAvailable(6, true);
+    EXPECT_TRUE(driver.isFastSyncReadAvailable({5, 6}));
+    EXPECT_FALSE(driver.isFastSyncReadAvailable({5, 6, 7}));
+
+    driver.setFastSyncReadAvailable(6, false);
+    EXPECT_TRUE(driver.isFastSyncReadAvailable({5}));
+    EXPECT_FALSE(driver.isFastSyncReadAvailable({5, 6}));
+}
+
+// steady state polling : the group transactions prepared by the first cycle are reused without any allocation
+TEST(TtlDriverTestSuite, syncTransactionsWithoutAllocation)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    // the packet handler is a singleton
+    std::shared_ptr<dynamixel::PacketHandler> packet_handler(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+    ttl_driver::DxlDriver<ttl_driver::XL430Reg> driver(port, packet_handler);
+
+    const std::vector<uint8_t> ids{2, 3, 4};
+    for (auto const id : ids)
+    {
+        port->addMotor(id);
+        port->setRegister(id, ttl_driver::XL430Reg::ADDR_FIRMWARE_VERSION, 1, 46);
+        port->setRegister(id, ttl_driver::XL430Reg::ADDR_PRESENT_POSITION, 4, 2000 + id);
+        port->setRegister(id, ttl_driver::XL430Reg::ADDR_PRESENT_VELOCITY, 4, 10 + id);
+        port->setRegister(id, ttl_driver::XL430Reg::ADDR_PRESENT_LOAD, 2, 100 + id);
+    }
+
+    std::vector<uint32_t> goals{1500, 1600, 1700};
+    ttl_driver::JointStatusList joint_status;
+
+    auto poll = [&]()
+    {
+        // first cycle
+        ASSERT_EQ(driver.syncReadJointStatus(ids, joint_status), COMM_SUCCESS);
+        ASSERT_EQ(driver.syncWritePositionGoal(ids, goals), COMM_SUCCESS);
+
+        int failures = 0;
+        allocation_count = 0;
+        count_allocations = true;
+        for (uint32_t cycle = 0; cycle < 100; ++cycle)
+        {
+            goals.at(0) = 1500 + cycle;
+            if (COMM_SUCCESS != driver.syncReadJointStatus(ids, joint_status))
+                failures++;
+            if (COMM_SUCCESS != driver.syncWritePositionGoal(ids, goals))
+                failures++;
+        }
+        count_allocations = false;
+
+        EXPECT_EQ(failures, 0);
+        EXPECT_EQ(allocation_count, 0u);
+
+        ASSERT_EQ(joint_status.size(), ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            EXPECT_EQ(joint_status.at(i).at(0), 2000u + ids.at(i));
+            EXPECT_EQ(joint_status.at(i).at(1), 10u + ids.at(i));
+            EXPECT_EQ(joint_status.at(i).at(2), 100u + ids.at(i));
+        }
+
+        EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_GOAL_POSITION, 4), 1599u);
+        EXPECT_EQ(port->getRegister(3, ttl_driver::XL430Reg::ADDR_GOAL_POSITION, 4), 1600u);
+        EXPECT_EQ(port->getRegister(4, ttl_driver::XL430Reg::ADDR_GOAL_POSITION, 4), 1700u);
+    };
+
+    // classic sync read
+    EXPECT_FALSE(driver.isFastSyncReadAvailable(ids));
+    poll();
+
+    // fast sync read, once the firmware versions are known
+    std::string version;
+    for (auto const id : ids)
+    {
+        EXPECT_EQ(driver.readFirmwareVersion(id, version), COMM_SUCCESS);
+    }
+    EXPECT_TRUE(driver.isFastSyncReadAvailable(ids));
+    poll();
+}
+
+// micro benchmark of the packet handler : allocations and duration of each kind of transaction
+TEST(TtlDriverTestSuite, packetHandlerWithoutAllocation)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    dynamixel::PacketHandler *packet_handler = dynamixel::PacketHandler::getPacketHandler(2.0);
+    port->addMotor(2);
+    port->addMotor(3);
+
+    const uint16_t position_address = ttl_driver::XL430Reg::ADDR_PRESENT_POSITION;
+    const uint16_t goal_address = ttl_driver::XL430Reg::ADDR_GOAL_POSITION;
+
+    uint8_t ids[2] = {2, 3};
+    uint8_t bulk_read_params[10] = {2, DXL_LOBYTE(position_address), DXL_HIBYTE(position_address), 4, 0,
+                                    3, DXL_LOBYTE(position_address), DXL_HIBYTE(position_address), 4, 0};
+    uint8_t sync_write_params[10] = {2, 0xDC, 0x05, 0, 0, 3, 0x40, 0x06, 0, 0};
+    uint8_t data[16] = {};
+    uint32_t value = 0;
+
+    std::vector<std::pair<std::string, std::function<int()> > > transactions{
+        {"read", [&]() { return packet_handler->read4ByteTxRx(port.get(), 2, position_address, &value); }},
+        {"write", [&]() { return packet_handler->write4ByteTxRx(port.get(), 2, goal_address, 1500); }},
+        {"sync read", [&]()
+         {
+             int result = packet_handler->syncReadTx(port.get(), position_address, 4, ids, 2);
+             for (auto const id : ids)
+             {
+                 if (COMM_SUCCESS == result)
+                     result = packet_handler->readRx(port.get(), id, 4, data);
+             }
+             return result;
+         }},
+        {"fast sync read", [&]()
+         {
+             int result = packet_handler->fastSyncReadTx(port.get(), position_address, 4, ids, 2);
+             if (COMM_SUCCESS == result)
+                 result = packet_handler->fastSyncReadRx(port.get(), 2 * (4 + 4) - 2, data);
+             return result;
+         }},
+        {"bulk read", [&]()
+         {
+             int result = packet_handler->bulkReadTx(port.get(), bulk_read_params, 10);
+             for (auto const id : ids)
+             {
+                 if (COMM_SUCCESS == result)
+                     result = packet_handler->readRx(port.get(), id, 4, data);
+             }
+             return result;
+         }},
+        {"sync write", [&]() { return packet_handler->syncWriteTxOnly(port.get(), goal_address, 4, sync_write_params, 10); }}};
+
+    constexpr int nb_transactions = 1000;
+    for (auto const &transaction : transactions)
+    {
+        int failures = 0;
+        allocation_count = 0;
+        count_allocations = true;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nb_transactions; ++i)
+        {
+            if (COMM_SUCCESS != transaction.second())
+                failures++;
+        }
+        auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        count_allocations = false;
+
+        ROS_INFO("%s : %.2f allocations, %.2f us per transaction", transaction.first.c_str(),
+                 static_cast<double>(allocation_count) / nb_transactions, duration / nb_transactions);
+
+        EXPECT_EQ(failures, 0) << transaction.first;
+        EXPECT_EQ(allocation_count, 0u) << transaction.first;
+    }
+
+    EXPECT_EQ(port->getRegister(3, goal_address, 4), 1600u);
+}
+
+TEST(TtlDriverTestSuite, crcAndStuffingKernels)
+{
+    dynamixel::Protocol2PacketHandler *packet_handler = dynamixel::Protocol2PacketHandler::getInstance();
+
+    std::array<uint8_t, 1024> data{};
+    uint32_t seed = 12345;
+    for (auto &byte : data)
+    {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(seed >> 16);
+    }
+
+    // slice-by-8 CRC against the byte per byte reference, for every size and for a CRC continued from a previous block
+    for (uint16_t size = 0; size <= data.size(); ++size)
+    {
+        EXPECT_EQ(packet_handler->updateCRC(0, data.data(), size), packet_handler->updateCRCReference(0, data.data(), size)) << size;
+        EXPECT_EQ(packet_handler->updateCRC(0xA5C3, data.data(), size), packet_handler->updateCRCReference(0xA5C3, data.data(), size)) << size;
+    }
+
+    // FF FF FD sequences in the parameters are followed by a stuffed 0xFD, removed on reception
+    std::array<uint8_t, 32> packet{0xFF, 0xFF, 0xFD, 0x00, 1, 11, 0, INST_WRITE, 0x01, 0xFF, 0xFF, 0xFD, 0x02, 0xFF, 0xFF, 0xFD, 0xAA, 0xBB};
+    std::array<uint8_t, 32> stuffed_packet = packet;
+    std::array<uint8_t, 10> stuffed_params{0x01, 0xFF, 0xFF, 0xFD, 0xFD, 0x02, 0xFF, 0xFF, 0xFD, 0xFD};
+
+    packet_handler->addStuffing(stuffed_packet.data());
+    EXPECT_EQ(DXL_MAKEWORD(stuffed_packet.at(5), stuffed_packet.at(6)), 13);
+    EXPECT_TRUE(std::equal(stuffed_params.begin(), stuffed_params.end(), stuffed_packet.begin() + 8));
+
+    // the CRC follows the stuffed data on the bus
+    stuffed_packet.at(18) = 0xAA;
+    stuffed_packet.at(19) = 0xBB;
+    packet_handler->removeStuffing(stuffed_packet.data());
+    EXPECT_TRUE(std::equal(packet.begin(), packet.begin() + 18, stuffed_packet.begin()));
+
+    // comparison on a sync write of 4 motors and on a firmware block of a full packet
+    constexpr int nb_iterations = 10000;
+    for (uint16_t size : {34, 1024})
+    {
+        uint32_t reference_crc_sum = 0;
+        uint32_t crc_sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nb_iterations; ++i)
+            reference_crc_sum += packet_handler->updateCRCReference(0, data.data(), size);
+        auto reference_duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nb_iterations; ++i)
+            crc_sum += packet_handler->updateCRC(0, data.data(), size);
+        auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        // packet without any sequence to stuff, as for almost every packet
+        std::array<uint8_t, 1024 + 16> stuffing_packet{0xFF, 0xFF, 0xFD, 0x00, 1, DXL_LOBYTE(size + 3), DXL_HIBYTE(size + 3), INST_WRITE};
+        std::copy(data.begin(), data.begin() + size, stuffing_packet.begin() + 8);
+        std::replace(stuffing_packet.begin() + 8, stuffing_packet.end(), 0xFD, 0xFC);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nb_iterations; ++i)
+        {
+            packet_handler->addStuffing(stuffing_packet.data());
+            packet_handler->removeStuffing(stuffing_packet.data());
+        }
+        auto stuffing_duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        ROS_INFO("%d bytes : crc reference %.1f ns, crc slice-by-8 %.1f ns, stuffing %.1f ns", size,
+                 reference_duration / nb_iterations, duration / nb_iterations, stuffing_duration / nb_iterations);
+
+        EXPECT_EQ(crc_sum, reference_crc_sum);
+        EXPECT_EQ(DXL_MAKEWORD(stuffing_packet.at(5), stuffing_packet.at(6)), size + 3);
+    }
+}
+
+// writes without status once the status return level is lowered, reads still answered
+TEST(TtlDriverTestSuite, busPerformanceProfile)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    // the packet handler is a singleton
+    std::shared_ptr<dynamixel::PacketHandler> packet_handler(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+    ttl_driver::DxlDriver<ttl_driver::XL430Reg> driver(port, packet_handler);
+
+    port->addMotor(2);
+    port->setRegister(2, ttl_driver::XL430Reg::ADDR_RETURN_DELAY_TIME, 1, 250);
+    port->setRegister(2, ttl_driver::XL430Reg::ADDR_PRESENT_POSITION, 4, 2048);
+
+    uint32_t return_delay_us = 0;
+    EXPECT_EQ(driver.writeReturnDelayTime(2, 0), COMM_SUCCESS);
+    EXPECT_EQ(driver.readReturnDelayTime(2, return_delay_us), COMM_SUCCESS);
+    EXPECT_EQ(return_delay_us, 0u);
+
+    EXPECT_FALSE(driver.isTxOnlyWrite(2));
+    EXPECT_EQ(driver.writeStatusReturnLevel(2, ttl_driver::AbstractTtlDriver::STATUS_RETURN_PING_READ), COMM_SUCCESS);
+    EXPECT_TRUE(driver.isTxOnlyWrite(2));
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_STATUS_RETURN_LEVEL, 1), 1u);
+
+    // the write is not answered, nothing is left on the bus for the next transaction
+    EXPECT_EQ(driver.writePositionGoal(2, 1234), COMM_SUCCESS);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_GOAL_POSITION, 4), 1234u);
+    EXPECT_EQ(port->getBytesAvailable(), 0);
+
+    uint32_t position = 0;
+    EXPECT_EQ(driver.readPosition(2, position), COMM_SUCCESS);
+    EXPECT_EQ(position, 2048u);
+
+    // the reboot is answered, and restores the default level
+    EXPECT_EQ(driver.reboot(2), COMM_SUCCESS);
+    EXPECT_FALSE(driver.isTxOnlyWrite(2));
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_STATUS_RETURN_LEVEL, 1), 2u);
+    EXPECT_EQ(driver.writePositionGoal(2, 1500), COMM_SUCCESS);
+
+    // a reboot sent at a lower level is not answered, but the device restarts at the default level
+    port->setRegister(2, ttl_driver::XL430Reg::ADDR_STATUS_RETURN_LEVEL, 1, ttl_driver::AbstractTtlDriver::STATUS_RETURN_PING_READ);
+    EXPECT_EQ(driver.reboot(2), COMM_RX_TIMEOUT);
+    EXPECT_FALSE(driver.isTxOnlyWrite(2));
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_STATUS_RETURN_LEVEL, 1), 2u);
+    EXPECT_EQ(driver.writePositionGoal(2, 1600), COMM_SUCCESS);
+}
+
+TEST(TtlDriverTestSuite, baudRateRegisters)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    // the packet handler is a singleton
+    std::shared_ptr<dynamixel::PacketHandler> packet_handler(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+    ttl_driver::DxlDriver<ttl_driver::XL430Reg> driver(port, packet_handler);
+    ttl_driver::DxlDriver<ttl_driver::XL320Reg> xl320_driver(port, packet_handler);
+
+    port->addMotor(2);
+    port->setRegister(2, ttl_driver::XL430Reg::ADDR_BAUDRATE, 1, 3);
+
+    EXPECT_TRUE(driver.isBaudRateSupported(4000000));
+    EXPECT_FALSE(driver.isBaudRateSupported(5000000));
+    EXPECT_FALSE(xl320_driver.isBaudRateSupported(2000000));
+    EXPECT_TRUE(xl320_driver.isBaudRateSupported(ttl_driver::AbstractTtlDriver::DEFAULT_BAUDRATE));
+
+    // the baud rate is in EEPROM, the torque is read before it is written
+    port->setRegister(2, ttl_driver::XL430Reg::ADDR_TORQUE_ENABLE, 1, 1);
+    uint8_t torque_enable{0};
+    EXPECT_EQ(driver.readTorqueEnable(2, torque_enable), COMM_SUCCESS);
+    EXPECT_EQ(torque_enable, 1);
+
+    EXPECT_EQ(driver.writeBaudRate(2, 4000000), COMM_SUCCESS);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_BAUDRATE, 1), 6u);
+
+    // an unsupported baud rate is not written
+    EXPECT_EQ(driver.writeBaudRate(2, 250000), COMM_NOT_AVAILABLE);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_BAUDRATE, 1), 6u);
+}
+
+TEST(TtlDriverTestSuite, syncWriteVelocityProfile)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    // the packet handler is a singleton
+    std::shared_ptr<dynamixel::PacketHandler> packet_handler(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+    ttl_driver::DxlDriver<ttl_driver::XL430Reg> driver(port, packet_handler);
+
+    port->addMotor(2);
+    port->addMotor(3);
+
+    // [velocity, acceleration] of each motor, written in one packet
+    EXPECT_EQ(driver.writeSyncCmd(static_cast<int>(common::model::EDxlCommandType::CMD_TYPE_PROFILE), {2, 3}, {200, 50, 300, 60}), COMM_SUCCESS);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_PROFILE_VELOCITY, 4), 200u);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_PROFILE_ACCELERATION, 4), 50u);
+    EXPECT_EQ(port->getRegister(3, ttl_driver::XL430Reg::ADDR_PROFILE_VELOCITY, 4), 300u);
+    EXPECT_EQ(port->getRegister(3, ttl_driver::XL430Reg::ADDR_PROFILE_ACCELERATION, 4), 60u);
+
+    // a missing param is not written
+    EXPECT_NE(driver.writeSyncCmd(static_cast<int>(common::model::EDxlCommandType::CMD_TYPE_PROFILE), {2, 3}, {100, 10, 100}), COMM_SUCCESS);
+    EXPECT_EQ(port->getRegister(2, ttl_driver::XL430Reg::ADDR_PROFILE_VELOCITY, 4), 200u);
+}
+
+// the velocity of a stepper is only measured with the torque enabled
+TEST(TtlDriverTestSuite, stepperJointStatusTorqueOff)
+{
+    auto port = std::make_shared<ttl_driver_test::FakeDxlPortHandler>();
+    // the packet handler is a singleton
+    std::shared_ptr<dynamixel::PacketHandler> packet_handler(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+    ttl_driver::StepperDriver<ttl_driver::StepperReg> driver(port, packet_handler);
+
+    port->addMotor(2);
+    port->addMotor(3);
+    for (uint8_t id : {2, 3})
+    {
+        port->setRegister(id, ttl_driver::StepperReg::ADDR_PRESENT_POSITION, 4, 1000u + id);
+        port->setRegister(id, ttl_driver::StepperReg::ADDR_PRESENT_VELOCITY, 4, 40u + id);
+    }
+
+    // torque not known yet : the velocity is given
+    ttl_driver::JointStatusList status_list;
+    ASSERT_EQ(driver.syncReadJointStatus({2, 3}, status_list), COMM_SUCCESS);
+    ASSERT_EQ(status_list.size(), 2u);
+    EXPECT_EQ(status_list.at(0).at(0), 1002u);
+    EXPECT_EQ(status_list.at(0).at(1), 42u);
+
+    EXPECT_EQ(driver.syncWriteTorqueEnable({2, 3}, {0, 1}), COMM_SUCCESS);
+    ASSERT_EQ(driver.syncReadJointStatus({2, 3}, status_list), COMM_SUCCESS);
+    EXPECT_EQ(status_list.at(0).at(0), 1002u);
+    EXPECT_EQ(status_list.at(0).at(1), 0u);
+    EXPECT_EQ(status_list.at(1).at(1), 43u);
+
+    // same in a bulk read
+    dynamixel::GroupBulkRead bulk_read(port.get(), packet_handler.get());
+    ASSERT_EQ(driver.addJointStatusToBulkRead(bulk_read, 2), COMM_SUCCESS);
+    ASSERT_EQ(bulk_read.txRxPacket(), COMM_SUCCESS);
+    std::array<uint32_t, 3> status{};
+    ASSERT_EQ(driver.getJointStatusFromBulkRead(bulk_read, 2, status), COMM_SUCCESS);
+    EXPECT_EQ(status.at(0), 1002u);
+    EXPECT_EQ(status.at(1), 0u);
+
+    // torque enabled again
+    EXPECT_EQ(driver.writeTorqueEnable(2, 1), COMM_SUCCESS);
+    ASSERT_EQ(driver.syncReadJointStatus({2, 3}, status_list), COMM_SUCCESS);
+    EXPECT_EQ(status_list.at(0).at(1), 42u);
+
+    // a reboot disables the torque
+    EXPECT_EQ(driver.reboot(3), COMM_SUCCESS);
+    ASSERT_EQ(driver.syncReadJointStatus({2, 3}, status_list), COMM_SUCCESS);
+    EXPECT_EQ(status_list.at(1).at(1), 0u);
+}
+
+// port handler reading the status packets by polling the port, as before readPortBlocking
+// it keeps the fixed packet timeout too : spinning on the port delays the thread of the pseudo motor
+// far beyond the latency it would learn
+class PollingPortHandlerLinux : public dynamixel::PortHandlerLinux
+{
+public:
+    explicit PollingPortHandlerLinux(const char *port_name) : dynamixel::PortHandlerLinux(port_name) {}
+
+    int readPortBlocking(uint8_t *packet, int length) override { return readPort(packet, length); }
+    void setDevicePacketTimeout(uint16_t packet_length, const uint8_t *, int) override { setPacketTimeout(packet_length); }
+};
+
+TEST(TtlDriverTestSuite, ptyLoopbackReceive)
+{
+    // the slave side of a pseudo terminal is the port of the packet handler, a motor answers on the master side
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master_fd, 0);
+    ASSERT_EQ(grantpt(master_fd), 0);
+    ASSERT_EQ(unlockpt(master_fd), 0);
+    std::string slave_name = ptsname(master_fd);
+
+    // keeps the slave side open between the port handlers
+    int slave_fd = open(slave_name.c_str(), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave_fd, 0);
+
+    dynamixel::Protocol2PacketHandler *packet_handler = dynamixel::Protocol2PacketHandler::getInstance();
+
+    // status of a 4 bytes read on motor 2
+    uint8_t status[15] = {0xFF, 0xFF, 0xFD, 0x00, 2, 8, 0, INST_STATUS, 0, 0xDC, 0x05, 0x00, 0x00};
+    uint16_t status_crc = packet_handler->updateCRC(0, status, 13);
+    status[13] = DXL_LOBYTE(status_crc);
+    status[14] = DXL_HIBYTE(status_crc);
+
+    // answers each instruction after the return delay of the motor and the transmission of the status
+    std::thread motor([master_fd, &status]()
+    {
+        uint8_t instruction[64];
+        ssize_t length = 0;
+        while ((length = read(master_fd, instruction, sizeof(instruction))) > 0)
+        {
+            timespec answer_delay = {0, 500000};
+            nanosleep(&answer_delay, nullptr);
+            if (write(master_fd, status, sizeof(status)) != static_cast<ssize_t>(sizeof(status)))
+                break;
+        }
+    });
+
+    std::vector<std::pair<std::string, std::shared_ptr<dynamixel::PortHandlerLinux> > > port_handlers{
+        {"polling", std::make_shared<PollingPortHandlerLinux>(slave_name.c_str())},
+        {"epoll", std::make_shared<dynamixel::PortHandlerLinux>(slave_name.c_str())}};
+
+    constexpr int nb_transactions = 200;
+    std::vector<double> cpu_durations;
+    for (auto const &port_handler : port_handlers)
+    {
+        ASSERT_TRUE(port_handler.second->openPort());
+        ASSERT_TRUE(port_handler.second->setBaudRate(1000000));
+
+        int failures = 0;
+        uint32_t value = 0;
+        timespec cpu_start{};
+        timespec cpu_end{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nb_transactions; ++i)
+        {
+            if (COMM_SUCCESS != packet_handler->read4ByteTxRx(port_handler.second.get(), 2, ttl_driver::XL430Reg::ADDR_PRESENT_POSITION, &value))
+                failures++;
+        }
+        auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+        double cpu_duration = (cpu_end.tv_sec - cpu_start.tv_sec) * 1e6 + (cpu_end.tv_nsec - cpu_start.tv_nsec) / 1e3;
+        cpu_durations.push_back(cpu_duration);
+
+        port_handler.second->closePort();
+
+        ROS_INFO("%s : %.1f us per status packet, %.0f %% cpu", port_handler.first.c_str(), duration / nb_transactions, 100.0 * cpu_duration / duration);
+
+        EXPECT_EQ(failures, 0) << port_handler.first;
+        EXPECT_EQ(value, 1500u) << port_handler.first;
+    }
+
+    // the polling port handler spins during the return delay of each status
+    EXPECT_LT(cpu_durations.at(1), cpu_durations.at(0));
+
+    // the motor stops when the slave side is closed
+    close(slave_fd);
+    motor.join();
+    close(master_fd);
+}
+
+TEST(TtlDriverTestSuite, ptyLoopbackAdaptiveTimeout)
+{
+    // motor 2 answers on the master side of a pseudo terminal, motor 3 is missing
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master_fd, 0);
+    ASSERT_EQ(grantpt(master_fd), 0);
+    ASSERT_EQ(unlockpt(master_fd), 0);
+    std::string slave_name = ptsname(master_fd);
+
+    dynamixel::Protocol2PacketHandler *packet_handler = dynamixel::Protocol2PacketHandler::getInstance();
+
+    // status of a 4 bytes read on motor 2
+    uint8_t status[15] = {0xFF, 0xFF, 0xFD, 0x00, 2, 8, 0, INST_STATUS, 0, 0xDC, 0x05, 0x00, 0x00};
+    uint16_t status_crc = packet_handler->updateCRC(0, status, 13);
+    status[13] = DXL_LOBYTE(status_crc);
+    status[14] = DXL_HIBYTE(status_crc);
+
+    // answers the reads of motor 2 and the sync reads after its return delay time
+    std::thread motor([master_fd, &status]()
+    {
+        uint8_t instruction[64];
+        ssize_t length = 0;
+        while ((length = read(master_fd, instruction, sizeof(instruction))) > 0)
+        {
+            if (length < 8 || (instruction[4] != 2 && instruction[7] != INST_SYNC_READ))
+                continue;
+
+            timespec return_delay = {0, 200000};
+            nanosleep(&return_delay, nullptr);
+            if (write(master_fd, status, sizeof(status)) != static_cast<ssize_t>(sizeof(status)))
+                break;
+        }
+    });
+
+    auto port_handler = std::make_shared<dynamixel::PortHandlerLinux>(slave_name.c_str());
+    ASSERT_TRUE(port_handler->openPort());
+    ASSERT_TRUE(port_handler->setBaudRate(1000000));
+    port_handler->setReturnDelayTime(2, 200);
+
+    const uint16_t position_address = ttl_driver::XL430Reg::ADDR_PRESENT_POSITION;
+    uint32_t value = 0;
+    uint8_t data[4] = {};
+    uint8_t ids[2] = {2, 3};
+
+    auto duration_ms = [](const std::function<void()> &transaction)
+    {
+        auto start = std::chrono::steady_clock::now();
+        transaction();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // nothing learned yet : LATENCY_TIMER for the missing motor
+    double missing_read_before_ms = duration_ms([&]()
+    {
+        EXPECT_EQ(packet_handler->read4ByteTxRx(port_handler.get(), 3, position_address, &value), COMM_RX_TIMEOUT);
+    });
+
+    // the latency learned on motor 2 gives the timeout of both motors, without any timeout for motor 2
+    int failures = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        if (COMM_SUCCESS != packet_handler->read4ByteTxRx(port_handler.get(), 2, position_address, &value))
+            failures++;
+    }
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(value, 1500u);
+
+    double missing_read_after_ms = duration_ms([&]()
+    {
+        EXPECT_EQ(packet_handler->read4ByteTxRx(port_handler.get(), 3, position_address, &value), COMM_RX_TIMEOUT);
+    });
+    double missing_sync_read_after_ms = duration_ms([&]()
+    {
+        EXPECT_EQ(packet_handler->syncReadTx(port_handler.get(), position_address, 4, ids, 2), COMM_SUCCESS);
+        EXPECT_EQ(packet_handler->readRx(port_handler.get(), 2, 4, data), COMM_SUCCESS);
+        EXPECT_EQ(packet_handler->readRx(port_handler.get(), 3, 4, data), COMM_RX_TIMEOUT);
+    });
+
+    ROS_INFO("missing motor : read %.2f ms before learning, read %.2f ms and sync read %.2f ms after learning",
+             missing_read_before_ms, missing_read_after_ms, missing_sync_read_after_ms);
+
+    EXPECT_LT(missing_read_after_ms, missing_read_before_ms / 2);
+    EXPECT_LT(missing_sync_read_after_ms, missing_read_before_ms / 2);
+
+    port_handler->closePort();
+    motor.join();
+    close(master_fd);
+}
+
+TEST(TtlDriverTestSuite, ptyLowLatencySettings)
+{
+    // a pseudo terminal is not an USB serial adapter : its settings are left untouched
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master_fd, 0);
+    ASSERT_EQ(grantpt(master_fd), 0);
+    ASSERT_EQ(unlockpt(master_fd), 0);
+    std::string slave_name = ptsname(master_fd);
+
+    auto port_handler = std::make_shared<dynamixel::PortHandlerLinux>(slave_name.c_str());
+    ASSERT_TRUE(port_handler->openPort());
+    ASSERT_TRUE(port_handler->setBaudRate(1000000));
+
+    EXPECT_FALSE(port_handler->isLowLatency());
+    EXPECT_EQ(port_handler->getLatencyTimer(), -1);
+
+    // the timeout then keeps the latency timer assumed for an unknown adapter
+    auto start = std::chrono::steady_clock::now();
+    port_handler->setPacketTimeout(static_cast<uint16_t>(0));
+    while (!port_handler->isPacketTimeout())
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    std::chrono::duration<double, std::milli> timeout = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(timeout.count(), 12.0);
+
+    port_handler->closePort();
+    close(master_fd);
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv)
 {